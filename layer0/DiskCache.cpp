@@ -0,0 +1,392 @@
+/*
+ * Content-addressed cache of binary blobs on disk.
+ */
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "DiskCache.h"
+#include "File.h"
+#include "FileStream.h"
+
+namespace pymol
+{
+
+static const char cCacheMagic[8] = {'P', 'y', 'M', 'O', 'L', 'c', 'c', '1'};
+static const char* cCacheSuffix = ".pmc";
+static const char* cCacheTmpSuffix = ".tmp";
+
+// temporary files older than this (in seconds) are from crashed writers
+static const std::time_t cCacheTmpMaxAge = 3600;
+
+namespace
+{
+struct cache_file_info {
+  std::string path;
+  std::size_t size;
+  std::time_t mtime;
+  bool tmp; // temporary file of put()
+};
+} // namespace
+
+static bool ends_with(const std::string& name, const char* suffix)
+{
+  const auto suffix_len = strlen(suffix);
+  return name.size() > suffix_len &&
+         name.compare(name.size() - suffix_len, suffix_len, suffix) == 0;
+}
+
+/*
+ * All cache files and temporary files in `dir`, with size and modification
+ * time
+ */
+static std::vector<cache_file_info> cache_list_files(const std::string& dir)
+{
+  std::vector<cache_file_info> files;
+
+  auto is_cache_file = [&](const std::string& name) {
+    return ends_with(name, cCacheSuffix) || ends_with(name, cCacheTmpSuffix);
+  };
+
+#ifdef _WIN32
+  WIN32_FIND_DATAW data;
+  HANDLE handle = FindFirstFileW(utf8_to_utf16(dir + "\\*").c_str(), &data);
+  if (handle == INVALID_HANDLE_VALUE)
+    return files;
+  do {
+    char name[MAX_PATH * 4];
+    if (!WideCharToMultiByte(CP_UTF8, 0, data.cFileName, -1, name,
+            sizeof(name), nullptr, nullptr) ||
+        !is_cache_file(name))
+      continue;
+    ULARGE_INTEGER mtime;
+    mtime.LowPart = data.ftLastWriteTime.dwLowDateTime;
+    mtime.HighPart = data.ftLastWriteTime.dwHighDateTime;
+    // FILETIME counts from 1601
+    files.push_back({dir + "\\" + name,
+        (std::size_t(data.nFileSizeHigh) << 32) | data.nFileSizeLow,
+        std::time_t(mtime.QuadPart / 10000000ULL - 11644473600ULL),
+        ends_with(name, cCacheTmpSuffix)});
+  } while (FindNextFileW(handle, &data));
+  FindClose(handle);
+#else
+  DIR* dp = opendir(dir.c_str());
+  if (!dp)
+    return files;
+  while (auto entry = readdir(dp)) {
+    std::string name = entry->d_name;
+    if (!is_cache_file(name))
+      continue;
+    std::string path = dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      files.push_back({path, std::size_t(st.st_size), st.st_mtime,
+          ends_with(name, cCacheTmpSuffix)});
+    }
+  }
+  closedir(dp);
+#endif
+
+  return files;
+}
+
+static void cache_mkdir(const std::string& dir)
+{
+#ifdef _WIN32
+  _wmkdir(utf8_to_utf16(dir).c_str());
+#else
+  mkdir(dir.c_str(), 0777);
+#endif
+}
+
+static void cache_touch(const std::string& path)
+{
+#ifdef _WIN32
+  _wutime(utf8_to_utf16(path).c_str(), nullptr);
+#else
+  utime(path.c_str(), nullptr);
+#endif
+}
+
+static bool cache_rename(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+  return MoveFileExW(utf8_to_utf16(from).c_str(), utf8_to_utf16(to).c_str(),
+      MOVEFILE_REPLACE_EXISTING);
+#else
+  return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+static unsigned long cache_process_id()
+{
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif
+}
+
+static void cache_remove(const std::string& path)
+{
+#ifdef _WIN32
+  _wremove(utf8_to_utf16(path).c_str());
+#else
+  std::remove(path.c_str());
+#endif
+}
+
+DiskCache::DiskCache(std::string dir, std::size_t max_bytes)
+    : m_dir(std::move(dir))
+    , m_max_bytes(max_bytes)
+{
+  while (m_dir.size() > 1 && (m_dir.back() == '/' || m_dir.back() == '\\')) {
+    m_dir.pop_back();
+  }
+}
+
+std::uint64_t DiskCache::hash(const void* data, std::size_t len)
+{
+  auto p = static_cast<const unsigned char*>(data);
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i != len; ++i) {
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+std::string DiskCache::path(const std::string& key) const
+{
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx",
+      (unsigned long long) hash(key.data(), key.size()));
+  return m_dir + name + cCacheSuffix;
+}
+
+/*
+ * Size of the cache file for `key` and `value`
+ */
+static std::size_t cache_file_size(
+    const std::string& key, const std::string& value)
+{
+  return sizeof(cCacheMagic) + sizeof(std::uint64_t) + key.size() +
+         value.size();
+}
+
+void DiskCache::setMaxBytes(std::size_t max_bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_max_bytes = max_bytes;
+}
+
+/*
+ * List the directory once: entries in the order of their modification times
+ * (least recent first), and removal of stale temporary files.
+ * Caller must hold m_mutex.
+ */
+void DiskCache::scan()
+{
+  if (m_scanned)
+    return;
+
+  m_scanned = true;
+
+  auto files = cache_list_files(m_dir);
+  auto now = std::time(nullptr);
+
+  std::sort(files.begin(), files.end(),
+      [](const cache_file_info& a, const cache_file_info& b) {
+        return a.mtime < b.mtime;
+      });
+
+  for (auto& file : files) {
+    if (file.tmp) {
+      if (now - file.mtime > cCacheTmpMaxAge)
+        cache_remove(file.path);
+      continue;
+    }
+    // entries which are already known are more recent
+    if (m_entries.count(file.path))
+      continue;
+    m_entries[file.path] = {file.size, ++m_clock};
+    m_total += file.size;
+  }
+}
+
+/*
+ * Record `filename` with `size` bytes as the most recently used entry.
+ * Caller must hold m_mutex.
+ */
+void DiskCache::use(const std::string& filename, std::size_t size)
+{
+  auto& entry = m_entries[filename];
+  m_total -= entry.size;
+  m_total += size;
+  entry.size = size;
+  entry.last_use = ++m_clock;
+}
+
+/*
+ * File layout: magic, key length (uint64), key, value
+ */
+bool DiskCache::get(const std::string& key, std::string& value)
+{
+  auto filename = path(key);
+  FILE* fp = pymol_fopen(filename.c_str(), "rb");
+  if (!fp)
+    return false;
+
+  bool ok = false;
+  char magic[sizeof(cCacheMagic)];
+  std::uint64_t key_len = 0;
+
+  if (fread(magic, sizeof(magic), 1, fp) == 1 &&
+      memcmp(magic, cCacheMagic, sizeof(magic)) == 0 &&
+      fread(&key_len, sizeof(key_len), 1, fp) == 1 &&
+      key_len == key.size()) {
+    std::string stored_key(key.size(), '\0');
+    if (key.empty() || fread(&stored_key[0], key.size(), 1, fp) == 1) {
+      if (stored_key == key) {
+        long start = ftell(fp);
+        fseek(fp, 0, SEEK_END);
+        long end = ftell(fp);
+        fseek(fp, start, SEEK_SET);
+        if (start >= 0 && end >= start) {
+          value.resize(end - start);
+          ok = value.empty() || fread(&value[0], value.size(), 1, fp) == 1;
+        }
+      }
+    }
+  }
+
+  fclose(fp);
+
+  if (ok) {
+    // modification time: recency for the next session
+    cache_touch(filename);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    scan();
+    use(filename, cache_file_size(key, value));
+  }
+
+  return ok;
+}
+
+bool DiskCache::put(const std::string& key, const std::string& value)
+{
+  static std::atomic<unsigned> s_counter{0};
+
+  if (m_dir.empty())
+    return false;
+
+  cache_mkdir(m_dir);
+
+  auto filename = path(key);
+
+  // unique across processes and threads
+  char suffix[64];
+  snprintf(suffix, sizeof(suffix), ".%lx.%zx.%x%s",
+      (unsigned long) cache_process_id(),
+      std::hash<std::thread::id>()(std::this_thread::get_id()),
+      s_counter.fetch_add(1), cCacheTmpSuffix);
+  auto tmpname = filename + suffix;
+
+  FILE* fp = pymol_fopen(tmpname.c_str(), "wb");
+  if (!fp)
+    return false;
+
+  std::uint64_t key_len = key.size();
+  bool ok = fwrite(cCacheMagic, sizeof(cCacheMagic), 1, fp) == 1 &&
+            fwrite(&key_len, sizeof(key_len), 1, fp) == 1 &&
+            (key.empty() || fwrite(key.data(), key.size(), 1, fp) == 1) &&
+            (value.empty() || fwrite(value.data(), value.size(), 1, fp) == 1);
+  ok = (fclose(fp) == 0) && ok;
+
+  if (ok) {
+    ok = cache_rename(tmpname, filename);
+  }
+
+  if (!ok) {
+    cache_remove(tmpname);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  scan();
+  use(filename, cache_file_size(key, value));
+
+  if (m_max_bytes) {
+    evict(filename);
+  }
+
+  return true;
+}
+
+/*
+ * Remove least recently used entries until the cache fits its size limit,
+ * except for `keep` (the entry just written).
+ * Caller must hold m_mutex.
+ */
+void DiskCache::evict(const std::string& keep)
+{
+  if (m_total <= m_max_bytes)
+    return;
+
+  std::vector<std::pair<std::uint64_t, std::string>> order;
+  order.reserve(m_entries.size());
+  for (auto& item : m_entries) {
+    if (item.first != keep)
+      order.emplace_back(item.second.last_use, item.first);
+  }
+
+  std::sort(order.begin(), order.end());
+
+  for (auto& item : order) {
+    if (m_total <= m_max_bytes)
+      break;
+    auto it = m_entries.find(item.second);
+    cache_remove(it->first);
+    m_total -= it->second.size;
+    m_entries.erase(it);
+  }
+}
+
+void DiskCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto& file : cache_list_files(m_dir)) {
+    if (!file.tmp)
+      cache_remove(file.path);
+  }
+  m_entries.clear();
+  m_total = 0;
+  m_scanned = true;
+}
+
+std::size_t DiskCache::size()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  scan();
+  return m_total;
+}
+
+} // namespace pymol
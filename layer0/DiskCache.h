@@ -0,0 +1,97 @@
+/*
+ * Content-addressed cache of binary blobs on disk.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pymol
+{
+
+/**
+ * Directory of cache files, each holding one key/value pair. Files are named
+ * after a hash of the key and store the full key as well, so hash collisions
+ * are detected and treated as misses. Entries persist across sessions and
+ * may be shared by concurrent processes: files are written to a temporary
+ * name and renamed into place.
+ *
+ * The total size of the directory is bounded by evicting the least recently
+ * used entries whenever put() exceeds the limit. The directory is listed
+ * once (initial recency by file modification time), after that sizes and
+ * recency are tracked in memory, so keep one instance per directory.
+ * Entries written by other processes in the meantime are only accounted for
+ * once this instance reads them. Temporary files left behind by crashed
+ * writers are removed with the first listing.
+ *
+ * All methods are thread-safe.
+ */
+class DiskCache
+{
+public:
+  /**
+   * @param dir cache directory, created on first put()
+   * @param max_bytes size limit for all entries (0 = unlimited)
+   */
+  DiskCache(std::string dir, std::size_t max_bytes);
+
+  /**
+   * Look up `key`
+   * @param[out] value cached value
+   * @return false if not cached (or unreadable)
+   */
+  bool get(const std::string& key, std::string& value);
+
+  /**
+   * Store `value` for `key`, replacing any previous value, and evict old
+   * entries if the cache exceeds its size limit.
+   * @return false if the entry could not be written
+   */
+  bool put(const std::string& key, const std::string& value);
+
+  /**
+   * Remove all entries
+   */
+  void clear();
+
+  /**
+   * Total size of all entries in bytes
+   */
+  std::size_t size();
+
+  /**
+   * Change the size limit, takes effect with the next put()
+   */
+  void setMaxBytes(std::size_t max_bytes);
+
+  /**
+   * 64-bit FNV-1a hash
+   */
+  static std::uint64_t hash(const void* data, std::size_t len);
+
+private:
+  struct Entry {
+    std::size_t size;
+    std::uint64_t last_use;
+  };
+
+  std::string path(const std::string& key) const;
+  void scan();
+  void use(const std::string& filename, std::size_t size);
+  void evict(const std::string& keep);
+
+  std::string m_dir;
+  std::size_t m_max_bytes;
+
+  std::mutex m_mutex; // protects the members below
+  bool m_scanned = false;
+  std::unordered_map<std::string, Entry> m_entries; // by file path
+  std::size_t m_total = 0;
+  std::uint64_t m_clock = 0; // recency counter
+};
+
+} // namespace pymol
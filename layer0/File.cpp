@@ -7,6 +7,11 @@
 #ifdef _WIN32
 #include <vector>
 #include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include <stdio.h>
@@ -93,6 +98,44 @@ char * FileGetContents(const char *filename, long *size) {
 
 namespace pymol
 {
+MappedFile::MappedFile(const char* filename)
+{
+#ifndef _WIN32
+  int fd = open(filename, O_RDONLY);
+  if (fd != -1) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        madvise(addr, st.st_size, MADV_SEQUENTIAL);
+        m_data = static_cast<char*>(addr);
+        m_size = st.st_size;
+        m_mapped = true;
+      }
+    }
+    close(fd);
+  }
+  if (m_mapped)
+    return;
+#endif
+
+  long size = 0;
+  m_data = FileGetContents(filename, &size);
+  if (m_data)
+    m_size = size;
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (m_mapped) {
+    munmap(m_data, m_size);
+    return;
+  }
+#endif
+  mfree(m_data);
+}
+
 #ifdef _WIN32
 std::wstring utf8_to_utf16(pymol::zstring_view utf8)
 {
@@ -15,4 +15,32 @@ FILE * pymol_fopen(const char * filename, const char * mode);
 
 char * FileGetContents(const char *filename, long *size);
 
+#include <cstddef>
+
+namespace pymol
+{
+/**
+ * Read-only memory mapping of an entire file, for reading large binary
+ * files without copying them to the heap first. Where mmap is not
+ * available, the file is read into memory instead.
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const char* filename);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  explicit operator bool() const { return m_data != nullptr; }
+
+private:
+  char* m_data = nullptr;
+  std::size_t m_size = 0;
+  bool m_mapped = false;
+};
+} // namespace pymol
+
 #endif
@@ -19,6 +19,9 @@ Z* -------------------------------------------------------------------
 #include"os_predef.h"
 #include"os_std.h"
 
+#include<atomic>
+#include<vector>
+
 #include"OVRandom.h"
 #include"OVContext.h"
 
@@ -31,6 +34,7 @@ Z* -------------------------------------------------------------------
 #include"PConv.h"
 #include"P.h"
 #include"Util.h"
+#include"ThreadPool.h"
 
 #define Trace_OFF
 
@@ -70,6 +74,8 @@ struct CIsosurf {
   int AbsDim[3], CurDim[3], CurOff[3];
   int Max[3];
   CField *Coord, *Data;
+  int CoordOff[3];              /* CurOff, or 0 for the CoordBlock scratch */
+  CField *CoordBlock;           /* coordinates of the current block (implicit) */
   float Level;
   int Code[256];
 
@@ -114,10 +120,13 @@ PyObject *IsosurfAsPyList(PyMOLGlobals * G, Isofield * field)
 
   result = PyList_New(4);
 
+  /* implicit coordinates are regenerated from the map state on load */
+  int save_points = field->save_points && field->points;
+
   PyList_SetItem(result, 0, PConvIntArrayToPyList(field->dimensions, 3));
-  PyList_SetItem(result, 1, PyInt_FromLong(field->save_points));
+  PyList_SetItem(result, 1, PyInt_FromLong(save_points));
   PyList_SetItem(result, 2, FieldAsPyList(G, field->data.get()));
-  if(field->save_points)
+  if(save_points)
     PyList_SetItem(result, 3, FieldAsPyList(G, field->points.get()));
   else
     PyList_SetItem(result, 3, PConvAutoNone(NULL));
@@ -142,8 +151,6 @@ static void IsosurfInterpolate(CIsosurf * I, float *v1, float *l1, float *v2, fl
 Isofield *IsosurfNewFromPyList(PyMOLGlobals * G, PyObject * list)
 {
   int ok = true;
-  int dim4[4];
-  int a;
 
   Isofield *result = NULL;
   if(ok)
@@ -162,19 +169,11 @@ Isofield *IsosurfNewFromPyList(PyMOLGlobals * G, PyObject * list)
     result->data.reset(FieldNewFromPyList_From_List(G, list, 2));
     ok = result->data != nullptr;
   }
-  if(ok) {
-    if(result->save_points) {
-      result->points.reset(FieldNewFromPyList_From_List(G, list, 3));
-      ok = result->points != nullptr;
-    }
-    else {
-      for(a = 0; a < 3; a++)
-        dim4[a] = result->dimensions[a];
-      dim4[3] = 3;
-      result->points.reset(CField::make<float>(G, dim4, 4));
-      ok = result->points != nullptr;
-    }
+  if(ok && result->save_points) {
+    result->points.reset(FieldNewFromPyList_From_List(G, list, 3));
+    ok = result->points != nullptr;
   }
+  /* otherwise the owner regenerates the (implicit) coordinates */
   if(!ok) {
     DeleteP(result);
   }
@@ -341,7 +340,7 @@ void IsofieldComputeGradients(PyMOLGlobals * G, Isofield * field)
 
 
 /*===========================================================================*/
-Isofield::Isofield(PyMOLGlobals * G, const int * const dims)
+Isofield::Isofield(PyMOLGlobals * G, const int * const dims, bool implicit_points)
 {
   int dim4[4];
   std::copy_n(dims, 3, dim4);
@@ -350,10 +349,52 @@ Isofield::Isofield(PyMOLGlobals * G, const int * const dims)
   /* Warning: ...FromPyList also allocs and inits from the heap */
 
   data.reset(CField::make<float>(G, dims, 3));
-  points.reset(CField::make<float>(G, dim4, 4));
+  if(!implicit_points)
+    points.reset(CField::make<float>(G, dim4, 4));
   std::copy_n(dims, 3, dimensions);
 }
 
+/*===========================================================================*/
+void Isofield::setImplicitPoints(const float * origin_, const float * axes_)
+{
+  std::copy_n(origin_, 3, origin);
+  std::copy_n(axes_, 9, axes);
+  points.reset();
+}
+
+/*===========================================================================*/
+/*
+ * Writes the coordinates of the grid nodes starting at `offset` into the
+ * (smaller) 4D field `points`, as far as both fields extend.
+ */
+void IsofieldFillPoints(const Isofield * field, CField * points, const int *offset)
+{
+  int max[3];
+  for(int c = 0; c < 3; c++)
+    max[c] = std::min<int>(points->dim[c], field->dimensions[c] - offset[c]);
+
+  for(int a = 0; a < max[0]; a++)
+    for(int b = 0; b < max[1]; b++)
+      for(int c = 0; c < max[2]; c++)
+        field->getPoint(a + offset[0], b + offset[1], c + offset[2],
+                        Ffloat4p(points, a, b, c, 0));
+}
+
+/*===========================================================================*/
+void IsofieldInterpolatePoint(const Isofield * field, int *locus, float *fract,
+                              float *result)
+{
+  if(field->points) {
+    FieldInterpolate3f(field->points.get(), locus, fract, result);
+  } else {
+    /* implicit coordinates are affine, so interpolation is exact */
+    field->getPoint(locus[0], locus[1], locus[2], result);
+    for(int e = 0; e < 3; e++)
+      result[e] += fract[0] * field->axes[e] + fract[1] * field->axes[3 + e] +
+        fract[2] * field->axes[6 + e];
+  }
+}
+
 /*===========================================================================*/
 static void IsosurfCode(CIsosurf * II, const char *bits1, const char *bits2)
 {
@@ -512,13 +553,8 @@ int IsosurfExpand(Isofield * field1, Isofield * field2, CCrystal * cryst,
   field1max[0] = field1->dimensions[0] - 1;
   field1max[1] = field1->dimensions[1] - 1;
   field1max[2] = field1->dimensions[2] - 1;
-  {
-    int a;
-    for(a = 0; a < 3; a++) {
-      rmn[a] = F4(field1->points, 0, 0, 0, a);
-      rmx[a] = F4(field1->points, field1max[0], field1max[1], field1max[2], a);
-    }
-  }
+  field1->getPoint(0, 0, 0, rmn);
+  field1->getPoint(field1max[0], field1max[1], field1max[2], rmx);
 
   /* get min/max extents of map1 in fractional space */
 
@@ -685,12 +721,9 @@ int IsosurfGetRange(PyMOLGlobals * G, Isofield * field,
     mn[0], mn[1], mn[2], mx[0], mx[1], mx[2]
     ENDFD;
 
-  for(a = 0; a < 3; a++) {
-    rmn[a] = F4(field->points, 0, 0, 0, a);
-    rmx[a] = F4(field->points,
-                field->dimensions[0] - 1,
-                field->dimensions[1] - 1, field->dimensions[2] - 1, a);
-  }
+  field->getPoint(0, 0, 0, rmn);
+  field->getPoint(field->dimensions[0] - 1, field->dimensions[1] - 1,
+                  field->dimensions[2] - 1, rmx);
 
   /* get min/max extents of map in fractional space */
 
@@ -793,6 +826,150 @@ int IsosurfGetRange(PyMOLGlobals * G, Isofield * field,
 }
 
 
+/*===========================================================================*/
+/*
+ * Contours the IsosurfSubSize block (i, j, k) of `range`, appending to
+ * I->Line and I->Num. Blocks are independent of each other: DrawLines and
+ * DrawPoints consume all links set up for the block, so the NLink counts
+ * only need to be cleared before the first block of a CIsosurf.
+ */
+static int IsosurfBlock(CIsosurf * I, Isofield * field, const int *range,
+                        int i, int j, int k, int mode, bool clear_links)
+{
+  int ok = true;
+  int c, x, y, z;
+
+  I->CurOff[0] = IsosurfSubSize * i;
+  I->CurOff[1] = IsosurfSubSize * j;
+  I->CurOff[2] = IsosurfSubSize * k;
+  for(c = 0; c < 3; c++)
+    I->CurOff[c] += range[c];
+  for(c = 0; c < 3; c++) {
+    I->Max[c] = range[3 + c] - I->CurOff[c];
+    if(I->Max[c] > (IsosurfSubSize + 1))
+      I->Max[c] = (IsosurfSubSize + 1);
+  }
+  if(I->CoordBlock)
+    IsofieldFillPoints(field, I->CoordBlock, I->CurOff);
+  else
+    copy3(I->CurOff, I->CoordOff);
+  if(clear_links) {
+    for(x = 0; x < I->Max[0]; x++)
+      for(y = 0; y < I->Max[1]; y++)
+        for(z = 0; z < I->Max[2]; z++)
+          for(c = 0; c < 3; c++)
+            EdgePt(I->Point, x, y, z, c).NLink = 0;
+  }
+#ifdef Trace
+  for(c = 0; c < 3; c++)
+    printf(" IsosurfVolume: c: %i CurOff[c]: %i Max[c] %i\n", c,
+           I->CurOff[c], I->Max[c]);
+#endif
+
+  switch (mode) {
+  case 0:                      /* standard mode - want lines */
+    ok = IsosurfCurrent(I);
+    break;
+  case 1:                      /* point mode - just want points on the isosurface */
+    ok = IsosurfPoints(I);
+    break;
+  case 2:
+    /* reserved */
+    break;
+  }
+  return ok;
+}
+
+
+/*===========================================================================*/
+struct IsosurfBlockOutput {
+  pymol::vla<int> num;
+  pymol::vla<float> line;
+  int n_seg = 0, n_line = 0;
+};
+
+/*
+ * Contours the blocks of `range` with `n_thread` threads, each with its own
+ * CIsosurf scratch, and appends the lines to I->Line and I->Num in block
+ * order, so the result is the same as from the serial loop.
+ */
+static int IsosurfVolumeThreads(PyMOLGlobals * G, CIsosurf * I, Isofield * field,
+                                const int *range, const int *Steps, int mode,
+                                int n_thread)
+{
+  int n_block = Steps[0] * Steps[1] * Steps[2];
+  std::vector<IsosurfBlockOutput> output(n_block);
+  std::atomic<int> next_block {0};
+  std::atomic<bool> failed {false};
+
+  PRINTFB(G, FB_Isomesh, FB_Blather)
+    " IsosurfVolume: contouring %d blocks with %d threads.\n", n_block, n_thread
+    ENDFB(G);
+
+  G->ThreadPool->run(n_thread, n_thread, [&](size_t) {
+    CIsosurf *T = IsosurfNew(G);
+    int ok = (T != NULL);
+    if(ok) {
+      copy3(I->AbsDim, T->AbsDim);
+      copy3(I->CurDim, T->CurDim);
+      T->Skip = I->Skip;
+      T->Level = I->Level;
+      T->Data = I->Data;
+      T->Coord = field->points.get();
+      ok = IsosurfAlloc(G, T);
+    }
+    if(ok && !T->Coord) {
+      int dim4[4] = { T->CurDim[0], T->CurDim[1], T->CurDim[2], 3 };
+      T->Coord = T->CoordBlock = CField::make<float>(G, dim4, 4);
+      zero3i(T->CoordOff);
+    }
+    bool first = true;
+    int block;
+    while(ok && !failed && (block = next_block++) < n_block) {
+      auto& out = output[block];
+      out.num = pymol::vla<int>(1);
+      out.line = pymol::vla<float>(IsosurfSubSize * 3);
+      T->Num = std::addressof(out.num);
+      T->Line = std::addressof(out.line);
+      T->NLine = 0;
+      T->NSeg = 0;
+      int i = block / (Steps[1] * Steps[2]);
+      int j = (block / Steps[2]) % Steps[1];
+      int k = block % Steps[2];
+      ok = IsosurfBlock(T, field, range, i, j, k, mode, first);
+      first = false;
+      out.n_seg = T->NSeg;
+      out.n_line = T->NLine;
+      if(G->Interrupt)
+        ok = false;
+    }
+    if(!ok)
+      failed = true;
+    if(T) {
+      IsosurfPurge(T);
+      _IsosurfFree(T);
+    }
+  });
+
+  if(failed)
+    return false;
+
+  /* merge in block order */
+  for(auto& out : output) {
+    if(out.n_line) {
+      I->Line->check((I->NLine + out.n_line) * 3 - 1);
+      std::copy_n(out.line.data(), out.n_line * 3, I->Line->data() + I->NLine * 3);
+      I->NLine += out.n_line;
+    }
+    I->Num->check(I->NSeg + out.n_seg);
+    std::copy_n(out.num.data(), out.n_seg, I->Num->data() + I->NSeg);
+    I->NSeg += out.n_seg;
+    (*I->Num)[I->NSeg] = I->NLine;
+  }
+  return true;
+}
+
+
 /*===========================================================================*/
 int IsosurfVolume(PyMOLGlobals* G, CSetting* set1, CSetting* set2,
     Isofield* field, float level, pymol::vla<int>& num, pymol::vla<float>& vert,
@@ -809,7 +986,7 @@ int IsosurfVolume(PyMOLGlobals* G, CSetting* set1, CSetting* set2,
   {
     int Steps[3];
     int c, i, j, k;
-    int x, y, z;
+    int n_thread;
     int range_store[6];
     I->Num = std::addressof(num);
     I->Line = std::addressof(vert);
@@ -837,6 +1014,13 @@ int IsosurfVolume(PyMOLGlobals* G, CSetting* set1, CSetting* set2,
     if(ok)
       ok = IsosurfAlloc(G, I);
 
+    if(ok && !I->Coord) {
+      /* implicit coordinates: computed for one block at a time */
+      int dim4[4] = { I->CurDim[0], I->CurDim[1], I->CurDim[2], 3 };
+      I->Coord = I->CoordBlock = CField::make<float>(G, dim4, 4);
+      zero3i(I->CoordOff);
+    }
+
     I->NLine = 0;
     I->NSeg = 0;
     I->Num->check(I->NSeg);
@@ -849,47 +1033,20 @@ int IsosurfVolume(PyMOLGlobals* G, CSetting* set1, CSetting* set2,
         IsosurfPurge(I);
         break;
       default:
-        for(i = 0; i < Steps[0]; i++) {
-          for(j = 0; j < Steps[1]; j++) {
-            for(k = 0; k < Steps[2]; k++) {
-              if(ok) {
-                I->CurOff[0] = IsosurfSubSize * i;
-                I->CurOff[1] = IsosurfSubSize * j;
-                I->CurOff[2] = IsosurfSubSize * k;
-                for(c = 0; c < 3; c++)
-                  I->CurOff[c] += range[c];
-                for(c = 0; c < 3; c++) {
-                  I->Max[c] = range[3 + c] - I->CurOff[c];
-                  if(I->Max[c] > (IsosurfSubSize + 1))
-                    I->Max[c] = (IsosurfSubSize + 1);
-                }
-                if(!(i || j || k)) {
-                  for(x = 0; x < I->Max[0]; x++)
-                    for(y = 0; y < I->Max[1]; y++)
-                      for(z = 0; z < I->Max[2]; z++)
-                        for(c = 0; c < 3; c++)
-                          EdgePt(I->Point, x, y, z, c).NLink = 0;
-                }
-#ifdef Trace
-                for(c = 0; c < 3; c++)
-                  printf(" IsosurfVolume: c: %i CurOff[c]: %i Max[c] %i\n", c,
-                         I->CurOff[c], I->Max[c]);
-#endif
-
-                if(ok)
-                  switch (mode) {
-                  case 0:      /* standard mode - want lines */
-                    ok = IsosurfCurrent(I);
-                    break;
-                  case 1:      /* point mode - just want points on the isosurface */
-                    ok = IsosurfPoints(I);
-                    break;
-                  case 2:
-                    /* reserved */
-                    break;
+        n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
+        if(n_thread > Steps[0] * Steps[1] * Steps[2])
+          n_thread = Steps[0] * Steps[1] * Steps[2];
+        if(n_thread > 1) {
+          ok = IsosurfVolumeThreads(G, I, field, range, Steps, mode, n_thread);
+        } else {
+          for(i = 0; i < Steps[0]; i++) {
+            for(j = 0; j < Steps[1]; j++) {
+              for(k = 0; k < Steps[2]; k++) {
+                if(ok) {
+                  ok = IsosurfBlock(I, field, range, i, j, k, mode, !(i || j || k));
+                  if(G->Interrupt) {
+                    ok = false;
                   }
-                if(G->Interrupt) {
-                  ok = false;
                 }
               }
             }
@@ -959,6 +1116,8 @@ static void IsosurfPurge(CIsosurf * II)
   DeleteP(I->VertexCodes);
   DeleteP(I->ActiveEdges);
   DeleteP(I->Point);
+  DeleteP(I->CoordBlock);
+  I->Coord = NULL;
 }
 
 
@@ -1047,7 +1206,6 @@ static int IsosurfGradients(PyMOLGlobals * G, CSetting * set1, CSetting * set2,
     /* locals for performance */
 
     CField *gradients = field->gradients.get();
-    CField *points = field->points.get();
 
     /* flags marking excluded regions to avoid (currently wasteful) */
     int *flag = NULL;
@@ -1083,11 +1241,11 @@ static int IsosurfGradients(PyMOLGlobals * G, CSetting * set1, CSetting * set2,
         /* compute approximate cell spacing */
 
         float average_cell_axis_dist;
-        float *pos[4];
-        pos[0] = Ffloat4p(I->Coord, 0, 0, 0, 0);
-        pos[1] = Ffloat4p(I->Coord, 1, 0, 0, 0);
-        pos[2] = Ffloat4p(I->Coord, 0, 1, 0, 0);
-        pos[3] = Ffloat4p(I->Coord, 0, 0, 1, 0);
+        float pos[4][3];
+        field->getPoint(0, 0, 0, pos[0]);
+        field->getPoint(1, 0, 0, pos[1]);
+        field->getPoint(0, 1, 0, pos[2]);
+        field->getPoint(0, 0, 1, pos[3]);
 
         average_cell_axis_dist = (float) ((diff3f(pos[0], pos[1]) +
                                            diff3f(pos[0], pos[2]) +
@@ -1269,7 +1427,7 @@ static int IsosurfGradients(PyMOLGlobals * G, CSetting * set1, CSetting * set2,
                     float *f;
                     VLACheck(i_line, float, n_line * 3 + 2);
                     f = i_line + (n_line * 3);
-                    FieldInterpolate3f(points, locus, fract, f);
+                    IsofieldInterpolatePoint(field, locus, fract, f);
                     n_line++;
                     n_vert++;
                   }
@@ -1465,9 +1623,9 @@ static int IsosurfDrawPoints(CIsosurf * II)
         for(k = 0; k < I->Max[2]; k++) {
           if((I3(I->VertexCodes, i, j, k)) && (!I3(I->VertexCodes, i + 1, j, k))) {
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i + 1, j, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 0).Point[0]));
 
@@ -1480,9 +1638,9 @@ static int IsosurfDrawPoints(CIsosurf * II)
             I->NLine++;
           } else if(!(I3(I->VertexCodes, i, j, k)) && (I3(I->VertexCodes, i + 1, j, k))) {
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i + 1, j, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 0).Point[0]));
 
@@ -1511,9 +1669,9 @@ static int IsosurfDrawPoints(CIsosurf * II)
           if((I3(I->VertexCodes, i, j, k)) && (!I3(I->VertexCodes, i, j + 1, k))) {
             I4(I->ActiveEdges, i, j, k, 1) = 2;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j + 1, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 1).Point[0]));
 
@@ -1527,9 +1685,9 @@ static int IsosurfDrawPoints(CIsosurf * II)
 
           } else if(!(I3(I->VertexCodes, i, j, k)) && (I3(I->VertexCodes, i, j + 1, k))) {
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j + 1, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 1).Point[0]));
 
@@ -1556,9 +1714,9 @@ static int IsosurfDrawPoints(CIsosurf * II)
       for(k = 0; k < (I->Max[2] - 1); k++) {
         if((I3(I->VertexCodes, i, j, k)) && (!I3(I->VertexCodes, i, j, k + 1))) {
           IsosurfInterpolate(I,
-                             O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                             O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                              O3Ptr(I->Data, i, j, k, I->CurOff),
-                             O4Ptr(I->Coord, i, j, k + 1, 0, I->CurOff),
+                             O4Ptr(I->Coord, i, j, k + 1, 0, I->CoordOff),
                              O3Ptr(I->Data, i, j, k + 1, I->CurOff),
                              &(EdgePt(I->Point, i, j, k, 2).Point[0]));
 
@@ -1572,9 +1730,9 @@ static int IsosurfDrawPoints(CIsosurf * II)
 
         } else if(!(I3(I->VertexCodes, i, j, k)) && (I3(I->VertexCodes, i, j, k + 1))) {
           IsosurfInterpolate(I,
-                             O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                             O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                              O3Ptr(I->Data, i, j, k, I->CurOff),
-                             O4Ptr(I->Coord, i, j, k + 1, 0, I->CurOff),
+                             O4Ptr(I->Coord, i, j, k + 1, 0, I->CoordOff),
                              O3Ptr(I->Data, i, j, k + 1, I->CurOff),
                              &(EdgePt(I->Point, i, j, k, 2).Point[0]));
 
@@ -1960,9 +2118,9 @@ static int IsosurfFindActiveEdges(CIsosurf * II)
 #endif
             I4(I->ActiveEdges, i, j, k, 0) = 2;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i + 1, j, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 0).Point[0]));
           } else if(!(I3(I->VertexCodes, i, j, k)) && (I3(I->VertexCodes, i + 1, j, k))) {
@@ -1971,9 +2129,9 @@ static int IsosurfFindActiveEdges(CIsosurf * II)
 #endif
             I4(I->ActiveEdges, i, j, k, 0) = 1;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i + 1, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i + 1, j, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 0).Point[0]));
           } else
@@ -1996,9 +2154,9 @@ static int IsosurfFindActiveEdges(CIsosurf * II)
 #endif
             I4(I->ActiveEdges, i, j, k, 1) = 2;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j + 1, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 1).Point[0]));
           } else if(!(I3(I->VertexCodes, i, j, k)) && (I3(I->VertexCodes, i, j + 1, k))) {
@@ -2007,9 +2165,9 @@ static int IsosurfFindActiveEdges(CIsosurf * II)
 #endif
             I4(I->ActiveEdges, i, j, k, 1) = 1;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j + 1, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j + 1, k, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 1).Point[0]));
           } else {
@@ -2033,9 +2191,9 @@ static int IsosurfFindActiveEdges(CIsosurf * II)
 #endif
             I4(I->ActiveEdges, i, j, k, 2) = 2;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i, j, k + 1, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k + 1, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k + 1, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 2).Point[0]));
           } else if(!(I3(I->VertexCodes, i, j, k)) && (I3(I->VertexCodes, i, j, k + 1))) {
@@ -2044,9 +2202,9 @@ static int IsosurfFindActiveEdges(CIsosurf * II)
 #endif
             I4(I->ActiveEdges, i, j, k, 2) = 1;
             IsosurfInterpolate(I,
-                               O4Ptr(I->Coord, i, j, k, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k, I->CurOff),
-                               O4Ptr(I->Coord, i, j, k + 1, 0, I->CurOff),
+                               O4Ptr(I->Coord, i, j, k + 1, 0, I->CoordOff),
                                O3Ptr(I->Data, i, j, k + 1, I->CurOff),
                                &(EdgePt(I->Point, i, j, k, 2).Point[0]));
           } else {
@@ -2103,11 +2261,10 @@ static int IsosurfCodeVertices(CIsosurf * II)
  * corner: output buffer of size 8 * 3
  */
 void IsofieldGetCorners(PyMOLGlobals * G, Isofield * field, float * corner) {
-  CField* points = field->points.get();
   for(int a = 0; a < 8; a++) {
-    int i = (a & 1) ? (points->dim[0] - 1) : 0;
-    int j = (a & 2) ? (points->dim[1] - 1) : 0;
-    int k = (a & 4) ? (points->dim[2] - 1) : 0;
-    memcpy(corner + a * 3, F3Ptr(points, i, j, k), 3 * sizeof(float));
+    int i = (a & 1) ? (field->dimensions[0] - 1) : 0;
+    int j = (a & 2) ? (field->dimensions[1] - 1) : 0;
+    int k = (a & 4) ? (field->dimensions[2] - 1) : 0;
+    field->getPoint(i, j, k, corner + a * 3);
   }
 }
@@ -29,11 +29,35 @@ Z* -------------------------------------------------------------------
 struct Isofield {
   int dimensions[3]{};
   int save_points = true;
-  pymol::copyable_ptr<CField> points;
+  pymol::copyable_ptr<CField> points;   // NULL for implicit coordinates
   pymol::copyable_ptr<CField> data;
   pymol::cache_ptr<CField> gradients;
+
+  /* implicit coordinates: without a points field, grid node (a, b, c)
+     sits at origin + a * axes[0..2] + b * axes[3..5] + c * axes[6..8] */
+  float origin[3]{};
+  float axes[9]{};
+
   Isofield() = default;
-  Isofield(PyMOLGlobals * G, const int * const dims);
+  Isofield(PyMOLGlobals * G, const int * const dims, bool implicit_points = false);
+
+  void setImplicitPoints(const float * origin, const float * axes);
+
+  /**
+   * Coordinate of grid node (a, b, c), from either representation
+   */
+  void getPoint(int a, int b, int c, float * v) const
+  {
+    if(points) {
+      const float *p = Ffloat4p(points, a, b, c, 0);
+      v[0] = p[0];
+      v[1] = p[1];
+      v[2] = p[2];
+    } else {
+      for(int e = 0; e < 3; e++)
+        v[e] = origin[e] + a * axes[e] + b * axes[3 + e] + c * axes[6 + e];
+    }
+  }
 };
 
 #define F3(field,P1,P2,P3) Ffloat3(field,P1,P2,P3)
@@ -58,6 +82,9 @@ void IsosurfFree(PyMOLGlobals * G);
 /* isofield operations -- not part of Isosurf */
 
 void IsofieldComputeGradients(PyMOLGlobals * G, Isofield * field);
+void IsofieldFillPoints(const Isofield * field, CField * points, const int *offset);
+void IsofieldInterpolatePoint(const Isofield * field, int *locus, float *fract,
+                              float *result);
 PyObject *IsosurfAsPyList(PyMOLGlobals *G, Isofield * I);
 Isofield *IsosurfNewFromPyList(PyMOLGlobals * G, PyObject * list);
 
@@ -54,22 +54,33 @@ MapType::~MapType()
 
 int MapCacheInit(MapCache * M, MapType * I, int group_id, int block_base)
 {
-  PyMOLGlobals *G = I->G;
+  int ok = MapCacheInitSize(M, I->G, I->NVert, group_id, block_base);
+  M->block_base = I->block_base;
+  return ok;
+}
+
+/*
+ * Like MapCacheInit, but for callers without a map (e.g. a ray tracing
+ * basis which uses a BVH). `nVert` is the largest index + 1 to be cached.
+ */
+int MapCacheInitSize(MapCache * M, PyMOLGlobals * G, int nVert, int group_id,
+                     int block_base)
+{
   int ok = true;
 
   M->G = G;
-  M->block_base = I->block_base;
+  M->block_base = block_base;
   M->Cache =
-    CacheCalloc(G, int, I->NVert, group_id, block_base + cCache_map_cache_offset);
+    CacheCalloc(G, int, nVert, group_id, block_base + cCache_map_cache_offset);
   CHECKOK(ok, M->Cache);
   if (ok)
     M->CacheLink =
-      CacheAlloc(G, int, I->NVert, group_id, block_base + cCache_map_cache_link_offset);
+      CacheAlloc(G, int, nVert, group_id, block_base + cCache_map_cache_link_offset);
   CHECKOK(ok, M->CacheLink);
   M->CacheStart = -1;
   return ok;
   /*  p=M->Cache;
-     for(a=0;a<I->NVert;a++)
+     for(a=0;a<nVert;a++)
      *(p++) = 0; */
 }
 
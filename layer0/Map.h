@@ -79,6 +79,8 @@ int *MapLocusEStart(MapType * map, const float *v);
 #define MapCached(m,a) ((m)->Cache[a])
 
 int MapCacheInit(MapCache * M, MapType * I, int group_id, int block_base);
+int MapCacheInitSize(MapCache * M, PyMOLGlobals * G, int nVert, int group_id,
+                     int block_base);
 void MapCacheReset(MapCache * M);
 void MapCacheFree(MapCache * M, int group_id, int block_base);
 
@@ -22,6 +22,7 @@ namespace pymol
 {
 class cif_file;
 class cif_data;
+class ThreadPool;
 }; // namespace pymol
 
 /* retina scale factor for ortho gui */
@@ -165,6 +166,7 @@ struct _PyMOLGlobals {
   CPlugIOManager *PlugIOManager;
   CShaderMgr* ShaderMgr;
   COpenVR* OpenVR;
+  pymol::ThreadPool* ThreadPool; /* native worker threads (ray tracing) */
 
 #ifndef _PYMOL_NOPY
   CP_inst *P_inst;
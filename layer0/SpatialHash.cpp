@@ -0,0 +1,142 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pymol
+{
+
+// keeps points at exactly `cutoff` distance in adjacent cells despite
+// rounding (same purpose as MapSafety)
+static const float SpatialHashSafety = 0.01F;
+
+// upper bound for the number of cells, relative to the number of points
+static const std::size_t SpatialHashCellsPerPoint = 8;
+
+SpatialHash::SpatialHash(
+    float cutoff, const float* vert, std::size_t n_vert, const int* flag)
+{
+  std::size_t n_point = 0;
+  float max[3] = {};
+
+  for (std::size_t a = 0; a < n_vert; ++a) {
+    if (flag && !flag[a])
+      continue;
+    const float* v = vert + 3 * a;
+    for (int i = 0; i < 3; ++i) {
+      if (!n_point || v[i] < m_min[i])
+        m_min[i] = v[i];
+      if (!n_point || v[i] > max[i])
+        max[i] = v[i];
+    }
+    ++n_point;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    if (!std::isfinite(max[i] - m_min[i])) {
+      m_min[i] = max[i] = 0.F;
+    }
+  }
+
+  m_div = std::max(cutoff, 0.F) + SpatialHashSafety;
+
+  // coarsen the grid for sparse point clouds
+  const double max_cells =
+      std::max<double>(64, SpatialHashCellsPerPoint * double(n_point));
+  for (;;) {
+    double n_cell = 1;
+    for (int i = 0; i < 3; ++i) {
+      n_cell *= std::floor((max[i] - m_min[i]) / m_div) + 1;
+    }
+    if (n_cell <= max_cells)
+      break;
+    m_div *= std::max(1.01, std::cbrt(n_cell / max_cells));
+  }
+
+  m_recip = 1.F / m_div;
+  for (int i = 0; i < 3; ++i) {
+    m_dim[i] = int((max[i] - m_min[i]) * m_recip) + 1;
+  }
+
+  const int n_cell = m_dim[0] * m_dim[1] * m_dim[2];
+
+  // counting sort by cell
+  std::vector<int> cell_of(n_vert, -1);
+  m_start.assign(n_cell + 1, 0);
+
+  for (std::size_t a = 0; a < n_vert; ++a) {
+    if (flag && !flag[a])
+      continue;
+    int c[3];
+    cellOf(vert + 3 * a, c);
+    for (int i = 0; i < 3; ++i) {
+      c[i] = std::min(std::max(c[i], 0), m_dim[i] - 1);
+    }
+    int cell = (c[0] * m_dim[1] + c[1]) * m_dim[2] + c[2];
+    cell_of[a] = cell;
+    ++m_start[cell + 1];
+  }
+
+  for (int cell = 0; cell < n_cell; ++cell) {
+    m_start[cell + 1] += m_start[cell];
+  }
+
+  m_index.resize(n_point);
+  m_coord.resize(3 * n_point);
+
+  std::vector<int> fill(m_start.begin(), m_start.end() - 1);
+  for (std::size_t a = 0; a < n_vert; ++a) {
+    if (cell_of[a] < 0)
+      continue;
+    int pos = fill[cell_of[a]]++;
+    m_index[pos] = a;
+    copy3f(vert + 3 * a, m_coord.data() + 3 * pos);
+  }
+}
+
+/**
+ * Unclamped cell indices of `v` (limited to one cell outside the grid)
+ */
+void SpatialHash::cellOf(const float* v, int* cell) const
+{
+  for (int i = 0; i < 3; ++i) {
+    float f = std::floor((v[i] - m_min[i]) * m_recip);
+    if (!(f >= -2.F)) {
+      f = -2.F; // also NaN
+    }
+    cell[i] = int(std::min(f, float(m_dim[i] + 1)));
+  }
+}
+
+SpatialHash::Iter::Iter(const SpatialHash& hash, const float* v)
+    : m_hash(&hash)
+{
+  int c[3];
+  hash.cellOf(v, c);
+
+  const int* dim = hash.m_dim;
+  const int z0 = std::max(c[2] - 1, 0);
+  const int z1 = std::min(c[2] + 1, dim[2] - 1);
+
+  if (z0 > z1)
+    return;
+
+  for (int x = std::max(c[0] - 1, 0); x <= c[0] + 1 && x < dim[0]; ++x) {
+    for (int y = std::max(c[1] - 1, 0); y <= c[1] + 1 && y < dim[1]; ++y) {
+      int cell = (x * dim[1] + y) * dim[2];
+      int begin = hash.m_start[cell + z0];
+      int end = hash.m_start[cell + z1 + 1];
+      if (begin != end) {
+        m_range[m_n_range][0] = begin;
+        m_range[m_n_range][1] = end;
+        ++m_n_range;
+      }
+    }
+  }
+
+  if (m_n_range) {
+    m_pos = m_range[0][0];
+  }
+}
+
+} // namespace pymol
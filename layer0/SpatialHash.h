@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Vector.h"
+
+namespace pymol
+{
+
+/**
+ * Compact 3-D hash for neighbor searches.
+ *
+ * Unlike MapType (per-cell linked lists plus an "express" list of the 27
+ * surrounding cells), points are counting-sorted by cell into contiguous
+ * arrays of indices and coordinates (compressed sparse row layout). A query
+ * scans nine runs of adjacent memory, one per (x, y) neighbor column, and
+ * distance checks read the packed copy of the coordinates instead of the
+ * caller's (typically scattered) array.
+ */
+class SpatialHash
+{
+public:
+  /**
+   * @param cutoff largest query distance
+   * @param vert coordinates, 3 floats per point
+   * @param n_vert number of points
+   * @param flag if not NULL, only points with a non-zero flag get indexed
+   */
+  SpatialHash(float cutoff, const float* vert, std::size_t n_vert,
+      const int* flag = nullptr);
+
+  /**
+   * Range iteration over the indices of all points in the cells adjacent to
+   * a query point (a superset of the points within `cutoff`).
+   */
+  class Iter
+  {
+    const SpatialHash* m_hash = nullptr;
+    int m_range[9][2];
+    int m_n_range = 0;
+    int m_r = 0;
+    int m_pos = 0;
+
+    void skipEmpty()
+    {
+      while (m_pos == m_range[m_r][1] && ++m_r < m_n_range)
+        m_pos = m_range[m_r][0];
+    }
+
+  public:
+    Iter() = default;
+    Iter(const SpatialHash& hash, const float* v);
+
+    bool operator!=(Iter const& other) const { return m_r != other.m_r; }
+
+    int operator*() const { return m_hash->m_index[m_pos]; }
+
+    /// Packed coordinates of the current point
+    const float* coord() const { return m_hash->m_coord.data() + 3 * m_pos; }
+
+    Iter& operator++()
+    {
+      ++m_pos;
+      skipEmpty();
+      return *this;
+    }
+
+    Iter begin() const { return *this; }
+    Iter end() const
+    {
+      Iter it;
+      it.m_r = m_n_range;
+      return it;
+    }
+  };
+
+  /**
+   * Candidates for neighbors of `v`
+   */
+  Iter query(const float* v) const { return Iter(*this, v); }
+
+  /**
+   * Calls `fn(index)` for every point within `dist` (<= cutoff) of `v`
+   */
+  template <typename Fn> void forEachWithin(const float* v, float dist, Fn&& fn) const
+  {
+    for (auto it = query(v); it != it.end(); ++it) {
+      if (within3f(it.coord(), v, dist)) {
+        fn(*it);
+      }
+    }
+  }
+
+  /// Number of indexed points
+  std::size_t size() const { return m_index.size(); }
+
+  /// Number of cells
+  std::size_t cellCount() const { return m_start.size() - 1; }
+
+private:
+  void cellOf(const float* v, int* cell) const;
+
+  float m_div;
+  float m_recip;
+  float m_min[3] = {};
+  int m_dim[3] = {1, 1, 1};
+
+  std::vector<int> m_start;   // cell -> first position, plus end sentinel
+  std::vector<int> m_index;   // position -> point index
+  std::vector<float> m_coord; // position -> coordinates
+};
+
+} // namespace pymol
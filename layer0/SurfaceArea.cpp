@@ -0,0 +1,175 @@
+/*
+ * Per-atom surface areas without building a representation.
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "SpatialHash.h"
+#include "Sphere.h"
+#include "SurfaceArea.h"
+#include "ThreadPool.h"
+
+namespace pymol
+{
+
+// minimum number of atoms per task
+static const std::size_t SurfaceAreaMinAtomsPerTask = 64;
+
+// the neighbor scan tests this many occluders at once (padded)
+static const int SurfaceAreaLanes = 8;
+
+namespace
+{
+/**
+ * Occluders of one atom in structure-of-arrays layout, closest first
+ */
+struct SurfaceAreaNeighbors {
+  std::vector<float> x, y, z, r2;
+  std::vector<std::pair<float, int>> order;
+
+  int size() const { return int(x.size()); }
+};
+} // namespace
+
+/*
+ * Collect the atoms which can occlude dots on sphere `a`, padded to a
+ * multiple of SurfaceAreaLanes with entries which never occlude.
+ */
+static void SurfaceAreaGatherNeighbors(const SpatialHash& hash,
+    const float* coord, const float* radius, std::size_t a,
+    SurfaceAreaNeighbors& nbr)
+{
+  const float* v0 = coord + 3 * a;
+  const float r0 = radius[a];
+
+  nbr.order.clear();
+  for (auto it = hash.query(v0); it != it.end(); ++it) {
+    std::size_t j = *it;
+    if (j == a)
+      continue;
+    const float* v1 = it.coord();
+    float cutoff = r0 + radius[j];
+    float dist2 = diffsq3f(v0, v1);
+    if (dist2 <= cutoff * cutoff) {
+      nbr.order.emplace_back(dist2, int(j));
+    }
+  }
+
+  // closest atoms bury the most dots
+  std::sort(nbr.order.begin(), nbr.order.end());
+
+  std::size_t n = nbr.order.size();
+  std::size_t n_padded =
+      (n + SurfaceAreaLanes - 1) / SurfaceAreaLanes * SurfaceAreaLanes;
+  nbr.x.resize(n_padded);
+  nbr.y.resize(n_padded);
+  nbr.z.resize(n_padded);
+  nbr.r2.resize(n_padded);
+  for (std::size_t k = 0; k < n_padded; ++k) {
+    if (k < n) {
+      int j = nbr.order[k].second;
+      nbr.x[k] = coord[3 * j];
+      nbr.y[k] = coord[3 * j + 1];
+      nbr.z[k] = coord[3 * j + 2];
+      nbr.r2[k] = radius[j] * radius[j];
+    } else {
+      nbr.x[k] = nbr.y[k] = nbr.z[k] = 0.F;
+      nbr.r2[k] = -1.F;
+    }
+  }
+}
+
+/*
+ * First block of SurfaceAreaLanes occluders (starting at `first`, wrapping
+ * around) which contains `v`, or -1 if `v` is exposed
+ */
+static int SurfaceAreaFindOccluder(
+    const SurfaceAreaNeighbors& nbr, const float* v, int first)
+{
+  const int n = nbr.size();
+  const float* x = nbr.x.data();
+  const float* y = nbr.y.data();
+  const float* z = nbr.z.data();
+  const float* r2 = nbr.r2.data();
+
+  for (int i = 0; i < n; i += SurfaceAreaLanes) {
+    int k = first + i;
+    if (k >= n)
+      k -= n;
+    // branch-free over one block, so the compiler can vectorize it
+    int hit = 0;
+    for (int l = 0; l < SurfaceAreaLanes; ++l) {
+      float dx = x[k + l] - v[0];
+      float dy = y[k + l] - v[1];
+      float dz = z[k + l] - v[2];
+      hit |= (dx * dx + dy * dy + dz * dz <= r2[k + l]);
+    }
+    if (hit)
+      return k;
+  }
+  return -1;
+}
+
+void AtomSurfaceArea(const float* coord, const float* radius,
+    std::size_t n_atom, const int* surface, const int* occlude,
+    const SphereRec* sp, ThreadPool* pool, std::size_t n_thread, float* area)
+{
+  std::fill(area, area + n_atom, 0.F);
+
+  float max_radius = 0.F;
+  for (std::size_t a = 0; a < n_atom; ++a) {
+    max_radius = std::max(max_radius, radius[a]);
+  }
+
+  const SpatialHash hash(2.F * max_radius, coord, n_atom, occlude);
+
+  const std::size_t n_task = std::max<std::size_t>(1,
+      std::min(n_thread * 4, n_atom / SurfaceAreaMinAtomsPerTask));
+
+  auto task_fn = [&](std::size_t task) {
+    SurfaceAreaNeighbors nbr;
+    const std::size_t a_begin = n_atom * task / n_task;
+    const std::size_t a_end = n_atom * (task + 1) / n_task;
+
+    for (std::size_t a = a_begin; a < a_end; ++a) {
+      if (surface && !surface[a])
+        continue;
+
+      const float* v0 = coord + 3 * a;
+      const float r0 = radius[a];
+      SurfaceAreaGatherNeighbors(hash, coord, radius, a, nbr);
+
+      // neighboring dots tend to be buried by the same atom
+      int last = 0;
+      float exposed = 0.F;
+
+      for (int b = 0; b < sp->nDot; ++b) {
+        const float v[3] = {
+            v0[0] + r0 * sp->dot[b][0],
+            v0[1] + r0 * sp->dot[b][1],
+            v0[2] + r0 * sp->dot[b][2],
+        };
+        int k = SurfaceAreaFindOccluder(nbr, v, last);
+        if (k < 0) {
+          exposed += sp->area[b];
+        } else {
+          last = k;
+        }
+      }
+
+      area[a] = r0 * r0 * exposed;
+    }
+  };
+
+  if (pool && n_task > 1) {
+    pool->run(n_task, n_thread, task_fn);
+  } else {
+    for (std::size_t task = 0; task < n_task; ++task) {
+      task_fn(task);
+    }
+  }
+}
+
+} // namespace pymol
@@ -0,0 +1,40 @@
+/*
+ * Per-atom surface areas without building a representation.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+struct SphereRec;
+
+namespace pymol
+{
+
+class ThreadPool;
+
+/**
+ * Exposed surface area of each atom sphere (Shrake-Rupley): the dots of
+ * `sp`, scaled to the atom radius, count as exposed unless they are inside
+ * an occluding atom, and each exposed dot contributes its share of the
+ * sphere area. Add the solvent radius to `radius` for the solvent
+ * accessible area.
+ *
+ * Atoms are processed in parallel, the result does not depend on the number
+ * of threads.
+ *
+ * @param coord coordinates, 3 floats per atom
+ * @param radius atom radii
+ * @param n_atom number of atoms
+ * @param surface if not NULL, only atoms with a non-zero value get an area
+ * @param occlude if not NULL, only atoms with a non-zero value occlude dots
+ * @param sp dot sphere (unit vectors and areas)
+ * @param pool thread pool (may be NULL)
+ * @param n_thread maximum number of threads
+ * @param[out] area per-atom areas (zero for atoms not in `surface`)
+ */
+void AtomSurfaceArea(const float* coord, const float* radius,
+    std::size_t n_atom, const int* surface, const int* occlude,
+    const SphereRec* sp, ThreadPool* pool, std::size_t n_thread, float* area);
+
+} // namespace pymol
@@ -0,0 +1,92 @@
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace pymol
+{
+
+TaskGraph::TaskId TaskGraph::add(TaskFn fn, std::initializer_list<TaskId> deps)
+{
+  TaskId id = m_tasks.size();
+  m_tasks.emplace_back();
+  m_tasks.back().fn = std::move(fn);
+
+  for (auto dep : deps) {
+    addDependency(id, dep);
+  }
+
+  return id;
+}
+
+void TaskGraph::addDependency(TaskId task, TaskId dep)
+{
+  assert(dep < task && task < m_tasks.size());
+  m_tasks[dep].dependents.push_back(task);
+  ++m_tasks[task].n_deps;
+}
+
+void TaskGraph::run(ThreadPool& pool, std::size_t n_thread)
+{
+  const std::size_t n_tasks = m_tasks.size();
+
+  if (n_thread < 2 || n_tasks < 2) {
+    for (auto& task : m_tasks) {
+      task.fn();
+    }
+    m_tasks.clear();
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<TaskId> ready;
+  std::size_t n_done = 0;
+
+  for (TaskId id = 0; id != n_tasks; ++id) {
+    if (m_tasks[id].n_deps == 0) {
+      ready.push_back(id);
+    }
+  }
+
+  // Each worker takes ready tasks until all tasks have finished. If the
+  // pool runs the workers serially (nested call), the first one does all
+  // the work.
+  pool.run(std::min(n_thread, n_tasks), n_thread, [&](std::size_t) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;) {
+      cv.wait(lock, [&] { return !ready.empty() || n_done == n_tasks; });
+
+      if (ready.empty()) {
+        return;
+      }
+
+      TaskId id = ready.front();
+      ready.pop_front();
+
+      lock.unlock();
+      m_tasks[id].fn();
+      lock.lock();
+
+      for (auto dependent : m_tasks[id].dependents) {
+        if (--m_tasks[dependent].n_deps == 0) {
+          ready.push_back(dependent);
+          cv.notify_one();
+        }
+      }
+
+      if (++n_done == n_tasks) {
+        cv.notify_all();
+      }
+    }
+  });
+
+  m_tasks.clear();
+}
+
+} // namespace pymol
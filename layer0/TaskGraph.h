@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+namespace pymol
+{
+
+class ThreadPool;
+
+/**
+ * Set of tasks with dependencies (e.g. object neighbors before the cartoon
+ * of each state), executed on a ThreadPool.
+ *
+ * Tasks must be added after their dependencies, so the insertion order is
+ * always a valid serial execution order. With multiple threads, a task
+ * becomes ready once all of its dependencies have finished, and idle threads
+ * take the oldest ready task. Tasks are meant to be coarse (an object, a
+ * state, a representation), so ready tasks are kept in a single shared
+ * queue.
+ */
+class TaskGraph
+{
+public:
+  using TaskId = std::size_t;
+  using TaskFn = std::function<void()>;
+
+  /**
+   * Add a task
+   * @param fn task function
+   * @param deps tasks which must finish before this one starts
+   * @return id for use as a dependency of later tasks
+   */
+  TaskId add(TaskFn fn, std::initializer_list<TaskId> deps = {});
+
+  /**
+   * Add a dependency to a task which was added before
+   * @pre `dep < task`
+   */
+  void addDependency(TaskId task, TaskId dep);
+
+  /**
+   * Number of tasks
+   */
+  std::size_t size() const { return m_tasks.size(); }
+
+  /**
+   * Run all tasks and block until they have finished. Runs serially in
+   * insertion order if `n_thread < 2`. The graph can't be run again.
+   *
+   * @param pool worker threads
+   * @param n_thread maximum number of threads (including the calling thread)
+   */
+  void run(ThreadPool& pool, std::size_t n_thread);
+
+private:
+  struct Task {
+    TaskFn fn;
+    std::vector<TaskId> dependents;
+    std::size_t n_deps = 0;
+  };
+
+  std::vector<Task> m_tasks;
+};
+
+} // namespace pymol
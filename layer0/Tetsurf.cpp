@@ -81,6 +81,8 @@ struct _CTetsurf {
   int AbsDim[3], CurDim[3], CurOff[3];
   int Max[3];
   CField *Coord, *Data, *Grad;
+  int CoordOff[3];              /* CurOff, or 0 for the CoordBlock scratch */
+  CField *CoordBlock;           /* coordinates of the current block (implicit) */
   float Level;
   int Edge[6020];               /* 6017 */
   int EdgeStart[256];
@@ -419,12 +421,9 @@ void TetsurfGetRange(PyMOLGlobals * G,
     mn[0], mn[1], mn[2], mx[0], mx[1], mx[2]
     ENDFD;
 
-  for(a = 0; a < 3; a++) {
-    rmn[a] = F4(field->points, 0, 0, 0, a);
-    rmx[a] = F4(field->points,
-                field->dimensions[0] - 1,
-                field->dimensions[1] - 1, field->dimensions[2] - 1, a);
-  }
+  field->getPoint(0, 0, 0, rmn);
+  field->getPoint(field->dimensions[0] - 1, field->dimensions[1] - 1,
+                  field->dimensions[2] - 1, rmx);
 
   /* get min/max extents of map in fractional space */
 
@@ -570,6 +569,13 @@ int TetsurfVolume(PyMOLGlobals * G, Isofield * field, float level, int **num,
     if(ok)
       ok = TetsurfAlloc(I);
 
+    if(ok && !I->Coord) {
+      /* implicit coordinates: computed for one block at a time */
+      int dim4[4] = { I->CurDim[0], I->CurDim[1], I->CurDim[2], 3 };
+      I->Coord = I->CoordBlock = CField::make<float>(G, dim4, 4);
+      zero3i(I->CoordOff);
+    }
+
     if(ok) {
 
       for(i = 0; i < Steps[0]; i++)
@@ -585,6 +591,10 @@ int TetsurfVolume(PyMOLGlobals * G, Isofield * field, float level, int **num,
               if(I->Max[c] > (TetsurfSubSize + 1))
                 I->Max[c] = (TetsurfSubSize + 1);
             }
+            if(I->CoordBlock)
+              IsofieldFillPoints(field, I->CoordBlock, I->CurOff);
+            else
+              copy3(I->CurOff, I->CoordOff);
             /*         
                for(c=0;c<3;c++)
                printf(" TetsurfVolume: c: %i I->CurOff[c]: %i I->Max[c] %i\n",c,I->CurOff[c],I->Max[c]); 
@@ -677,6 +687,8 @@ static void TetsurfPurge(CTetsurf * II)
   DeleteP(I->VertexCodes);
   DeleteP(I->ActiveEdges);
   DeleteP(I->Point);
+  DeleteP(I->CoordBlock);
+  I->Coord = NULL;
 }
 
 
@@ -791,14 +803,14 @@ static int TetsurfFindActiveBoxes(CTetsurf * II, int mode, int *n_strip, int n_v
 
         if((i000 != i001) || (i001 != i010) || (i010 != i011) || (i011 != i100) || (i100 != i101) || (i101 != i110) || (i110 != i111)) {        /* this is an active box */
 
-          c000 = O4Ptr(I->Coord, i, j, k, 0, I->CurOff);
-          c001 = O4Ptr(I->Coord, i, j, k + 1, 0, I->CurOff);
-          c010 = O4Ptr(I->Coord, i, j + 1, k, 0, I->CurOff);
-          c011 = O4Ptr(I->Coord, i, j + 1, k + 1, 0, I->CurOff);
-          c100 = O4Ptr(I->Coord, i + 1, j, k, 0, I->CurOff);
-          c101 = O4Ptr(I->Coord, i + 1, j, k + 1, 0, I->CurOff);
-          c110 = O4Ptr(I->Coord, i + 1, j + 1, k, 0, I->CurOff);
-          c111 = O4Ptr(I->Coord, i + 1, j + 1, k + 1, 0, I->CurOff);
+          c000 = O4Ptr(I->Coord, i, j, k, 0, I->CoordOff);
+          c001 = O4Ptr(I->Coord, i, j, k + 1, 0, I->CoordOff);
+          c010 = O4Ptr(I->Coord, i, j + 1, k, 0, I->CoordOff);
+          c011 = O4Ptr(I->Coord, i, j + 1, k + 1, 0, I->CoordOff);
+          c100 = O4Ptr(I->Coord, i + 1, j, k, 0, I->CoordOff);
+          c101 = O4Ptr(I->Coord, i + 1, j, k + 1, 0, I->CoordOff);
+          c110 = O4Ptr(I->Coord, i + 1, j + 1, k, 0, I->CoordOff);
+          c111 = O4Ptr(I->Coord, i + 1, j + 1, k + 1, 0, I->CoordOff);
 
           if(mode == 3) {
 
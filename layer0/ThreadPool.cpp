@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace pymol
+{
+
+static thread_local bool s_is_worker_thread = false;
+
+bool ThreadPool::isWorkerThread()
+{
+  return s_is_worker_thread;
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv_start.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Start additional workers until there are at least `n_workers`.
+ * Must only be called while holding `m_run_mutex`.
+ */
+void ThreadPool::reserve(std::size_t n_workers)
+{
+  while (m_workers.size() < n_workers) {
+    m_workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+void ThreadPool::runTasks(const TaskFn& fn, std::size_t n_tasks)
+{
+  for (std::size_t i; (i = m_next.fetch_add(1)) < n_tasks;) {
+    fn(i);
+  }
+}
+
+void ThreadPool::workerLoop()
+{
+  s_is_worker_thread = true;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // a freshly started worker may join the job it was started for
+  unsigned seen = m_fn ? m_generation - 1 : m_generation;
+
+  for (;;) {
+    m_cv_start.wait(lock,
+        [&] { return m_stop || (m_slots && m_generation != seen); });
+
+    if (m_stop)
+      return;
+
+    seen = m_generation;
+    --m_slots;
+    ++m_busy;
+
+    const TaskFn& fn = *m_fn;
+    std::size_t n_tasks = m_n_tasks;
+
+    lock.unlock();
+    runTasks(fn, n_tasks);
+    lock.lock();
+
+    if (--m_busy == 0) {
+      m_cv_done.notify_all();
+    }
+  }
+}
+
+void ThreadPool::run(std::size_t n_tasks, std::size_t n_thread, const TaskFn& fn)
+{
+  auto run_serial = [&] {
+    for (std::size_t i = 0; i < n_tasks; ++i) {
+      fn(i);
+    }
+  };
+
+  // not holding m_run_mutex, so a single task may use the pool itself
+  if (n_thread < 2 || n_tasks < 2) {
+    run_serial();
+    return;
+  }
+
+  // nested calls from inside a task, or the workers are busy
+  std::unique_lock<std::mutex> run_lock(m_run_mutex, std::try_to_lock);
+  if (!run_lock.owns_lock()) {
+    run_serial();
+    return;
+  }
+
+  std::size_t n_workers = std::min(n_thread, n_tasks) - 1;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fn = &fn;
+    m_n_tasks = n_tasks;
+    m_slots = n_workers;
+    m_next = 1;
+    ++m_generation;
+  }
+
+  reserve(n_workers);
+  m_cv_start.notify_all();
+
+  // task 0 is reserved for the calling thread
+  fn(0);
+  runTasks(fn, n_tasks);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_slots = 0;
+  m_cv_done.wait(lock, [&] { return m_busy == 0; });
+  m_fn = nullptr;
+}
+
+} // namespace pymol
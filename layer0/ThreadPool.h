@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pymol
+{
+
+/**
+ * Persistent pool of native worker threads, owned by PyMOLGlobals.
+ *
+ * Workers are started lazily (growing up to the requested thread count) and
+ * stay alive until the pool is destroyed, so repeated parallel sections (e.g.
+ * one ray trace per movie frame) don't pay for thread creation. Tasks never
+ * touch the Python interpreter, which makes the pool usable in _PYMOL_NOPY
+ * builds as well.
+ */
+class ThreadPool
+{
+public:
+  using TaskFn = std::function<void(std::size_t)>;
+
+  ThreadPool() = default;
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  /**
+   * Calls `fn(i)` for every i in [0, n_tasks) using at most `n_thread`
+   * threads (including the calling thread) and blocks until all tasks have
+   * finished. Task 0 always runs on the calling thread, so it may do
+   * things which require the caller's context (e.g. progress updates which
+   * need the GIL).
+   *
+   * Nested calls (from inside a task), and calls from other threads while
+   * the workers are busy, run serially on the calling thread.
+   *
+   * @param n_tasks number of tasks
+   * @param n_thread maximum number of threads
+   * @param fn task function
+   */
+  void run(std::size_t n_tasks, std::size_t n_thread, const TaskFn& fn);
+
+  /**
+   * Number of worker threads currently alive (not counting the caller)
+   */
+  std::size_t size() const { return m_workers.size(); }
+
+  /**
+   * True if called from one of the worker threads (of any pool). Worker
+   * threads have no Python thread state, so code which may run inside a task
+   * must not call into the interpreter there (e.g. progress updates).
+   */
+  static bool isWorkerThread();
+
+private:
+  void reserve(std::size_t n_workers);
+  void workerLoop();
+  void runTasks(const TaskFn& fn, std::size_t n_tasks);
+
+  std::vector<std::thread> m_workers;
+
+  // held by the run() call which owns the workers; a concurrent or nested
+  // run() doesn't wait for it but runs its tasks serially on its own thread
+  std::mutex m_run_mutex;
+
+  // protects the job state below
+  std::mutex m_mutex;
+  std::condition_variable m_cv_start;
+  std::condition_variable m_cv_done;
+
+  const TaskFn* m_fn = nullptr;
+  std::size_t m_n_tasks = 0;
+  std::size_t m_slots = 0;        // workers still allowed to join the job
+  std::size_t m_busy = 0;         // workers currently inside the job
+  unsigned m_generation = 0;      // incremented for every job
+  bool m_stop = false;
+
+  std::atomic<std::size_t> m_next{0};
+};
+
+} // namespace pymol
@@ -27,6 +27,13 @@ Z* -------------------------------------------------------------------
 #include"MemoryCache.h"
 #include"Character.h"
 
+#include<algorithm>
+#include<vector>
+
+#ifdef __SSE2__
+#include<emmintrin.h>
+#endif
+
 static const float kR_SMALL4 = 0.0001F;
 static const float kR_SMALL5 = 0.0001F;
 #define EPSILON 0.000001F
@@ -1483,6 +1490,262 @@ void BasisGetTriangleNormal(CBasis * I, RayInfo * r, int i, float *fc, int persp
 }
 
 
+/*========================================================================*/
+/* Bounding volume hierarchy (alternative to the voxel map, see ray_bvh)
+ *
+ * Nodes are stored depth-first, so the first child of an inner node
+ * directly follows its parent. Leaves reference a run of vertex indices in
+ * List (one per primitive, its first vertex), and the padded bounds of
+ * each of those primitives are kept in Box, one array per coordinate.
+ *
+ * The walk hands out -1 terminated candidate lists in the same shape as
+ * the express lists of the map, so the intersection code is shared between
+ * both acceleration structures. Leaf entries are tested against the ray
+ * four at a time (SSE2, with a scalar fallback), so that primitives which
+ * can't be hit are rejected without touching their CPrimitive record.
+ *
+ * This filter is only used by the BVH. The default voxel map path (ray_bvh
+ * off) still tests the primitives of its express lists one at a time.
+ */
+
+#define BASIS_BVH_MAX_DEPTH 60
+#define BASIS_BVH_MAX_LEAF 16
+#define BASIS_BVH_BINS 16
+#define BASIS_BVH_BATCH 8       /* leaf entries filtered per step, multiple of 4 */
+
+struct BasisBVHNode {
+  float Min[3], Max[3];
+  int Start;                    /* leaf: offset into List, node: second child */
+  int Count;                    /* leaf: number of primitives, node: 0 */
+};
+
+struct CBasisBVH {
+  std::vector<BasisBVHNode> Node;
+  std::vector<int> List;
+  std::vector<float> Box[6];    /* min x, y, z, max x, y, z (padded by 3) */
+};
+
+typedef struct {
+  const BasisBVHNode *Node;
+  const int *List;
+  const float *Box[6];
+  int Stack[BASIS_BVH_MAX_DEPTH + 4];
+  int Depth;
+  int LeafStart, LeafStop;      /* entries of the current leaf still to be tested */
+  int Hit[BASIS_BVH_BATCH + 1];
+} BasisBVHWalk;
+
+static void BasisBVHWalkInit(BasisBVHWalk * W, const CBasisBVH * bvh)
+{
+  int a;
+  W->Node = bvh->Node.data();
+  W->List = bvh->List.data();
+  for(a = 0; a < 6; a++)
+    W->Box[a] = bvh->Box[a].data();
+  W->Stack[0] = 0;
+  W->Depth = bvh->Node.empty() ? 0 : 1;
+  W->LeafStart = W->LeafStop = 0;
+}
+
+/* collect the accepted entries (bits of mask) of the group starting at j */
+static int BasisBVHCollect(BasisBVHWalk * W, int n, int j, int mask)
+{
+  int k;
+  for(k = 0; mask; k++, mask >>= 1)
+    if(mask & 0x1)
+      W->Hit[n++] = W->List[j + k];
+  return n;
+}
+
+
+/*========================================================================*/
+/* candidates among the next few entries of the current leaf for a ray
+ * heading down the negative Z axis through base[0], base[1] */
+static int BasisBVHFilterZ(BasisBVHWalk * W, const float *base,
+                           float z_min, float z_max)
+{
+  const float *const *box = W->Box;
+  int j = W->LeafStart;
+  int stop = std::min(W->LeafStop, j + BASIS_BVH_BATCH);
+  int n = 0;
+
+#ifdef __SSE2__
+  const __m128 x = _mm_set1_ps(base[0]);
+  const __m128 y = _mm_set1_ps(base[1]);
+  const __m128 lo = _mm_set1_ps(z_min);
+  const __m128 hi = _mm_set1_ps(z_max);
+  for(; j < stop; j += 4) {
+    __m128 m = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(box[0] + j), x),
+                          _mm_cmpge_ps(_mm_loadu_ps(box[3] + j), x));
+    m = _mm_and_ps(m, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(box[1] + j), y),
+                                 _mm_cmpge_ps(_mm_loadu_ps(box[4] + j), y)));
+    m = _mm_and_ps(m, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(box[2] + j), hi),
+                                 _mm_cmpge_ps(_mm_loadu_ps(box[5] + j), lo)));
+    int mask = _mm_movemask_ps(m);
+    if(stop - j < 4)
+      mask &= (1 << (stop - j)) - 1;
+    n = BasisBVHCollect(W, n, j, mask);
+  }
+#else
+  for(; j < stop; j++) {
+    if((box[0][j] <= base[0]) && (box[3][j] >= base[0]) &&
+       (box[1][j] <= base[1]) && (box[4][j] >= base[1]) &&
+       (box[2][j] <= z_max) && (box[5][j] >= z_min))
+      W->Hit[n++] = W->List[j];
+  }
+#endif
+
+  W->LeafStart = stop;
+  W->Hit[n] = -1;
+  return n;
+}
+
+
+/*========================================================================*/
+/* candidates among the next few entries of the current leaf for the ray
+ * base + t * dir, 0 <= t <= t_max */
+static int BasisBVHFilterRay(BasisBVHWalk * W, const float *base,
+                             const float *inv_dir, float t_max)
+{
+  const float *const *box = W->Box;
+  int j = W->LeafStart;
+  int stop = std::min(W->LeafStop, j + BASIS_BVH_BATCH);
+  int n = 0;
+
+#ifdef __SSE2__
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 t_hi = _mm_set1_ps(t_max);
+  for(; j < stop; j += 4) {
+    __m128 t_near = zero, t_far = t_hi;
+    int a;
+    for(a = 0; a < 3; a++) {
+      const __m128 b = _mm_set1_ps(base[a]);
+      const __m128 inv = _mm_set1_ps(inv_dir[a]);
+      __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(box[a] + j), b), inv);
+      __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(box[a + 3] + j), b), inv);
+      t_near = _mm_max_ps(t_near, _mm_min_ps(t0, t1));
+      t_far = _mm_min_ps(t_far, _mm_max_ps(t0, t1));
+    }
+    int mask = _mm_movemask_ps(_mm_cmple_ps(t_near, t_far));
+    if(stop - j < 4)
+      mask &= (1 << (stop - j)) - 1;
+    n = BasisBVHCollect(W, n, j, mask);
+  }
+#else
+  for(; j < stop; j++) {
+    float t_near = 0.0F, t_far = t_max;
+    int a;
+    for(a = 0; a < 3; a++) {
+      float t0 = (box[a][j] - base[a]) * inv_dir[a];
+      float t1 = (box[a + 3][j] - base[a]) * inv_dir[a];
+      t_near = std::max(t_near, std::min(t0, t1));
+      t_far = std::min(t_far, std::max(t0, t1));
+    }
+    if(t_near <= t_far)
+      W->Hit[n++] = W->List[j];
+  }
+#endif
+
+  W->LeafStart = stop;
+  W->Hit[n] = -1;
+  return n;
+}
+
+
+/*========================================================================*/
+/* next candidate list (front to back) along a ray heading down the
+ * negative Z axis through base[0], base[1], skipping what lies outside of
+ * [z_min, z_max] */
+static const int *BasisBVHNextZ(BasisBVHWalk * W, const float *base,
+                                float z_min, float z_max)
+{
+  const BasisBVHNode *node = W->Node;
+  for(;;) {
+    while(W->LeafStart < W->LeafStop) {
+      if(BasisBVHFilterZ(W, base, z_min, z_max))
+        return W->Hit;
+    }
+    if(!W->Depth)
+      return NULL;
+
+    int n = W->Stack[--W->Depth];
+    const BasisBVHNode *nd = node + n;
+    if((base[0] < nd->Min[0]) || (base[0] > nd->Max[0]) ||
+       (base[1] < nd->Min[1]) || (base[1] > nd->Max[1]) ||
+       (nd->Max[2] < z_min) || (nd->Min[2] > z_max))
+      continue;
+    if(nd->Count) {
+      W->LeafStart = nd->Start;
+      W->LeafStop = nd->Start + nd->Count;
+      continue;
+    }
+    /* push the farther child first */
+    if(node[n + 1].Max[2] >= node[nd->Start].Max[2]) {
+      W->Stack[W->Depth++] = nd->Start;
+      W->Stack[W->Depth++] = n + 1;
+    } else {
+      W->Stack[W->Depth++] = n + 1;
+      W->Stack[W->Depth++] = nd->Start;
+    }
+  }
+}
+
+
+/*========================================================================*/
+/* next candidate list (front to back) along the ray base + t * dir,
+ * 0 <= t <= t_max */
+static const int *BasisBVHNextRay(BasisBVHWalk * W, const float *base,
+                                  const float *dir, const float *inv_dir, float t_max)
+{
+  const BasisBVHNode *node = W->Node;
+  for(;;) {
+    while(W->LeafStart < W->LeafStop) {
+      if(BasisBVHFilterRay(W, base, inv_dir, t_max))
+        return W->Hit;
+    }
+    if(!W->Depth)
+      return NULL;
+
+    int n = W->Stack[--W->Depth];
+    const BasisBVHNode *nd = node + n;
+    float t_near = 0.0F, t_far = t_max;
+    int a;
+    for(a = 0; a < 3; a++) {
+      float t0 = (nd->Min[a] - base[a]) * inv_dir[a];
+      float t1 = (nd->Max[a] - base[a]) * inv_dir[a];
+      if(t0 > t1)
+        std::swap(t0, t1);
+      if(t0 > t_near)
+        t_near = t0;
+      if(t1 < t_far)
+        t_far = t1;
+    }
+    if(t_near > t_far)
+      continue;
+    if(nd->Count) {
+      W->LeafStart = nd->Start;
+      W->LeafStop = nd->Start + nd->Count;
+      continue;
+    }
+    {
+      /* push the farther child first (compare box centers along the ray) */
+      const BasisBVHNode *c1 = node + n + 1;
+      const BasisBVHNode *c2 = node + nd->Start;
+      float d = 0.0F;
+      for(a = 0; a < 3; a++)
+        d += (c1->Min[a] + c1->Max[a] - c2->Min[a] - c2->Max[a]) * dir[a];
+      if(d <= 0.0F) {
+        W->Stack[W->Depth++] = nd->Start;
+        W->Stack[W->Depth++] = n + 1;
+      } else {
+        W->Stack[W->Depth++] = n + 1;
+        W->Stack[W->Depth++] = nd->Start;
+      }
+    }
+  }
+}
+
+
 /*========================================================================*/
 
 #ifdef PROFILE_BASIS
@@ -1499,20 +1762,14 @@ int BasisHitPerspective(BasisCallRec * BC)
 {
   CBasis *BI = BC->Basis;
   MapType *map = BI->Map;
-  int iMin0 = map->iMin[0];
-  int iMin1 = map->iMin[1];
-  int iMin2 = map->iMin[2];
-  int iMax0 = map->iMax[0];
-  int iMax1 = map->iMax[1];
-  int iMax2 = map->iMax[2];
-  int a, b, c;
-
-  float iDiv = map->recipDiv;
-  float base0, base1, base2;
+  const CBasisBVH *bvh = BI->BVH;
+  int iMin0 = 0, iMin1 = 0, iMin2 = 0;
+  int iMax0 = 0, iMax1 = 0, iMax2 = 0;
+  int a = 0, b = 0, c = 0;
 
-  float min0 = map->Min[0] * iDiv;
-  float min1 = map->Min[1] * iDiv;
-  float min2 = map->Min[2] * iDiv;
+  float iDiv = 0.0F;
+  float base0 = 0.0F, base1 = 0.0F, base2 = 0.0F;
+  float min0 = 0.0F, min1 = 0.0F, min2 = 0.0F;
 
   int new_ray = !BC->pass;
   RayInfo *r = BC->rr;
@@ -1523,7 +1780,22 @@ int BasisHitPerspective(BasisCallRec * BC)
 
   CPrimitive *r_prim = NULL;
 
-  if(new_ray) {                 /* see if we can eliminate this ray right away using the mask */
+  if(!bvh) {
+    iMin0 = map->iMin[0];
+    iMin1 = map->iMin[1];
+    iMin2 = map->iMin[2];
+    iMax0 = map->iMax[0];
+    iMax1 = map->iMax[1];
+    iMax2 = map->iMax[2];
+
+    iDiv = map->recipDiv;
+
+    min0 = map->Min[0] * iDiv;
+    min1 = map->Min[1] * iDiv;
+    min2 = map->Min[2] * iDiv;
+  }
+
+  if(new_ray && !bvh) {         /* see if we can eliminate this ray right away using the mask */
 
     base0 = (r->base[0] * iDiv) - min0;
     base1 = (r->base[1] * iDiv) - min1;
@@ -1550,26 +1822,29 @@ int BasisHitPerspective(BasisCallRec * BC)
     int allow_break;
     int minIndex = -1;
 
-    float step0, step1, step2;
+    float step0 = 0.0F, step1 = 0.0F, step2 = 0.0F;
+    float inv_dir[3];
+    BasisBVHWalk walk;
     float back_dist = BC->back_dist;
 
     const float _0 = 0.0F, _1 = 1.0F;
     float r_tri1 = _0, r_tri2 = _0, r_dist, dist;       /* zero inits to suppress compiler warnings */
     float r_sphere0 = _0, r_sphere1 = _0, r_sphere2 = _0;
-    int h, *ip;
+    int h;
+    const int *ip;
     int excl_trans_flag;
     int *elist, local_iflag = false;
     int terminal = -1;
-    int *ehead = map->EHead;
-    int d1d2 = map->D1D2;
-    int d2 = map->Dim[2];
+    int *ehead = NULL;
+    int d1d2 = 0;
+    int d2 = 0;
     const int *vert2prim = BC->vert2prim;
     const float excl_trans = BC->excl_trans;
     const float BasisFudge0 = BC->fudge0;
     const float BasisFudge1 = BC->fudge1;
     int v2p;
     int i, ii;
-    int n_vert = BI->NVertex, n_eElem = map->NEElem;
+    int n_vert = BI->NVertex, n_eElem = 0;
     int except1 = BC->except1;
     int except2 = BC->except2;
     int check_interior_flag = BC->check_interior && !BC->pass;
@@ -1583,8 +1858,6 @@ int BasisHitPerspective(BasisCallRec * BC)
     float *BI_Radius2 = BI->Radius2;
     copy3f(r->base, vt);
 
-    elist = map->EList;
-
     r_dist = FLT_MAX;
 
     excl_trans_flag = (excl_trans != _0);
@@ -1596,96 +1869,125 @@ int BasisHitPerspective(BasisCallRec * BC)
 
     MapCacheReset(cache);
 
-    {                           /* take steps with a Z-size equil to the grid spacing */
-      float div = iDiv * (-MapGetDiv(BI->Map) / r->dir[2]);
-      step0 = r->dir[0] * div;
-      step1 = r->dir[1] * div;
-      step2 = r->dir[2] * div;
-    }
+    if(bvh) {
+      int k;
+      for(k = 0; k < 3; k++) {
+        /* avoid 0 * inf in the slab test */
+        float d = r->dir[k];
+        if(fabs(d) < R_SMALL8)
+          d = (d < _0) ? -R_SMALL8 : R_SMALL8;
+        inv_dir[k] = _1 / d;
+      }
+      BasisBVHWalkInit(&walk, bvh);
+    } else {
+      ehead = map->EHead;
+      elist = map->EList;
+      d1d2 = map->D1D2;
+      d2 = map->Dim[2];
+      n_eElem = map->NEElem;
+
+      {                         /* take steps with a Z-size equil to the grid spacing */
+        float div = iDiv * (-MapGetDiv(BI->Map) / r->dir[2]);
+        step0 = r->dir[0] * div;
+        step1 = r->dir[1] * div;
+        step2 = r->dir[2] * div;
+      }
 
-    base0 = (r->skip[0] * iDiv) - min0;
-    base1 = (r->skip[1] * iDiv) - min1;
-    base2 = (r->skip[2] * iDiv) - min2;
+      base0 = (r->skip[0] * iDiv) - min0;
+      base1 = (r->skip[1] * iDiv) - min1;
+      base2 = (r->skip[2] * iDiv) - min2;
+    }
 
     allow_break = false;
     while(1) {
-      int inside_code;
-      int clamped;
-
-      a = ((int) base0);
-      b = ((int) base1);
-      c = ((int) base2);
+      int inside_code = 1;
+      int clamped = false;
+
+      if(bvh) {
+        /* skip what lies beyond the current intersection or the back plane */
+        ip = BasisBVHNextRay(&walk, r->base, r->dir, inv_dir,
+                             (r_dist < back_dist) ? r_dist : back_dist);
+        if(!ip)
+          break;
+      } else {
+        a = ((int) base0);
+        b = ((int) base1);
+        c = ((int) base2);
 
-      inside_code = 1;
-      clamped = false;
+        inside_code = 1;
+        clamped = false;
 
-      a += MapBorder;
-      b += MapBorder;
-      c += MapBorder;
+        a += MapBorder;
+        b += MapBorder;
+        c += MapBorder;
 #define EDGE_ALLOWANCE 1
 
-      if(a < iMin0) {
-        if(((iMin0 - a) > EDGE_ALLOWANCE) && allow_break)
-          break;
-        else {
-          a = iMin0;
-          clamped = true;
-        }
-      } else if(a > iMax0) {
-        if(((a - iMax0) > EDGE_ALLOWANCE) && allow_break)
-          break;
-        else {
-          a = iMax0;
-          clamped = true;
-        }
-      }
-      if(b < iMin1) {
-        if(((iMin1 - b) > EDGE_ALLOWANCE) && allow_break)
-          break;
-        else {
-          b = iMin1;
-          clamped = true;
-        }
-      } else if(b > iMax1) {
-        if(((b - iMax1) > EDGE_ALLOWANCE) && allow_break)
-          break;
-        else {
-          b = iMax1;
-          clamped = true;
+        if(a < iMin0) {
+          if(((iMin0 - a) > EDGE_ALLOWANCE) && allow_break)
+            break;
+          else {
+            a = iMin0;
+            clamped = true;
+          }
+        } else if(a > iMax0) {
+          if(((a - iMax0) > EDGE_ALLOWANCE) && allow_break)
+            break;
+          else {
+            a = iMax0;
+            clamped = true;
+          }
         }
-      }
-      if(c < iMin2) {
-        if((iMin2 - c) > EDGE_ALLOWANCE)
-          break;
-        else {
-          c = iMin2;
-          clamped = true;
+        if(b < iMin1) {
+          if(((iMin1 - b) > EDGE_ALLOWANCE) && allow_break)
+            break;
+          else {
+            b = iMin1;
+            clamped = true;
+          }
+        } else if(b > iMax1) {
+          if(((b - iMax1) > EDGE_ALLOWANCE) && allow_break)
+            break;
+          else {
+            b = iMax1;
+            clamped = true;
+          }
         }
-      } else if(c > iMax2) {
-        if((c - iMax2) > EDGE_ALLOWANCE)
-          inside_code = 0;
-        else {
-          c = iMax2;
-          clamped = true;
+        if(c < iMin2) {
+          if((iMin2 - c) > EDGE_ALLOWANCE)
+            break;
+          else {
+            c = iMin2;
+            clamped = true;
+          }
+        } else if(c > iMax2) {
+          if((c - iMax2) > EDGE_ALLOWANCE)
+            inside_code = 0;
+          else {
+            c = iMax2;
+            clamped = true;
+          }
         }
       }
-      if(inside_code && (((a != last_a) || (b != last_b) || (c != last_c)))) {
+      if(bvh || (inside_code && (((a != last_a) || (b != last_b) || (c != last_c))))) {
         int new_min_index;
-        h = *(ehead + (d1d2 * a) + (d2 * b) + c);
 
         new_min_index = -1;
 
-        if(!clamped)            /* don't discard a ray until it has hit the objective at least once */
-          allow_break = true;
+        if(!bvh) {
+          h = *(ehead + (d1d2 * a) + (d2 * b) + c);
 
-        if((terminal > 0) && (last_c != c)) {
-          if(!terminal--)
-            break;
+          if(!clamped)          /* don't discard a ray until it has hit the objective at least once */
+            allow_break = true;
+
+          if((terminal > 0) && (last_c != c)) {
+            if(!terminal--)
+              break;
+          }
+          ip = ((h > 0) && (h < n_eElem)) ? elist + h : NULL;
         }
-        if((h > 0) && (h < n_eElem)) {
+        if(ip) {
           int do_loop;
 
-          ip = elist + h;
           last_a = a;
           i = *(ip++);
           last_b = b;
@@ -1993,24 +2295,27 @@ int BasisHitOrthoscopic(BasisCallRec * BC)
 {
   const float _0 = 0.0F, _1 = 1.0F;
   float oppSq, dist = _0, sph[3], vt[3], tri1, tri2;
-  int a, b, c, h, *ip;
+  int a = 0, b = 0, c = 0, h;
+  const int *ip;
   int excl_trans_flag;
   int check_interior_flag;
-  int *elist, local_iflag = false;
+  int *elist = NULL, local_iflag = false;
   float minusZ[3] = { 0.0F, 0.0F, -1.0F };
 
   CBasis *BI = BC->Basis;
   RayInfo *r = BC->rr;
+  const CBasisBVH *bvh = BI->BVH;
 
-  if(MapInsideXY(BI->Map, r->base, &a, &b, &c)) {
+  if(bvh || MapInsideXY(BI->Map, r->base, &a, &b, &c)) {
     int minIndex = -1;
     int v2p;
     int i, ii;
-    int *xxtmp;
+    int *xxtmp = NULL;
     int do_loop;
     int except1 = BC->except1;
     int except2 = BC->except2;
-    int n_vert = BI->NVertex, n_eElem = BI->Map->NEElem;
+    int n_vert = BI->NVertex, n_eElem = 0;
+    BasisBVHWalk walk;
     const int *vert2prim = BC->vert2prim;
     const float front = BC->front;
     const float back = BC->back;
@@ -2040,16 +2345,29 @@ int BasisHitOrthoscopic(BasisCallRec * BC)
 
     r_dist = FLT_MAX;
 
-    xxtmp = BI->Map->EHead + (a * BI->Map->D1D2) + (b * BI->Map->Dim[2]) + c;
+    if(bvh) {
+      BasisBVHWalkInit(&walk, bvh);
+    } else {
+      xxtmp = BI->Map->EHead + (a * BI->Map->D1D2) + (b * BI->Map->Dim[2]) + c;
+      elist = BI->Map->EList;
+      n_eElem = BI->Map->NEElem;
+    }
 
     MapCacheReset(cache);
 
-    elist = BI->Map->EList;
-
-    while(c >= MapBorder) {
-      h = *xxtmp;
-      if((h > 0) && (h < n_eElem)) {
-        ip = elist + h;
+    while(1) {
+      if(bvh) {
+        /* nodes behind the current intersection are skipped */
+        float z_min = (minIndex > -1) ? r->base[2] - r_dist : -FLT_MAX;
+        if(!(ip = BasisBVHNextZ(&walk, r->base, z_min, FLT_MAX)))
+          break;
+      } else {
+        if(c < MapBorder)
+          break;
+        h = *xxtmp;
+        ip = ((h > 0) && (h < n_eElem)) ? elist + h : NULL;
+      }
+      if(ip) {
         i = *(ip++);
         do_loop = ((i >= 0) && (i < n_vert));
         while(do_loop) {
@@ -2265,6 +2583,9 @@ int BasisHitOrthoscopic(BasisCallRec * BC)
       if(local_iflag)
         break;
 
+      if(bvh)
+        continue;
+
       /* we've processed all primitives associated with this voxel, 
          so if an intersection has been found which occurs in front of
          the next voxel, then we can stop */
@@ -2316,22 +2637,25 @@ int BasisHitShadow(BasisCallRec * BC)
   const float _1 = 1.0F;
   float oppSq, dist = _0, tri1, tri2;
   float sph[3], vt[3];
-  int h, *ip;
-  int a, b, c;
-  int *elist, local_iflag = false;
+  int h;
+  const int *ip;
+  int a = 0, b = 0, c = 0;
+  int *elist = NULL, local_iflag = false;
   float minusZ[3] = { 0.0F, 0.0F, -1.0F };
   /* local copies (eliminate these extra copies later on) */
 
   CBasis *BI = BC->Basis;
   RayInfo *r = BC->rr;
+  const CBasisBVH *bvh = BI->BVH;
 
-  if(MapInsideXY(BI->Map, r->base, &a, &b, &c)) {
+  if(bvh || MapInsideXY(BI->Map, r->base, &a, &b, &c)) {
     int minIndex = -1;
     int v2p;
     int i, ii;
-    int *xxtmp;
+    int *xxtmp = NULL;
+    BasisBVHWalk walk;
 
-    int n_vert = BI->NVertex, n_eElem = BI->Map->NEElem;
+    int n_vert = BI->NVertex, n_eElem = 0;
     int except1 = BC->except1;
     int except2 = BC->except2;
     const int *vert2prim = BC->vert2prim;
@@ -2362,17 +2686,29 @@ int BasisHitShadow(BasisCallRec * BC)
     r_trans = _1;
     r_dist = FLT_MAX;
 
-    xxtmp = BI->Map->EHead + (a * BI->Map->D1D2) + (b * BI->Map->Dim[2]) + c;
+    if(bvh) {
+      BasisBVHWalkInit(&walk, bvh);
+    } else {
+      xxtmp = BI->Map->EHead + (a * BI->Map->D1D2) + (b * BI->Map->Dim[2]) + c;
+      elist = BI->Map->EList;
+      n_eElem = BI->Map->NEElem;
+    }
 
     MapCacheReset(cache);
 
-    elist = BI->Map->EList;
-
-    while(c >= MapBorder) {
-      h = *xxtmp;
-      if((h > 0) && (h < n_eElem)) {
+    while(1) {
+      if(bvh) {
+        /* only what lies in front of the starting point can cast a shadow */
+        if(!(ip = BasisBVHNextZ(&walk, r->base, -FLT_MAX, r->base[2] + kR_SMALL4)))
+          break;
+      } else {
+        if(c < MapBorder)
+          break;
+        h = *xxtmp;
+        ip = ((h > 0) && (h < n_eElem)) ? elist + h : NULL;
+      }
+      if(ip) {
         int do_loop;
-        ip = elist + h;
         i = *(ip++);
         do_loop = ((i >= 0) && (i < n_vert));
         while(do_loop) {
@@ -2764,6 +3100,9 @@ int BasisHitShadow(BasisCallRec * BC)
       if(local_iflag)
         break;
 
+      if(bvh)
+        continue;
+
       /* we've processed all primitives associated with this voxel, 
          so if an intersection has been found which occurs in front of
          the next voxel, then we can stop */
@@ -2812,6 +3151,237 @@ int BasisHitShadow(BasisCallRec * BC)
   return (-1);
 }
 
+/*========================================================================*/
+/* BVH construction (binned surface area heuristic) */
+
+typedef struct {
+  float Min[3], Max[3];
+  float Center[3];
+  int Vert;
+} BasisBVHRef;
+
+static float BasisBVHArea(const float *mn, const float *mx)
+{
+  float d0 = mx[0] - mn[0], d1 = mx[1] - mn[1], d2 = mx[2] - mn[2];
+  return d0 * d1 + d1 * d2 + d2 * d0;
+}
+
+static void BasisBVHExtend(float *mn, float *mx, const float *v, float r)
+{
+  int a;
+  for(a = 0; a < 3; a++) {
+    if(mn[a] > v[a] - r)
+      mn[a] = v[a] - r;
+    if(mx[a] < v[a] + r)
+      mx[a] = v[a] + r;
+  }
+}
+
+static void BasisBVHBuildNode(CBasisBVH * bvh, BasisBVHRef * ref, int n, int depth)
+{
+  int node_index = bvh->Node.size();
+  float cmin[3], cmax[3];
+  float mn[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+  float mx[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+  int a, k;
+  int best_axis = -1, best_split = 0;
+  float best_cost = FLT_MAX;
+
+  bvh->Node.emplace_back();
+
+  copy3f(ref[0].Center, cmin);
+  copy3f(ref[0].Center, cmax);
+  for(a = 0; a < n; a++) {
+    BasisBVHExtend(mn, mx, ref[a].Min, 0.0F);
+    BasisBVHExtend(mn, mx, ref[a].Max, 0.0F);
+    BasisBVHExtend(cmin, cmax, ref[a].Center, 0.0F);
+  }
+  copy3f(mn, bvh->Node[node_index].Min);
+  copy3f(mx, bvh->Node[node_index].Max);
+
+  if((n > 2) && (depth < BASIS_BVH_MAX_DEPTH)) {
+    /* SAH cost of splitting between bins, relative to intersecting all */
+    for(k = 0; k < 3; k++) {
+      float bmin[BASIS_BVH_BINS][3], bmax[BASIS_BVH_BINS][3];
+      int bcnt[BASIS_BVH_BINS];
+      float right_area[BASIS_BVH_BINS];
+      int right_cnt[BASIS_BVH_BINS];
+      float lmin[3], lmax[3], scale;
+      int cnt = 0;
+
+      if(cmax[k] - cmin[k] < R_SMALL8)
+        continue;
+      scale = BASIS_BVH_BINS / (cmax[k] - cmin[k]);
+
+      for(a = 0; a < BASIS_BVH_BINS; a++) {
+        bcnt[a] = 0;
+        set3f(bmin[a], FLT_MAX, FLT_MAX, FLT_MAX);
+        set3f(bmax[a], -FLT_MAX, -FLT_MAX, -FLT_MAX);
+      }
+      for(a = 0; a < n; a++) {
+        int bin = std::min((int) ((ref[a].Center[k] - cmin[k]) * scale),
+                           BASIS_BVH_BINS - 1);
+        bcnt[bin]++;
+        BasisBVHExtend(bmin[bin], bmax[bin], ref[a].Min, 0.0F);
+        BasisBVHExtend(bmin[bin], bmax[bin], ref[a].Max, 0.0F);
+      }
+
+      set3f(lmin, FLT_MAX, FLT_MAX, FLT_MAX);
+      set3f(lmax, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+      for(a = BASIS_BVH_BINS - 1; a > 0; a--) {
+        if(bcnt[a]) {
+          BasisBVHExtend(lmin, lmax, bmin[a], 0.0F);
+          BasisBVHExtend(lmin, lmax, bmax[a], 0.0F);
+        }
+        cnt += bcnt[a];
+        right_cnt[a] = cnt;
+        right_area[a] = cnt ? BasisBVHArea(lmin, lmax) : 0.0F;
+      }
+
+      set3f(lmin, FLT_MAX, FLT_MAX, FLT_MAX);
+      set3f(lmax, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+      cnt = 0;
+      for(a = 0; a < BASIS_BVH_BINS - 1; a++) {
+        if(bcnt[a]) {
+          BasisBVHExtend(lmin, lmax, bmin[a], 0.0F);
+          BasisBVHExtend(lmin, lmax, bmax[a], 0.0F);
+        }
+        cnt += bcnt[a];
+        if(cnt && right_cnt[a + 1]) {
+          float cost = cnt * BasisBVHArea(lmin, lmax) +
+            right_cnt[a + 1] * right_area[a + 1];
+          if(cost < best_cost) {
+            best_cost = cost;
+            best_axis = k;
+            best_split = a + 1;
+          }
+        }
+      }
+    }
+
+    /* a leaf is cheaper when the split hardly separates anything (leaf
+     * entries are prefiltered in groups of four, hence the discount) */
+    if((best_axis >= 0) && (n <= BASIS_BVH_MAX_LEAF) &&
+       (best_cost >= 0.5F * n * BasisBVHArea(mn, mx)))
+      best_axis = -1;
+
+    if((best_axis < 0) && (n > BASIS_BVH_MAX_LEAF))
+      best_axis = -2;           /* identical centers, split in the middle */
+  }
+
+  if(best_axis == -1) {
+    BasisBVHNode *node = &bvh->Node[node_index];
+    node->Start = bvh->List.size();
+    node->Count = n;
+    for(a = 0; a < n; a++) {
+      bvh->List.push_back(ref[a].Vert);
+      for(k = 0; k < 3; k++) {
+        bvh->Box[k].push_back(ref[a].Min[k]);
+        bvh->Box[k + 3].push_back(ref[a].Max[k]);
+      }
+    }
+  } else {
+    int n_left;
+    if(best_axis < 0) {
+      n_left = n / 2;
+    } else {
+      const float c0 = cmin[best_axis];
+      const float scale = BASIS_BVH_BINS / (cmax[best_axis] - c0);
+      BasisBVHRef *mid = std::partition(ref, ref + n,
+          [&](const BasisBVHRef & rf) {
+            return std::min((int) ((rf.Center[best_axis] - c0) * scale),
+                            BASIS_BVH_BINS - 1) < best_split;
+          });
+      n_left = mid - ref;
+    }
+    BasisBVHBuildNode(bvh, ref, n_left, depth + 1);
+    bvh->Node[node_index].Start = bvh->Node.size();
+    bvh->Node[node_index].Count = 0;
+    BasisBVHBuildNode(bvh, ref + n_left, n - n_left, depth + 1);
+  }
+}
+
+static int BasisMakeBVH(CBasis * I, int *vert2prim, CPrimitive * prim)
+{
+  std::vector<BasisBVHRef> ref;
+  int a;
+
+  DeleteP(I->BVH);
+  I->BVH = new CBasisBVH();
+
+  /* one reference per primitive, with padded bounds in this basis */
+  for(a = 0; a < I->NVertex; a++) {
+    CPrimitive *prm = prim + vert2prim[a];
+    const float *v = I->Vertex + a * 3;
+    float pad;
+    BasisBVHRef rf;
+
+    if(prm->vert != a)
+      continue;
+
+    rf.Vert = a;
+    copy3f(v, rf.Min);
+    copy3f(v, rf.Max);
+
+    switch (prm->type) {
+    case cPrimTriangle:
+    case cPrimCharacter:
+      BasisBVHExtend(rf.Min, rf.Max, v + 3, 0.0F);
+      BasisBVHExtend(rf.Min, rf.Max, v + 6, 0.0F);
+      break;
+    case cPrimSphere:
+    case cPrimEllipsoid:
+      BasisBVHExtend(rf.Min, rf.Max, v, I->Radius[a]);
+      break;
+    case cPrimCylinder:
+    case cPrimSausage:
+    case cPrimCone:
+      {
+        float v2[3], r = I->Radius[a];
+        if((prm->type == cPrimCone) && (prm->r2 > r))
+          r = prm->r2;
+        scale3f(I->Normal + I->Vert2Normal[a] * 3, prm->l1, v2);
+        add3f(v, v2, v2);
+        BasisBVHExtend(rf.Min, rf.Max, v, r);
+        BasisBVHExtend(rf.Min, rf.Max, v2, r);
+      }
+      break;
+    }
+
+    /* generous padding for round-off in the intersection tests */
+    pad = 0.0F;
+    for(int k = 0; k < 3; k++)
+      pad = std::max(pad, std::max(fabsf(rf.Min[k]), fabsf(rf.Max[k])));
+    pad = kR_SMALL4 * (1.0F + pad);
+    for(int k = 0; k < 3; k++) {
+      rf.Min[k] -= pad;
+      rf.Max[k] += pad;
+      rf.Center[k] = (rf.Min[k] + rf.Max[k]) * 0.5F;
+    }
+    ref.push_back(rf);
+  }
+
+  if(!ref.empty()) {
+    I->BVH->Node.reserve(ref.size());
+    I->BVH->List.reserve(ref.size());
+    for(a = 0; a < 6; a++)
+      I->BVH->Box[a].reserve(ref.size() + 3);
+    BasisBVHBuildNode(I->BVH, ref.data(), ref.size(), 0);
+  }
+
+  /* the leaf filters read whole groups of four */
+  for(a = 0; a < 6; a++)
+    I->BVH->Box[a].resize(I->BVH->List.size() + 3, 0.0F);
+
+  PRINTFD(I->G, FB_Ray)
+    " BasisMakeBVH: %d primitives, %d nodes\n", (int) ref.size(),
+    (int) I->BVH->Node.size()
+    ENDFD;
+
+  return !I->G->Interrupt;
+}
+
+
 /*========================================================================*/
 int BasisMakeMap(CBasis * I, int *vert2prim, CPrimitive * prim, int n_prim,
 		 float *volume,
@@ -2847,6 +3417,9 @@ int BasisMakeMap(CBasis * I, int *vert2prim, CPrimitive * prim, int n_prim,
     I->Vertex[0], I->Vertex[1], I->Vertex[2]
     ENDFD;
 
+  if(I->UseBVH)
+    return BasisMakeBVH(I, vert2prim, prim);
+
   sep = I->MinVoxel;
   if(sep == _0) {
     remapMode = false;
@@ -3589,6 +4162,8 @@ int BasisInit(PyMOLGlobals * G, CBasis * I, int group_id)
     I->Precomp = VLACacheAlloc(I->G, float, 1, group_id, cCache_basis_precomp);
   CHECKOK(ok, I->Precomp);
   I->Map = NULL;
+  I->BVH = NULL;
+  I->UseBVH = false;
   I->NVertex = 0;
   I->NNormal = 0;
   return ok;
@@ -3602,6 +4177,7 @@ void BasisFinish(CBasis * I, int group_id)
     MapFree(I->Map);
     I->Map = NULL;
   }
+  DeleteP(I->BVH);
   VLACacheFreeP(I->G, I->Radius2, group_id, cCache_basis_radius2, false);
   VLACacheFreeP(I->G, I->Radius, group_id, cCache_basis_radius, false);
   VLACacheFreeP(I->G, I->Vertex, group_id, cCache_basis_vertex, false);
@@ -3643,3 +4219,44 @@ void BasisCylinderSausagePrecompute(float *dir, float *pre)
   pre[0] = dir[1] * ln;
   pre[1] = -dir[0] * ln;
 }
+
+
+/*========================================================================*/
+int BasisCacheInit(CBasis * I, MapCache * M, int group_id, int block_base)
+{
+  if(I->Map)
+    return MapCacheInit(M, I->Map, group_id, block_base);
+  /* BVH: the cache is indexed by primitive, and there are fewer of those than vertices */
+  return MapCacheInitSize(M, I->G, I->NVertex, group_id, block_base);
+}
+
+
+/*========================================================================*/
+size_t BasisGetMemory(CBasis * I)
+{
+  size_t size = 0;
+  if(I->Map) {
+    MapType *map = I->Map;
+    size_t n_voxel = map->Dim[0] * (size_t) map->Dim[1] * map->Dim[2];
+    size += sizeof(int) * n_voxel;      /* Head */
+    size += sizeof(int) * map->NVert;   /* Link */
+    if(map->EHead)
+      size += sizeof(int) * n_voxel;
+    if(map->EMask)
+      size += sizeof(int) * map->Dim[0] * (size_t) map->Dim[1];
+    size += sizeof(int) * map->NEElem;  /* EList */
+  }
+  if(I->BVH) {
+    size += sizeof(BasisBVHNode) * I->BVH->Node.size();
+    size += sizeof(int) * I->BVH->List.size();
+    size += sizeof(float) * 6 * I->BVH->Box[0].size();
+  }
+  return size;
+}
+
+
+/*========================================================================*/
+int BasisGetBVHNodes(CBasis * I)
+{
+  return I->BVH ? (int) I->BVH->Node.size() : 0;
+}
@@ -68,9 +68,13 @@ typedef struct {
   /* float wobble_param[3] eliminated to save space */
 } CPrimitive;                   /* currently 172 bytes -> appoximately 6.5 million primitives per gigabyte */
 
+struct CBasisBVH;
+
 typedef struct {
   PyMOLGlobals *G;
   MapType *Map;
+  CBasisBVH *BVH;               /* replaces Map when UseBVH is set */
+  int UseBVH;
   float *Vertex, *Normal, *Precomp;
   float *Radius, *Radius2, MaxRadius, MinVoxel;
   int *Vert2Normal;
@@ -141,6 +145,10 @@ void BasisGetTriangleFlatDotglePerspective(CBasis * I, RayInfo * r, int i);
 
 void BasisCylinderSausagePrecompute(float *dir, float *pre);
 
+int BasisCacheInit(CBasis * I, MapCache * M, int group_id, int block_base);
+size_t BasisGetMemory(CBasis * I);
+int BasisGetBVHNodes(CBasis * I);
+
 #define PROFILE_BASIS_OFF
 
 #endif
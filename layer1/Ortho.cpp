@@ -48,6 +48,7 @@ Z* -------------------------------------------------------------------
 #include"PyMOLOptions.h"
 #include"PyMOL.h"
 #include"Movie.h"
+#include"ThreadPool.h"
 #include "ShaderMgr.h"
 #include "Vector.h"
 #include "CGO.h"
@@ -547,6 +548,8 @@ void OrthoBusySlow(PyMOLGlobals * G, int progress, int total)
     " OrthoBusySlow-DEBUG: progress %d total %d\n", progress, total ENDFD;
   I->BusyStatus[0] = progress;
   I->BusyStatus[1] = total;
+  if(pymol::ThreadPool::isWorkerThread())
+    return;                     /* no GIL and no GL context */
   if(SettingGetGlobal_b(G, cSetting_show_progress) && (time_yet > 0.15F)) {
     if(PyMOL_GetBusy(G->PyMOL, false)) {        /* harmless race condition */
 #ifndef _PYMOL_NOPY
@@ -577,6 +580,8 @@ void OrthoBusyFast(PyMOLGlobals * G, int progress, int total)
     " OrthoBusyFast-DEBUG: progress %d total %d\n", progress, total ENDFD;
   I->BusyStatus[2] = progress;
   I->BusyStatus[3] = total;
+  if(pymol::ThreadPool::isWorkerThread())
+    return;                     /* no GIL and no GL context */
   if(finished || (SettingGetGlobal_b(G, cSetting_show_progress) && (time_yet > 0.15F))) {
     if(PyMOL_GetBusy(G->PyMOL, false) || finished) {        /* harmless race condition */
 #ifndef _PYMOL_NOPY
@@ -742,6 +742,29 @@ PyObject * WrapperObjectSubScript(PyObject *obj, PyObject *key){
   return ret;
 }
 
+/*
+ * Update fields which depend on atom property `id` after assigning it
+ */
+void PAtomPropertyChanged(PyMOLGlobals* G, AtomInfoType* ai, int id)
+{
+  switch (id) {
+  case ATOM_PROP_ELEM:
+    ai->protons = 0;
+    ai->vdw = 0;
+    AtomInfoAssignParameters(G, ai);
+    break;
+  case ATOM_PROP_RESV:
+    ai->inscode = '\0';
+    break;
+  case ATOM_PROP_SS:
+    ai->ssType[0] = toupper(ai->ssType[0]);
+    break;
+  case ATOM_PROP_FORMAL_CHARGE:
+    ai->chemFlag = false;
+    break;
+  }
+}
+
 /*
  * iterate-family namespace implementation: assignment
  *
@@ -882,22 +905,7 @@ int WrapperObjectAssignSubScript(PyObject *obj, PyObject *key, PyObject *val){
     }
 
     if (changed) {
-      switch (ap->id) {
-      case ATOM_PROP_ELEM:
-        wobj->atomInfo->protons = 0;
-        wobj->atomInfo->vdw = 0;
-        AtomInfoAssignParameters(wobj->G, wobj->atomInfo);
-        break;
-      case ATOM_PROP_RESV:
-        wobj->atomInfo->inscode = '\0';
-        break;
-      case ATOM_PROP_SS:
-        wobj->atomInfo->ssType[0] = toupper(wobj->atomInfo->ssType[0]);
-        break;
-      case ATOM_PROP_FORMAL_CHARGE:
-        wobj->atomInfo->chemFlag = false;
-        break;
-      }
+      PAtomPropertyChanged(G, wobj->atomInfo, ap->id);
     }
   } else {
     /* if not an atom property, then its a local variable, store it */
@@ -1331,6 +1339,10 @@ int PAlterAtomState(PyMOLGlobals * G, PyObject *expr_co, int read_only,
   PXDecRef(PyEval_EvalCode((PyObject*) expr_co, space, (PyObject*) wobj));
   Py_DECREF(wobj);
 
+  if(!read_only) {
+    obj->atomPropertiesChanged();
+  }
+
   if(PyErr_Occurred()) {
     result = false;
   }
@@ -229,24 +229,24 @@ inline PyObject * PConvToPyObject(const float * v, int n) {
   return PConvFloatArrayToPyList((float*)v, n);
 }
 
-template <class T>
-PyObject * PConvToPyObject(const std::vector<T> &v) {
-  int n = v.size();
-  PyObject * o = PyList_New(n);
+template <class T, std::size_t N>
+PyObject * PConvToPyObject(const std::array<T, N> &arr) {
+  PyObject * o = PyList_New(N);
 
-  for (int i = 0; i < n; ++i) {
-    PyList_SetItem(o, i, PConvToPyObject(v[i]));
+  for (int i = 0; i < N; ++i) {
+    PyList_SetItem(o, i, PConvToPyObject(arr[i]));
   }
 
   return o;
 }
 
-template <class T, std::size_t N>
-PyObject * PConvToPyObject(const std::array<T, N> &arr) {
-  PyObject * o = PyList_New(N);
+template <class T>
+PyObject * PConvToPyObject(const std::vector<T> &v) {
+  int n = v.size();
+  PyObject * o = PyList_New(n);
 
-  for (int i = 0; i < N; ++i) {
-    PyList_SetItem(o, i, PConvToPyObject(arr[i]));
+  for (int i = 0; i < n; ++i) {
+    PyList_SetItem(o, i, PConvToPyObject(v[i]));
   }
 
   return o;
@@ -342,6 +342,19 @@ inline bool PConvFromPyObject(PyMOLGlobals *, PyObject * obj, float * out) {
   return PConvPyListToFloatArrayInPlace(obj, out, 0);
 }
 
+template <class T, std::size_t N>
+bool PConvFromPyObject(PyMOLGlobals * G, PyObject * obj, std::array<T, N> &out) {
+  if (!PyList_Check(obj) || PyList_Size(obj) != N)
+    return false;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    if (!PConvFromPyObject(G, PyList_GET_ITEM(obj, i), out[i]))
+      return false;
+  }
+
+  return true;
+}
+
 template <class T>
 bool PConvFromPyObject(PyMOLGlobals * G, PyObject * obj, std::vector<T> &out) {
   if (PyBytes_Check(obj)) {
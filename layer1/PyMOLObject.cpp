@@ -38,6 +38,7 @@ Z* -------------------------------------------------------------------
 #include"CGO.h"
 #include"Selector.h"
 #include"vla.h"
+#include"TaskGraph.h"
 
 void ObjectPurgeSettings(CObject * I)
 {
@@ -1234,6 +1235,12 @@ CObject::~CObject()
 }
 
 
+/*========================================================================*/
+void CObject::addUpdateTasks(pymol::TaskGraph& graph)
+{
+  graph.add([this] { update(); });
+}
+
 /*========================================================================*/
 void ObjectUseColor(CObject * I)
 {
@@ -1307,6 +1314,16 @@ void ObjectStatePurge(CObjectState * I)
 {
 }
 
+/*
+ * The state matrix goes into the ray primitives, see SceneCountChange
+ */
+static void ObjectStateMatrixChanged(CObjectState * I)
+{
+  I->InvMatrix.clear();
+  if(I->G)
+    SceneCountChange(I->G);
+}
+
 int ObjectStateSetMatrix(CObjectState * I, double *matrix)
 {
   int ok = true;
@@ -1316,7 +1333,7 @@ int ObjectStateSetMatrix(CObjectState * I, double *matrix)
   } else {
     I->Matrix.clear();
   }
-  I->InvMatrix.clear();
+  ObjectStateMatrixChanged(I);
   return ok;
 }
 
@@ -1330,7 +1347,7 @@ void ObjectStateRightCombineMatrixR44d(CObjectState * I, double *matrix)
       right_multiply44d44d(I->Matrix.data(), matrix);
     }
   }
-  I->InvMatrix.clear();
+  ObjectStateMatrixChanged(I);
 }
 
 void ObjectStateLeftCombineMatrixR44d(CObjectState * I, double *matrix)
@@ -1343,7 +1360,7 @@ void ObjectStateLeftCombineMatrixR44d(CObjectState * I, double *matrix)
       left_multiply44d44d(matrix, I->Matrix.data());
     }
   }
-  I->InvMatrix.clear();
+  ObjectStateMatrixChanged(I);
 }
 
 void ObjectStateCombineMatrixTTT(CObjectState * I, float *matrix)
@@ -1359,7 +1376,7 @@ void ObjectStateCombineMatrixTTT(CObjectState * I, float *matrix)
       right_multiply44d44d(I->Matrix.data(), tmp);
     }
   }
-  I->InvMatrix.clear();
+  ObjectStateMatrixChanged(I);
 }
 
 double *ObjectStateGetMatrix(CObjectState * I)
@@ -1392,65 +1409,63 @@ void ObjectStateTransformMatrix(CObjectState * I, double *matrix)
   } else {
     right_multiply44d44d(I->Matrix.data(), matrix);
   }
-  I->InvMatrix.clear();
+  ObjectStateMatrixChanged(I);
 }
 
 int ObjectStatePushAndApplyMatrix(CObjectState * I, RenderInfo * info)
 {
-  PyMOLGlobals *G = I->G;
+  if(I->Matrix.empty())
+    return false;
   float matrix[16];
-  const double *i_matrix = nullptr;
-  if(!I->Matrix.empty()) {
-    i_matrix = I->Matrix.data();
+  copy44d44f(I->Matrix.data(), matrix);
+  return ObjectPushAndApplyMatrix(I->G, info, matrix);
+}
+
+void ObjectStatePopMatrix(CObjectState * I, RenderInfo * info)
+{
+  ObjectPopMatrix(I->G, info);
+}
+
+/**
+ * Push the current model view matrix (or ray TTT) and right-multiply it
+ * with `matrix` (row-major 4x4 homogenous). Undo with ObjectPopMatrix.
+ *
+ * @return false if nothing was pushed
+ */
+int ObjectPushAndApplyMatrix(PyMOLGlobals * G, RenderInfo * info, const float *matrix)
+{
+  if(info->ray) {
+    float ttt[16], ray_matrix[16];
+    RayPushTTT(info->ray);
+    RayGetTTT(info->ray, ttt);
+    convertTTTfR44f(ttt, ray_matrix);
+    right_multiply44f44f(ray_matrix, matrix);
+    RaySetTTT(info->ray, true, ray_matrix);
+    return true;
   }
-  int result = false;
-  if(i_matrix) {
-    if(info->ray) {
-      float ttt[16], matrix[16], i_matrixf[16];
-      RayPushTTT(info->ray);
-      RayGetTTT(info->ray, ttt);
-      convertTTTfR44f(ttt, matrix);
-      copy44d44f(i_matrix, i_matrixf);
-      right_multiply44f44f(matrix, i_matrixf);
-      RaySetTTT(info->ray, true, matrix);
-      result = true;
-    } else if(G->HaveGUI && G->ValidContext) {
-      matrix[0] = i_matrix[0];
-      matrix[1] = i_matrix[4];
-      matrix[2] = i_matrix[8];
-      matrix[3] = i_matrix[12];
-      matrix[4] = i_matrix[1];
-      matrix[5] = i_matrix[5];
-      matrix[6] = i_matrix[9];
-      matrix[7] = i_matrix[13];
-      matrix[8] = i_matrix[2];
-      matrix[9] = i_matrix[6];
-      matrix[10] = i_matrix[10];
-      matrix[11] = i_matrix[14];
-      matrix[12] = i_matrix[3];
-      matrix[13] = i_matrix[7];
-      matrix[14] = i_matrix[11];
-      matrix[15] = i_matrix[15];
-
-      ScenePushModelViewMatrix(G);
-      auto mvm = SceneGetModelViewMatrix(G);
-      MatrixMultiplyC44f(matrix, mvm);
+
+  if(G->HaveGUI && G->ValidContext) {
+    float gl_matrix[16];
+    transpose44f44f(matrix, gl_matrix);
+
+    ScenePushModelViewMatrix(G);
+    auto mvm = SceneGetModelViewMatrix(G);
+    MatrixMultiplyC44f(gl_matrix, mvm);
 
 #ifndef PURE_OPENGL_ES_2
-      if (ALWAYS_IMMEDIATE_OR(!info->use_shaders)) {
-        glLoadMatrixf(mvm);
-      }
+    if (ALWAYS_IMMEDIATE_OR(!info->use_shaders)) {
+      glLoadMatrixf(mvm);
+    }
 #endif
 
-      result = true;
-    }
+    return true;
   }
-  return result;
+
+  return false;
 }
 
-void ObjectStatePopMatrix(CObjectState * I, RenderInfo * info)
+void ObjectPopMatrix(PyMOLGlobals * G, RenderInfo * info)
 {
-  PyMOLGlobals *G = I->G;
   if(info->ray) {
     RayPopTTT(info->ray);
   } else if(G->HaveGUI && G->ValidContext) {
@@ -1461,7 +1476,7 @@ void ObjectStatePopMatrix(CObjectState * I, RenderInfo * info)
 void ObjectStateResetMatrix(CObjectState* I)
 {
   I->Matrix.clear();
-  I->InvMatrix.clear();
+  ObjectStateMatrixChanged(I);
 }
 
 PyObject *ObjectStateAsPyList(CObjectState * I)
@@ -30,6 +30,11 @@ Z* -------------------------------------------------------------------
 #include"Word.h"
 #include"vla.h"
 
+namespace pymol
+{
+class TaskGraph;
+}
+
 typedef char ObjectNameType[WordLength];
 
 enum cObject_t : int {
@@ -100,6 +105,13 @@ public:
   virtual ~CObject();
 
   virtual void update() {}
+
+  /**
+   * Add the work of update() to `graph`, as independent tasks where
+   * possible. The default is a single task which calls update().
+   */
+  virtual void addUpdateTasks(pymol::TaskGraph& graph);
+
   virtual void render(RenderInfo* info);
   virtual void invalidate(int rep, int level, int state) {}
   virtual int getNFrame() const { return 1; }
@@ -150,6 +162,8 @@ PyObject *ObjectStateAsPyList(CObjectState * I);
 int ObjectStateFromPyList(PyMOLGlobals * G, PyObject * list, CObjectState * I);
 int ObjectStatePushAndApplyMatrix(CObjectState * I, RenderInfo * info);
 void ObjectStatePopMatrix(CObjectState * I, RenderInfo * info);
+int ObjectPushAndApplyMatrix(PyMOLGlobals * G, RenderInfo * info, const float *matrix);
+void ObjectPopMatrix(PyMOLGlobals * G, RenderInfo * info);
 void ObjectStateRightCombineMatrixR44d(CObjectState * I, double *matrix);
 void ObjectStateLeftCombineMatrixR44d(CObjectState * I, double *matrix);
 void ObjectStateCombineMatrixTTT(CObjectState * I, float *matrix);
@@ -157,8 +171,6 @@ int ObjectMotionModify(CObject *I,int action, int index, int count,int target, i
 void ObjectMotionReinterpolate(CObject *I);
 int ObjectMotionGetLength(CObject *I);
 
-typedef struct _CObjectUpdateThreadInfo CObjectUpdateThreadInfo;
-
 #define cObjectTypeAll                    0
 #define cObjectTypeObjects                1
 #define cObjectTypeSelections             2
@@ -19,6 +19,10 @@ Z* -------------------------------------------------------------------
 #include"os_predef.h"
 #include"os_std.h"
 
+#include<algorithm>
+#include<atomic>
+#include<vector>
+
 #include"Base.h"
 #include"MemoryDebug.h"
 #include"Err.h"
@@ -40,6 +44,7 @@ Z* -------------------------------------------------------------------
 #include"PConv.h"
 #include"MyPNG.h"
 #include"CGO.h"
+#include"ThreadPool.h"
 
 #define SettingGetfv SettingGetGlobal_3fv
 
@@ -63,8 +68,44 @@ Z* -------------------------------------------------------------------
 typedef float float3[3];
 typedef float float4[4];
 
+/* Work for the ray tracing and antialiasing threads is split into small
+   screen tiles which are handed out on demand, so that threads which
+   are done with the cheap parts of the image help out with the
+   expensive ones (instead of waiting for the slowest thread). */
+
+#define RAY_TILE_SIZE 32
+#define RAY_ANTI_TILE_ROWS 8
+
+struct CRayTileQueue {
+  std::atomic<int> next {0};
+  std::atomic<int> done {0};
+  int n_tiles_x = 0, n_tiles = 0;
+  int tile_width, tile_height;
+  int x_start, y_start, x_stop, y_stop;
+  std::vector<float> tile_time;         /* seconds spent on each tile */
+  std::vector<double> thread_time;      /* seconds spent by each thread */
+
+  CRayTileQueue(int x_start_, int y_start_, int x_stop_, int y_stop_,
+                int tile_width_, int tile_height_, int n_thread)
+      : tile_width(tile_width_)
+      , tile_height(tile_height_)
+      , x_start(x_start_)
+      , y_start(y_start_)
+      , x_stop(x_stop_)
+      , y_stop(y_stop_)
+      , thread_time(n_thread)
+  {
+    if(x_stop > x_start && y_stop > y_start) {
+      n_tiles_x = (x_stop - x_start + tile_width - 1) / tile_width;
+      n_tiles = n_tiles_x * ((y_stop - y_start + tile_height - 1) / tile_height);
+    }
+    tile_time.resize(n_tiles);
+  }
+};
+
 struct _CRayThreadInfo {
   CRay *ray;
+  CRayTileQueue *tiles;
   int width, height;
   unsigned int *image;
   float front, back;
@@ -82,6 +123,8 @@ struct _CRayThreadInfo {
   int perspective;
   float fov, pos[3];
   float *depth;
+  int stride;           /* progressive: only trace every stride-th pixel... */
+  int done_stride;      /* ...except those traced by the previous pass */
   
   int bgWidth, bgHeight;
   void *bkrd_data; /* used for image-based background */
@@ -108,6 +151,7 @@ struct _CRayHashThreadInfo {
 };
 
 struct _CRayAntiThreadInfo {
+  CRayTileQueue *tiles;
   unsigned int *image;
   unsigned int *image_copy;
   unsigned int width, height;
@@ -141,6 +185,7 @@ float RayGetScreenVertexScale(CRay * I, float *v1)
 
   float vt[3];
   float ratio;
+  I->ViewDependent = true;
   RayApplyMatrix33(1, (float3 *) vt, I->ModelView, (float3 *) v1);
 
   if(I->Ortho) {
@@ -162,6 +207,8 @@ static void RayApplyContextToVertex(CRay * I, float *v)
       float tw;
       float th;
 
+      I->ViewDependent = true;
+
       if(I->AspRatio > 1.0F) {
         tw = I->AspRatio;
         th = 1.0F;
@@ -2879,62 +2926,119 @@ void RayProjectTriangle(CRay * I, RayInfo * r, float *light, float *v0, float *n
   }
 }
 
-#ifndef _PYMOL_NOPY
+/*
+ * Claim the next unprocessed tile. Returns the tile index and its pixel
+ * range, or -1 if all tiles have been handed out.
+ */
+static int RayTileNext(CRayTileQueue * Q, int *x_start, int *y_start,
+                       int *x_stop, int *y_stop)
+{
+  int tile = Q->next++;
+  if(tile >= Q->n_tiles)
+    return -1;
+  *x_start = Q->x_start + (tile % Q->n_tiles_x) * Q->tile_width;
+  *y_start = Q->y_start + (tile / Q->n_tiles_x) * Q->tile_height;
+  *x_stop = std::min(*x_start + Q->tile_width, Q->x_stop);
+  *y_stop = std::min(*y_start + Q->tile_height, Q->y_stop);
+  return tile;
+}
+
+static void RayTileDone(CRayTileQueue * Q, int tile, int phase, double seconds)
+{
+  Q->tile_time[tile] = (float) seconds;
+  Q->thread_time[phase] += seconds;
+  ++Q->done;
+}
+
+/*
+ * Fraction of finished tiles, scaled to `total` (for the busy indicator)
+ */
+static int RayTileProgress(const CRayTileQueue * Q, int total)
+{
+  if(!Q->n_tiles)
+    return total;
+  return (int) (((double) total * Q->done) / Q->n_tiles);
+}
+
+/*
+ * Report tile and thread timings, to reveal load imbalance
+ */
+static void RayTileReport(PyMOLGlobals * G, const CRayTileQueue * Q,
+                          const char *what)
+{
+  if(!Q->n_tiles || !Feedback(G, FB_Ray, FB_Blather))
+    return;
+
+  auto minmax_tile = std::minmax_element(Q->tile_time.begin(), Q->tile_time.end());
+  auto minmax_thread = std::minmax_element(Q->thread_time.begin(), Q->thread_time.end());
+  double sum = 0.0;
+  for(float t : Q->tile_time)
+    sum += t;
+
+  int slowest = minmax_tile.second - Q->tile_time.begin();
+
+  PRINTFB(G, FB_Ray, FB_Blather)
+    " Ray: %s %d tiles of %dx%d: min %.4f avg %.4f max %.4f sec (at %d,%d),"
+    " thread busy min %.3f max %.3f sec.\n", what, Q->n_tiles,
+    Q->tile_width, Q->tile_height, *minmax_tile.first, sum / Q->n_tiles,
+    *minmax_tile.second,
+    Q->x_start + (slowest % Q->n_tiles_x) * Q->tile_width,
+    Q->y_start + (slowest / Q->n_tiles_x) * Q->tile_height,
+    *minmax_thread.first, *minmax_thread.second ENDFB(G);
+}
+
+/*
+ * Progressive rendering traces a coarse grid of pixels first and refines
+ * it in later passes. Is pixel x, y left out of the current pass?
+ */
+static bool RayPixelSkipped(const CRayThreadInfo * T, int x, int y)
+{
+  if((T->stride > 1) && ((x % T->stride) || (y % T->stride)))
+    return true;
+  return T->done_stride && !(x % T->done_stride) && !(y % T->done_stride);
+}
+
+/*
+ * Preview of the final image size from the pixels traced so far, which
+ * are every stride-th pixel of the (possibly magnified) image.
+ */
+static void RayPreviewImage(const CRay * I, const unsigned int *image,
+                            int width, int mag, int stride, unsigned int *preview)
+{
+  int x, y;
+  for(y = 0; y < I->Height; y++) {
+    int yy = (mag > 1) ? (y + 1) * mag : y;
+    const unsigned int *src = image + width * (yy - yy % stride);
+    for(x = 0; x < I->Width; x++) {
+      int xx = (mag > 1) ? (x + 1) * mag : x;
+      *(preview++) = src[xx - xx % stride];
+    }
+  }
+}
+
 static void RayHashSpawn(CRayHashThreadInfo * Thread, int n_thread, int n_total)
 {
-  int blocked;
-  PyObject *info_list;
-  int a, c, n = 0;
   CRay *I = Thread->ray;
   PyMOLGlobals *G = I->G;
 
-  blocked = PAutoBlock(G);
-
   PRINTFB(I->G, FB_Ray, FB_Blather)
     " Ray: filling voxels with %d threads...\n", n_thread ENDFB(I->G);
-  while(n < n_total) {
-    c = n;
-    info_list = PyList_New(n_thread);
-    for(a = 0; a < n_thread; a++) {
-      if((c + a) < n_total) {
-        PyList_SetItem(
-            info_list, a, PyCapsule_New(Thread + c + a, nullptr, nullptr));
-      } else {
-        PyList_SetItem(info_list, a, PConvAutoNone(NULL));
-      }
-      n++;
-    }
-    PXDecRef(PYOBJECT_CALLMETHOD
-             (G->P_inst->cmd, "_ray_hash_spawn", "OO", info_list, G->P_inst->cmd));
-    Py_DECREF(info_list);
-  }
-  PAutoUnblock(G, blocked);
+
+  G->ThreadPool->run(n_total, n_thread,
+      [Thread](size_t a) { RayHashThread(Thread + a); });
 }
-#endif
 
-#ifndef _PYMOL_NOPY
 static void RayAntiSpawn(CRayAntiThreadInfo * Thread, int n_thread)
 {
-  int blocked;
-  PyObject *info_list;
-  int a;
   CRay *I = Thread->ray;
   PyMOLGlobals *G = I->G;
 
-  blocked = PAutoBlock(G);
-
   PRINTFB(I->G, FB_Ray, FB_Blather)
     " Ray: antialiasing with %d threads...\n", n_thread ENDFB(I->G);
-  info_list = PyList_New(n_thread);
-  for(a = 0; a < n_thread; a++) {
-    PyList_SetItem(info_list, a, PyCapsule_New(Thread + a, nullptr, nullptr));
-  }
-  PXDecRef(PYOBJECT_CALLMETHOD
-           (G->P_inst->cmd, "_ray_anti_spawn", "OO", info_list, G->P_inst->cmd));
-  Py_DECREF(info_list);
-  PAutoUnblock(G, blocked);
+
+  G->ThreadPool->run(n_thread, n_thread,
+      [Thread](size_t a) { RayAntiThread(Thread + a); });
 }
-#endif
 
 int RayHashThread(CRayHashThreadInfo * T)
 {
@@ -2955,30 +3059,17 @@ int RayHashThread(CRayHashThreadInfo * T)
   return 1;
 }
 
-#ifndef _PYMOL_NOPY
 static void RayTraceSpawn(CRayThreadInfo * Thread, int n_thread)
 {
-  int blocked;
-  PyObject *info_list;
-  int a;
   CRay *I = Thread->ray;
   PyMOLGlobals *G = I->G;
 
-  blocked = PAutoBlock(G);
-
   PRINTFB(I->G, FB_Ray, FB_Blather)
     " Ray: rendering with %d threads...\n", n_thread ENDFB(I->G);
-  info_list = PyList_New(n_thread);
-  for(a = 0; a < n_thread; a++) {
-    PyList_SetItem(info_list, a, PyCapsule_New(Thread + a, nullptr, nullptr));
-  }
-  PXDecRef(PYOBJECT_CALLMETHOD
-           (G->P_inst->cmd, "_ray_spawn", "OO", info_list, G->P_inst->cmd));
-  Py_DECREF(info_list);
-  PAutoUnblock(G, blocked);
 
+  G->ThreadPool->run(n_thread, n_thread,
+      [Thread](size_t a) { RayTraceThread(Thread + a); });
 }
-#endif
 
 static int find_edge(unsigned int *ptr, float *depth, unsigned int width,
                      int threshold, int back)
@@ -3171,7 +3262,7 @@ static void RayPrimGetColorRamped(PyMOLGlobals * G, float *matrix, RayInfo * r,
 int RayTraceThread(CRayThreadInfo * T)
 {
   CRay *I = T->ray;
-  int x, y, yy;
+  int x, y;
   float excess = 0.0F;
   float dotgle;
   float bright, direct_cmp, reflect_cmp, fc[4];
@@ -3219,8 +3310,7 @@ int RayTraceThread(CRayThreadInfo * T)
   float invWdthRange, vol0;
   float vol2;
   CBasis *bp1, *bp2;
-  int render_height;
-  int offset = 0;
+  int tile, tile_x_start, tile_y_start, tile_x_stop, tile_y_stop;
   BasisCallRec BasisCall[MAX_BASIS];
   float border_offset;
   int edge_sampling = false;
@@ -3458,12 +3548,6 @@ int RayTraceThread(CRayThreadInfo * T)
   else
     bp2 = NULL;
 
-  render_height = T->y_stop - T->y_start;
-
-  if(render_height) {
-    offset = (T->phase * render_height / T->n_thread);
-    offset = offset - (offset % T->n_thread) + T->phase;
-  }
   if((interior_color != -1) || I->CheckInterior) {
 
     if(interior_color != -1)
@@ -3494,7 +3578,7 @@ int RayTraceThread(CRayThreadInfo * T)
   BasisCall[0].fudge0 = BasisFudge0;
   BasisCall[0].fudge1 = BasisFudge1;
 
-  MapCacheInit(&BasisCall[0].cache, I->Basis[1].Map, T->phase, cCache_map_scene_cache);
+  BasisCacheInit(I->Basis + 1, &BasisCall[0].cache, T->phase, cCache_map_scene_cache);
 
   if(shadows && (n_basis > 2)) {
     int bc;
@@ -3513,8 +3597,8 @@ int RayTraceThread(CRayThreadInfo * T)
       BasisCall[bc].fudge0 = BasisFudge0;
       BasisCall[bc].fudge1 = BasisFudge1;
       BasisCall[bc].label_shadow_mode = label_shadow_mode;
-      MapCacheInit(&BasisCall[bc].cache, I->Basis[bc].Map, T->phase,
-                   cCache_map_shadow_cache);
+      BasisCacheInit(I->Basis + bc, &BasisCall[bc].cache, T->phase,
+                     cCache_map_shadow_cache);
     }
   }
 
@@ -3533,80 +3617,91 @@ int RayTraceThread(CRayThreadInfo * T)
 	back_mask = 0xFF000000;
     }
   }
-  for(yy = T->y_start; (yy < T->y_stop); yy++) {
-    float perc, bkrd[4] = {0.f, 0.f, 0.f, 1.f};
-    unsigned int bkrd_value = 0;
-    short isOutsideInY = 0;
+  while((tile = RayTileNext(T->tiles, &tile_x_start, &tile_y_start,
+                             &tile_x_stop, &tile_y_stop)) >= 0) {
+    double tile_start = UtilGetSeconds(I->G);
 
-    if(I->G->Interrupt)
-      break;
-
-    y = T->y_start + ((yy - T->y_start) + offset) % (render_height);    /* make sure threads write to different pages */
-    if (T->bkrd_data){
-      switch (bg_image_mode){
-      case 1: // isCentered
-	{
-	  float tmpy = floor(y - hpixely);
-	  isOutsideInY = (tmpy < 0.f || tmpy > (float)T->bgHeight);
-	  hl = fmodpos(tmpy, (float)T->bgHeight);
-	}
-	break;
-      case 2: // isTiled
-	hl = (float)T->bgHeight * (fmodpos((float)y, bg_image_tilesize[1])/bg_image_tilesize[1]);
-	break;
-      case 3: // isCenteredRepeated
-	hl = fmodpos(floor(y - hpixely), (float)T->bgHeight);
-	break;
-      default:
-	hl = y * hr;
-	break;
-      }
-    } else if (T->bkrd_is_gradient){
-      /* for RayTraceThread, y is from bottom to top */
-      perc = y/(float)T->height;
-      bkrd[0] = T->bkrd_bottom[0] + perc * (T->bkrd_top[0] - T->bkrd_bottom[0]);
-      bkrd[1] = T->bkrd_bottom[1] + perc * (T->bkrd_top[1] - T->bkrd_bottom[1]);
-      bkrd[2] = T->bkrd_bottom[2] + perc * (T->bkrd_top[2] - T->bkrd_bottom[2]);
-      bkrd[3] = 1.f;
-      if(T->ray->BigEndian){
-	bkrd_value = back_mask | 
-	  ((0xFF & ((unsigned int) (bkrd[0] * 255 + _p499))) << 24) |
-	  ((0xFF & ((unsigned int) (bkrd[1] * 255 + _p499))) << 16) |
-	  ((0xFF & ((unsigned int) (bkrd[2] * 255 + _p499))) << 8);
-      } else {
-	bkrd_value = back_mask | 
-	  ((0xFF & ((unsigned int) (bkrd[2] * 255 + _p499))) << 16) |
-	  ((0xFF & ((unsigned int) (bkrd[1] * 255 + _p499))) << 8) |
-	  ((0xFF & ((unsigned int) (bkrd[0] * 255 + _p499))));
-      }
-    } else {
-      bkrd_value = T->background;
-      bkrd[0] = T->bkrd_top[0];
-      bkrd[1] = T->bkrd_top[1];
-      bkrd[2] = T->bkrd_top[2];
-      if (orig_opaque_back){
-	bkrd[3] = 1.f;
-      } else {
-	bkrd[3] = 0.f;
-      }
-    }
-    if((!T->phase) && !(yy & 0xF)) {    /* don't slow down rendering too much */
+    if(!T->phase) {             /* progress is reported from the calling thread */
+      int prog = RayTileProgress(T->tiles, T->height);
       if(T->edging_cutoff) {
         if(T->edging) {
-          OrthoBusyFast(I->G, (int) (2.5F * T->height / 3 + 0.5F * y), 4 * T->height / 3);
+          OrthoBusyFast(I->G, (int) (2.5F * T->height / 3 + 0.5F * prog), 4 * T->height / 3);
         } else {
-          OrthoBusyFast(I->G, (int) (T->height / 3 + 0.5F * y), 4 * T->height / 3);
+          OrthoBusyFast(I->G, (int) (T->height / 3 + 0.5F * prog), 4 * T->height / 3);
         }
       } else {
-        OrthoBusyFast(I->G, T->height / 3 + y, 4 * T->height / 3);
+        OrthoBusyFast(I->G, T->height / 3 + prog, 4 * T->height / 3);
       }
     }
-    pixel = T->image + (T->width * y) + T->x_start;
 
-    if((y % T->n_thread) == T->phase) { /* this is my scan line */
+    for(y = tile_y_start; y < tile_y_stop; y++) {
+      float perc, bkrd[4] = {0.f, 0.f, 0.f, 1.f};
+      unsigned int bkrd_value = 0;
+      short isOutsideInY = 0;
+
+      if(I->G->Interrupt)
+        break;
+
+      if((T->stride > 1) && (y % T->stride))
+        continue;
+
+      if (T->bkrd_data){
+        switch (bg_image_mode){
+        case 1: // isCentered
+	  {
+	    float tmpy = floor(y - hpixely);
+	    isOutsideInY = (tmpy < 0.f || tmpy > (float)T->bgHeight);
+	    hl = fmodpos(tmpy, (float)T->bgHeight);
+	  }
+	  break;
+        case 2: // isTiled
+	  hl = (float)T->bgHeight * (fmodpos((float)y, bg_image_tilesize[1])/bg_image_tilesize[1]);
+	  break;
+        case 3: // isCenteredRepeated
+	  hl = fmodpos(floor(y - hpixely), (float)T->bgHeight);
+	  break;
+        default:
+	  hl = y * hr;
+	  break;
+        }
+      } else if (T->bkrd_is_gradient){
+        /* for RayTraceThread, y is from bottom to top */
+        perc = y/(float)T->height;
+        bkrd[0] = T->bkrd_bottom[0] + perc * (T->bkrd_top[0] - T->bkrd_bottom[0]);
+        bkrd[1] = T->bkrd_bottom[1] + perc * (T->bkrd_top[1] - T->bkrd_bottom[1]);
+        bkrd[2] = T->bkrd_bottom[2] + perc * (T->bkrd_top[2] - T->bkrd_bottom[2]);
+        bkrd[3] = 1.f;
+        if(T->ray->BigEndian){
+	  bkrd_value = back_mask | 
+	    ((0xFF & ((unsigned int) (bkrd[0] * 255 + _p499))) << 24) |
+	    ((0xFF & ((unsigned int) (bkrd[1] * 255 + _p499))) << 16) |
+	    ((0xFF & ((unsigned int) (bkrd[2] * 255 + _p499))) << 8);
+        } else {
+	  bkrd_value = back_mask | 
+	    ((0xFF & ((unsigned int) (bkrd[2] * 255 + _p499))) << 16) |
+	    ((0xFF & ((unsigned int) (bkrd[1] * 255 + _p499))) << 8) |
+	    ((0xFF & ((unsigned int) (bkrd[0] * 255 + _p499))));
+        }
+      } else {
+        bkrd_value = T->background;
+        bkrd[0] = T->bkrd_top[0];
+        bkrd[1] = T->bkrd_top[1];
+        bkrd[2] = T->bkrd_top[2];
+        if (orig_opaque_back){
+	  bkrd[3] = 1.f;
+        } else {
+	  bkrd[3] = 0.f;
+        }
+      }
+      pixel = T->image + (T->width * y) + tile_x_start;
+
       pixel_base[1] = ((y + 0.5F + border_offset) * invHgtRange) + vol2;
 
-      for(x = T->x_start; (x < T->x_stop); x++) {
+      for(x = tile_x_start; x < tile_x_stop; x++) {
+        if(RayPixelSkipped(T, x, y)) {
+          pixel++;
+          continue;
+        }
 	if (T->bkrd_data){
 	  // Need to compute background for every pixel if image-based
 	  unsigned char bkrd_uc[4];
@@ -4498,8 +4593,9 @@ int RayTraceThread(CRayThreadInfo * T)
       }                         /* end of for */
 
     }
-    /* end of if */
-  }                             /* end of for */
+
+    RayTileDone(T->tiles, tile, T->phase, UtilGetSeconds(I->G) - tile_start);
+  }
   /*  if(T->n_thread>1) 
      printf(" Ray: Thread %d: Complete.\n",T->phase+1); */
   MapCacheFree(&BasisCall[0].cache, T->phase, cCache_map_scene_cache);
@@ -4622,25 +4718,21 @@ int RayAntiThread(CRayAntiThreadInfo * T)
   unsigned int *pDst;
   /*   unsigned int m00FF=0x00FF,mFF00=0xFF00,mFFFF=0xFFFF; */
   int width;
-  int height;
-  int x, y, yy;
+  int x, y;
   unsigned int *p;
-  int offset = 0;
+  int tile, tile_x_start, tile_y_start, tile_x_stop, tile_y_stop;
   CRay *I = T->ray;
 
   OrthoBusyFast(I->G, 9, 10);
   width = (T->width / T->mag) - 2;
-  height = (T->height / T->mag) - 2;
 
   src_row_pixels = T->width;
 
-  offset = (T->phase * height) / T->n_thread;
-  offset = offset - (offset % T->n_thread) + T->phase;
-
-  for(yy = 0; yy < height; yy++) {
-    y = (yy + offset) % height; /* make sure threads write to different pages */
+  while((tile = RayTileNext(T->tiles, &tile_x_start, &tile_y_start,
+                             &tile_x_stop, &tile_y_stop)) >= 0) {
+    double tile_start = UtilGetSeconds(I->G);
 
-    if((y % T->n_thread) == T->phase) { /* this is my scan line */
+    for(y = tile_y_start; y < tile_y_stop; y++) {
       unsigned long c1, c2, c3, c4, a;
       unsigned char *c;
 
@@ -5503,6 +5595,8 @@ int RayAntiThread(CRayAntiThreadInfo * T)
 
       }
     }
+
+    RayTileDone(T->tiles, tile, T->phase, UtilGetSeconds(I->G) - tile_start);
   }
   return 1;
 }
@@ -5522,7 +5616,8 @@ int rayVolume = 0, rayWidth = 0, rayHeight = 0;
 
 /*========================================================================*/
 void RayRender(CRay * I, unsigned int *image, double timing,
-               float angle, int antialias, unsigned int *return_bg)
+               float angle, int antialias, unsigned int *return_bg,
+               const RayPreviewFn &preview)
 {
   int a, x, y;
   unsigned int *image_copy = NULL;
@@ -5554,6 +5649,9 @@ void RayRender(CRay * I, unsigned int *image, double timing,
   int volume;
   const char * bg_image_filename;
   int ok = true;
+  std::vector<unsigned int> preview_image;
+  bool use_preview = false;     /* interrupted, keep the last preview */
+  float prim_size = 0.0F;
 
   if(n_light > 10)
     n_light = 10;
@@ -5774,13 +5872,11 @@ void RayRender(CRay * I, unsigned int *image, double timing,
 
     if(I->PrimSizeCnt) {
       float factor = SettingGetGlobal_f(I->G, cSetting_ray_hint_camera);
-      I->PrimSize = I->PrimSize / (I->PrimSizeCnt * factor);
-      /*      printf("avg dist %8.7f\n",I->PrimSize); */
-    } else {
-      I->PrimSize = 0.0F;
+      prim_size = I->PrimSize / (I->PrimSizeCnt * factor);
+      /*      printf("avg dist %8.7f\n",prim_size); */
     }
     ok &= !I->G->Interrupt;
-    if (ok)
+    if (ok && !I->Expanded)     /* recycled rays still hold Basis[0] */
       ok &= RayExpandPrimitives(I);
     if (ok)
       ok &= RayTransformFirst(I, perspective, false);
@@ -5869,8 +5965,14 @@ void RayRender(CRay * I, unsigned int *image, double timing,
       }
     }
 
+    if(ok) {                    /* acceleration structure: voxel map or BVH */
+      int bc;
+      int use_bvh = SettingGetGlobal_b(I->G, cSetting_ray_bvh);
+      for(bc = 1; bc < I->NBasis; bc++)
+        I->Basis[bc].UseBVH = use_bvh;
+    }
+
     OrthoBusyFast(I->G, 4, 20);
-#ifndef _PYMOL_NOPY
     if(shadows && (n_thread > 1)) {     /* parallel execution */
 
       CRayHashThreadInfo *thread_info = pymol::calloc<CRayHashThreadInfo>(I->NBasis);
@@ -5902,7 +6004,7 @@ void RayRender(CRay * I, unsigned int *image, double timing,
       }
       thread_info[0].bytes = width * (unsigned int) height;
       thread_info[0].ray = I;   /* for compute box */
-      thread_info[0].size_hint = I->PrimSize;
+      thread_info[0].size_hint = prim_size;
       /* shadow map */
 
       {
@@ -5918,7 +6020,7 @@ void RayRender(CRay * I, unsigned int *image, double timing,
           thread_info[bc - 1].perspective = false;
           thread_info[bc - 1].front = _0;
           /* allowing these maps to be more fine helps performance */
-          thread_info[bc - 1].size_hint = I->PrimSize * factor;
+          thread_info[bc - 1].size_hint = prim_size * factor;
         }
       }
 
@@ -5928,19 +6030,15 @@ void RayRender(CRay * I, unsigned int *image, double timing,
 
       FreeP(thread_info);
     } else
-#endif
     if (ok){ 
-#ifdef _PYMOL_NOPY
-      n_thread = 1;          /* serial execution */
-#endif
       ok &= BasisMakeMap(I->Basis + 1, I->Vert2Prim, I->Primitive, I->NPrimitive,
-			 I->Volume, 0, cCache_ray_map, perspective, front, I->PrimSize);
+			 I->Volume, 0, cCache_ray_map, perspective, front, prim_size);
       if(ok && shadows) {
         int bc;
         float factor = SettingGetGlobal_f(I->G, cSetting_ray_hint_shadow);
         for(bc = 2; ok && bc < I->NBasis; bc++) {
           ok &= BasisMakeMap(I->Basis + bc, I->Vert2Prim, I->Primitive, I->NPrimitive,
-			     NULL, bc - 1, cCache_ray_map, false, _0, I->PrimSize * factor);
+			     NULL, bc - 1, cCache_ray_map, false, _0, prim_size * factor);
         }
       }
 
@@ -5963,18 +6061,28 @@ void RayRender(CRay * I, unsigned int *image, double timing,
     now = UtilGetSeconds(I->G) - timing;
 
     if (ok){
-      if(shadows) {
+      int n_map = shadows ? I->NBasis - 1 : 1;
+      double mb = 0.0;
+      int bc;
+      for(bc = 1; bc <= n_map; bc++)
+        mb += BasisGetMemory(I->Basis + bc) / 1048576.0;
+
+      if(I->Basis[1].BVH) {
+	PRINTFB(I->G, FB_Ray, FB_Blather)
+	  " Ray: bvh: %d nodes (%d maps), %4.2f MB, %4.2f sec.\n",
+	  BasisGetBVHNodes(I->Basis + 1), n_map, mb, now ENDFB(I->G);
+      } else if(shadows) {
 	PRINTFB(I->G, FB_Ray, FB_Blather)
-	  " Ray: voxels: [%4.2f:%dx%dx%d], [%4.2f:%dx%dx%d], %4.2f sec.\n",
+	  " Ray: voxels: [%4.2f:%dx%dx%d], [%4.2f:%dx%dx%d], %4.2f MB, %4.2f sec.\n",
 	  I->Basis[1].Map->Div, I->Basis[1].Map->Dim[0],
 	  I->Basis[1].Map->Dim[1], I->Basis[1].Map->Dim[2],
 	  I->Basis[2].Map->Div, I->Basis[2].Map->Dim[0],
-	  I->Basis[2].Map->Dim[2], I->Basis[2].Map->Dim[2], now ENDFB(I->G);
+	  I->Basis[2].Map->Dim[2], I->Basis[2].Map->Dim[2], mb, now ENDFB(I->G);
       } else {
 	PRINTFB(I->G, FB_Ray, FB_Blather)
-	  " Ray: voxels: [%4.2f:%dx%dx%d], %4.2f sec.\n",
+	  " Ray: voxels: [%4.2f:%dx%dx%d], %4.2f MB, %4.2f sec.\n",
 	  I->Basis[1].Map->Div, I->Basis[1].Map->Dim[0],
-	  I->Basis[1].Map->Dim[1], I->Basis[1].Map->Dim[2], now ENDFB(I->G);
+	  I->Basis[1].Map->Dim[1], I->Basis[1].Map->Dim[2], mb, now ENDFB(I->G);
       }
     }
     /* IMAGING */
@@ -6105,15 +6213,64 @@ void RayRender(CRay * I, unsigned int *image, double timing,
         rt[a].bkrd_data = I->bkgrd_data ? I->bkgrd_data->bits() : nullptr;
       }
 
-#ifndef _PYMOL_NOPY
-      if(n_thread > 1)
-        RayTraceSpawn(rt, n_thread);
-      else
-#endif
-        RayTraceThread(rt);
+      {
+        /* progressive rendering: coarse passes over every 2^n-th ... 2nd
+           pixel, each followed by a preview, then the remaining pixels.
+           The acceleration structures are shared by all passes. */
+        int n_preview = 0;
+        int pass;
+
+        if(preview) {
+          n_preview = SettingGetGlobal_i(I->G, cSetting_ray_progressive);
+          if(n_preview < 0)
+            n_preview = 0;
+          if(n_preview > 4)
+            n_preview = 4;
+        }
 
-      if(oversample_cutoff) {   /* perform edge oversampling, if requested */
+        for(pass = 0; pass <= n_preview; pass++) {
+          int stride = 1 << (n_preview - pass);
+          CRayTileQueue tiles(x_start, y_start, x_stop, y_stop,
+                              RAY_TILE_SIZE, RAY_TILE_SIZE, n_thread);
+          for(a = 0; a < n_thread; a++) {
+            rt[a].tiles = &tiles;
+            rt[a].stride = stride;
+            rt[a].done_stride = pass ? 2 * stride : 0;
+          }
+
+          if(n_thread > 1)
+            RayTraceSpawn(rt, n_thread);
+          else
+            RayTraceThread(rt);
+
+          RayTileReport(I->G, &tiles, (stride > 1) ? "previewed" : "rendered");
+
+          if(I->G->Interrupt)
+            break;
+
+          if(stride > 1) {
+            preview_image.resize(I->Width * (size_t) I->Height);
+            RayPreviewImage(I, image, width, mag, stride, preview_image.data());
+            preview(preview_image.data(), pass + 1, n_preview);
+
+            PRINTFB(I->G, FB_Ray, FB_Details)
+              " Ray: preview %d of %d (%dx%d blocks) after %4.2f sec.\n", pass + 1,
+              n_preview, stride, stride, UtilGetSeconds(I->G) - timing ENDFB(I->G);
+          }
+        }
+
+        for(a = 0; a < n_thread; a++) {
+          rt[a].stride = 0;
+          rt[a].done_stride = 0;
+        }
+
+        use_preview = I->G->Interrupt && !preview_image.empty();
+      }
+
+      if(oversample_cutoff && !use_preview) {   /* perform edge oversampling, if requested */
         unsigned int *edging;
+        CRayTileQueue tiles(x_start, y_start, x_stop, y_stop,
+                            RAY_TILE_SIZE, RAY_TILE_SIZE, n_thread);
 
         edging = CacheAlloc(I->G, unsigned int, buffer_size, 0, cCache_ray_edging_buffer);
 
@@ -6121,22 +6278,23 @@ void RayRender(CRay * I, unsigned int *image, double timing,
 
         for(a = 0; a < n_thread; a++) {
           rt[a].edging = edging;
+          rt[a].tiles = &tiles;
         }
 
-#ifndef _PYMOL_NOPY
         if(n_thread > 1)
           RayTraceSpawn(rt, n_thread);
         else
-#endif
           RayTraceThread(rt);
 
+        RayTileReport(I->G, &tiles, "oversampled");
+
         CacheFreeP(I->G, edging, 0, cCache_ray_edging_buffer, false);
       }
       FreeP(rt);
     }
   }
 
-  if(ok && depth && ray_trace_mode) {
+  if(ok && depth && ray_trace_mode && !use_preview) {
     float *delta = pymol::malloc<float>(3 * width * height);
     int x, y;
     ErrChkPtr(I->G, delta);
@@ -6503,8 +6661,12 @@ void RayRender(CRay * I, unsigned int *image, double timing,
   if(ok && antialias > 1) {
     /* now spawn threads as needed */
     CRayAntiThreadInfo *rt = pymol::calloc<CRayAntiThreadInfo>(n_thread);
+    int anti_width = (width / mag) - 2;
+    CRayTileQueue tiles(0, 0, anti_width, (height / mag) - 2,
+                        anti_width, RAY_ANTI_TILE_ROWS, n_thread);
 
     for(a = 0; a < n_thread; a++) {
+      rt[a].tiles = &tiles;
       rt[a].width = width;
       rt[a].height = height;
       rt[a].image = image;
@@ -6515,17 +6677,24 @@ void RayRender(CRay * I, unsigned int *image, double timing,
       rt[a].ray = I;
     }
 
-#ifndef _PYMOL_NOPY
-    if(n_thread > 1)
-      RayAntiSpawn(rt, n_thread);
-    else
-#endif
-      RayAntiThread(rt);
+    if(!use_preview) {
+      if(n_thread > 1)
+        RayAntiSpawn(rt, n_thread);
+      else
+        RayAntiThread(rt);
+      RayTileReport(I->G, &tiles, "antialiased");
+    }
     FreeP(rt);
     CacheFreeP(I->G, image, 0, cCache_ray_antialias_buffer, false);
     image = image_copy;
   }
 
+  if(ok && use_preview) {
+    PRINTFB(I->G, FB_Ray, FB_Details)
+      " Ray: interrupted, keeping the preview.\n" ENDFB(I->G);
+    std::copy(preview_image.begin(), preview_image.end(), image);
+  }
+
   PRINTFD(I->G, FB_Ray)
     " RayRender: n_hit %d\n", n_hit ENDFD;
 #ifdef PROFILE_BASIS
@@ -7640,8 +7809,10 @@ void RayPrepare(CRay * I, float v0, float v1, float v2,
   I->PixelRatio = pixel_ratio;
   I->Magnified = magnified;
   I->FrontBackRatio = front_back_ratio;
-  I->PrimSizeCnt = 0;
-  I->PrimSize = 0.0;
+  if(!I->Expanded) {            /* recycled rays keep their primitive statistics */
+    I->PrimSizeCnt = 0;
+    I->PrimSize = 0.0;
+  }
   I->Fov = fov;
   copy3f(pos, I->Pos);
 
@@ -7690,6 +7861,32 @@ void RayRelease(CRay * I)
 }
 
 
+/*========================================================================*/
+/*
+ * Drops everything derived from the camera (transformed bases, maps) but
+ * keeps the model space primitives, so that the ray can go through
+ * RayPrepare and RayRender again for a frame which only differs by its
+ * view matrix. Returns false if the primitives can't be reused, e.g. for
+ * labels which face the camera or an interrupted render.
+ */
+int RayRecycle(CRay * I)
+{
+  int a;
+
+  if(I->ViewDependent || I->G->Interrupt || I->NBasis < 2)
+    return false;
+
+  for(a = 1; a < I->NBasis; a++) {
+    BasisFinish(&I->Basis[a], a);
+  }
+  BasisInit(I->G, I->Basis + 1, 1);
+  I->NBasis = 2;
+  I->Expanded = true;
+  CharacterSetRetention(I->G, false);
+  return true;
+}
+
+
 /*========================================================================*/
 void RayFree(CRay * I)
 {
@@ -7800,6 +7997,7 @@ static void RayTransformInverseNormals33(unsigned int n, float3 * q, const float
   }
 }
 void RayGetScreenVertex(CRay * I, float *v, float *res){
+  I->ViewDependent = true;
   MatrixTransformC44f4f(I->ModelView, v, res);
   normalize4f(res);
 }
@@ -7812,6 +8010,7 @@ void RayAdjustZtoScreenZ(CRay * ray, float *pos, float zarg){
   float zInPreProj = -(z * clipRange + FrontSafe);
   float pos4[4], tpos[4], npos[4];
   float InvModMatrix[16];
+  ray->ViewDependent = true;
   copy3f(pos, pos4);
   pos4[3] = 1.f;
   MatrixTransformC44f4f(ray->ModelView, pos4, tpos);
@@ -7887,5 +8086,6 @@ float RayGetScaledAllAxesAtPoint(CRay * I, float *pt, float *xn, float *yn, floa
   return v_scale;
 }
 float* RayGetProMatrix(CRay * I){
+  I->ViewDependent = true;
   return I->ProMatrix;
 }
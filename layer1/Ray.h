@@ -17,6 +17,7 @@ Z* -------------------------------------------------------------------
 #ifndef _H_Ray
 #define _H_Ray
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -31,6 +32,11 @@ typedef struct _CRayAntiThreadInfo CRayAntiThreadInfo;
 typedef struct _CRayHashThreadInfo CRayHashThreadInfo;
 typedef struct _CRayThreadInfo CRayThreadInfo;
 
+/* progressive rendering (ray_progressive): receives a full size preview
+   image after each coarse pass (pass counts from 1 up to n_pass) */
+typedef std::function<void(const unsigned int *preview, int pass, int n_pass)>
+  RayPreviewFn;
+
 CRay *RayNew(PyMOLGlobals * G, int antialias);
 void RayFree(CRay * I);
 void RayPrepare(CRay * I, float v0, float v1, float v2,
@@ -41,7 +47,9 @@ void RayPrepare(CRay * I, float v0, float v1, float v2,
                 float pixel_scale, int ortho, float pixel_ratio,
                 float back_ratio, float magnified);
 void RayRender(CRay * I, unsigned int *image,
-               double timing, float angle, int antialias, unsigned int *return_bg);
+               double timing, float angle, int antialias, unsigned int *return_bg,
+               const RayPreviewFn &preview = nullptr);
+int RayRecycle(CRay * I);
 void RayRenderPOV(CRay * I, int width, int height, char **headerVLA,
                   char **charVLA, float front, float back, float fov, float angle,
                   int antialias);
@@ -170,6 +178,8 @@ struct _CRay {
   double PrimSize;
   int PrimSizeCnt;
   float Fov, Pos[3];
+  int ViewDependent;            /* primitives were placed relative to the camera */
+  int Expanded;                 /* Basis[0] already holds the primitives */
   std::shared_ptr<pymol::Image> bkgrd_data;
 
 private:
@@ -58,6 +58,8 @@ Z* -------------------------------------------------------------------
 #include"PConv.h"
 #include"ScrollBar.h"
 #include "ShaderMgr.h"
+#include "TaskGraph.h"
+#include "ThreadPool.h"
 
 #ifdef _PYMOL_OPENVR
 #include"OpenVRMode.h"
@@ -1930,11 +1932,14 @@ float SceneGetGridAspectRatio(PyMOLGlobals * G){
     (float)(I->grid.cur_viewport_size[0] / (float)I->grid.cur_viewport_size[1]);
 }
 
-int SceneCopyExternal(PyMOLGlobals * G, int width, int height,
-                      int rowbytes, unsigned char *dest, int mode)
+/*
+ * Copy `image` (of size width x height) to `dest`, see SceneCopyExternal
+ * for `mode`. Returns false if the size doesn't match.
+ */
+static int SceneCopyImageExternal(PyMOLGlobals * G, const pymol::Image * image,
+                                  int width, int height, int rowbytes,
+                                  unsigned char *dest, int mode)
 {
-  auto image = SceneImagePrepare(G, false);
-  CScene *I = G->Scene;
   int result = false;
   int i, j;
   int premultiply_alpha = true;
@@ -1965,9 +1970,9 @@ int SceneCopyExternal(PyMOLGlobals * G, int width, int height,
      printf("%d %d %d %d\n",I->Image->width,width,I->Image->height,height);
      } */
 
-  if(image && I->Image && (I->Image->getWidth() == width) && (I->Image->getHeight() == height)) {
+  if(image && (image->getWidth() == width) && (image->getHeight() == height)) {
     for(i = 0; i < height; i++) {
-      unsigned char *src = image->bits() + ((height - 1) - i) * width * 4;
+      const unsigned char *src = image->bits() + ((height - 1) - i) * width * 4;
       unsigned char *dst;
       if(mode & 0x4) {
         dst = dest + (height - (i + 1)) * (rowbytes);
@@ -2005,12 +2010,47 @@ int SceneCopyExternal(PyMOLGlobals * G, int width, int height,
       }
     }
     result = true;
-  } else {
+  }
+  return (result);
+}
+
+int SceneCopyExternal(PyMOLGlobals * G, int width, int height,
+                      int rowbytes, unsigned char *dest, int mode)
+{
+  CScene *I = G->Scene;
+  // keep the image alive in case a ray tracing preview replaces it
+  std::unique_lock<std::mutex> lock(I->ImageMutex);
+  auto image = SceneImagePrepare(G, false);
+  auto image_ref = I->Image;
+  lock.unlock();
+  int result = image_ref && SceneCopyImageExternal(G, image, width, height,
+                                                   rowbytes, dest, mode);
+  if(!result) {
     printf("image or size mismatch\n");
   }
   return (result);
 }
 
+/**
+ * Like SceneCopyExternal, but only copies a ray traced image (or the latest
+ * preview of a progressive ray trace) and doesn't need the API lock, so it
+ * may be called from another thread while ray tracing is in progress.
+ * Returns false if there is no ray traced image of the given size.
+ */
+int SceneCopyRayImageExternal(PyMOLGlobals * G, int width, int height,
+                              int rowbytes, unsigned char *dest, int mode)
+{
+  CScene *I = G->Scene;
+  std::shared_ptr<pymol::Image> image_ref;
+  {
+    std::lock_guard<std::mutex> lock(I->ImageMutex);
+    if(I->CopyType == true)
+      image_ref = I->Image;
+  }
+  return image_ref && SceneCopyImageExternal(G, image_ref.get(), width,
+                                             height, rowbytes, dest, mode);
+}
+
 bool ScenePNG(PyMOLGlobals * G, const char *png, float dpi, int quiet,
              int prior_only, int format)
 {
@@ -2235,11 +2275,21 @@ void SceneRovingDirty(PyMOLGlobals * G)
 }
 
 
+/*========================================================================*/
+void SceneCountChange(PyMOLGlobals * G)
+{
+  CScene *I = G->Scene;
+  if(I)
+    I->ChangeCount++;
+}
+
+
 /*========================================================================*/
 void SceneChanged(PyMOLGlobals * G)
 {
   CScene *I = G->Scene;
   I->ChangedFlag = true;
+  I->ChangeCount++;
   SceneInvalidateCopy(G, false);
   SceneDirty(G);
   SeqChanged(G);
@@ -5959,6 +6009,7 @@ void SceneFree(PyMOLGlobals * G)
   I->NonGadgetObjs.clear();
 
   ScenePurgeImage(G);
+  SceneRayCacheFree(G);
   CGOFree(G->DebugCGO);
   delete G->Scene;
 }
@@ -6424,44 +6475,6 @@ int SceneRovingCheckDirty(PyMOLGlobals * G)
   return (I->RovingDirtyFlag);
 }
 
-struct _CObjectUpdateThreadInfo {
-  CObject *obj;
-};
-
-void SceneObjectUpdateThread(CObjectUpdateThreadInfo * T)
-{
-  if(T->obj) {
-    T->obj->update();
-  }
-}
-
-#ifndef _PYMOL_NOPY
-static void SceneObjectUpdateSpawn(PyMOLGlobals * G, CObjectUpdateThreadInfo * Thread,
-                                   int n_thread, int n_total)
-{
-  if(n_total == 1) {
-    SceneObjectUpdateThread(Thread);
-  } else if(n_total) {
-    int blocked;
-    PyObject *info_list;
-    int a, n = 0;
-    blocked = PAutoBlock(G);
-
-    PRINTFB(G, FB_Scene, FB_Blather)
-      " Scene: updating objects with %d threads...\n", n_thread ENDFB(G);
-    info_list = PyList_New(n_total);
-    for(a = 0; a < n_total; a++) {
-      PyList_SetItem(info_list, a, PyCapsule_New(Thread + a, nullptr, nullptr));
-      n++;
-    }
-    PXDecRef(PYOBJECT_CALLMETHOD
-             (G->P_inst->cmd, "_object_update_spawn", "Oi", info_list, n_thread));
-    Py_DECREF(info_list);
-    PAutoUnblock(G, blocked);
-  }
-}
-#endif
-
 static void SceneStencilCheck(PyMOLGlobals *G) 
 {
   CScene *I = G->Scene;
@@ -6502,6 +6515,15 @@ void SceneUpdate(PyMOLGlobals * G, int force)
   if(defer_builds_mode == 0) {
     if(SettingGetGlobal_i(G, cSetting_draw_mode) == -2) {
       defer_builds_mode = 1;
+    } else {
+      /* streamed trajectories only have the current state resident */
+      for (auto& obj : I->Obj) {
+        if(obj->type == cObjectMolecule &&
+           static_cast<ObjectMolecule*>(obj)->TrajStream) {
+          defer_builds_mode = 1;
+          break;
+        }
+      }
     }
   }
 
@@ -6520,68 +6542,30 @@ void SceneUpdate(PyMOLGlobals * G, int force)
       }
 
       {
-#ifndef _PYMOL_NOPY
         int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
         int multithread = SettingGetGlobal_i(G, cSetting_async_builds);
-        if(multithread && (n_thread > 1)) {
-          int min_start = -1;
-          int max_stop = -1;
-          int n_obj = 0;
-          for (auto& obj : I->Obj) {
-            int start = 0;
-            n_obj++;
-            int stop = obj->getNFrame();
-	    /* set start/stop to define the range for this object
-	     * depending upon various build settings */
-            ObjectAdjustStateRebuildRange(obj, &start, &stop);
-            if(min_start < 0) {
-              min_start = start;
-              max_stop = stop;
-            } else {
-              if(min_start > start)
-                min_start = start;
-              if(max_stop < stop)
-                max_stop = stop;
-            }
-          }
-
-          int n_frame = max_stop - min_start;
 
-          if(n_frame > n_thread) {
-            n_thread = 1;
-            /* prevent n_thread * n_thread -- only multithread within
-               individual object states (typically more balanced) */
-          } else if(n_frame > 1) {
-            n_thread = n_thread / n_frame;
+        if(multithread && (n_thread > 1)) {
+          /* multi-threaded geometry update: all objects and their states
+             (with dependencies) as one task graph */
+          pymol::TaskGraph graph;
+          for (auto& NonGadgetObj : I->NonGadgetObjs) {
+            NonGadgetObj->addUpdateTasks(graph);
           }
 
-          if(n_thread < 1)
-            n_thread = 1;
-        }
+          PRINTFB(G, FB_Scene, FB_Blather)
+            " Scene: updating %d tasks with %d threads...\n",
+            int(graph.size()), n_thread ENDFB(G);
 
-	/* Note: we might want to optimize this by doing multi-threaded updates
-	   for all objects. */
-        if(multithread && (n_thread > 1)) {
-          /* multi-threaded geometry update */
-          int cnt = I->NonGadgetObjs.size();
-
-          if(cnt) {
-            CObjectUpdateThreadInfo *thread_info = pymol::malloc<CObjectUpdateThreadInfo>(cnt);
-            if(thread_info) {
-              cnt = 0;
-              for (auto& NonGadgetObj : I->NonGadgetObjs) {
-                thread_info[cnt++].obj = NonGadgetObj;
-              }
-              SceneObjectUpdateSpawn(G, thread_info, n_thread, cnt);
-              FreeP(thread_info);
-            }
-          }
-        } else
-#endif
+          graph.run(*G->ThreadPool, n_thread);
+          SceneInvalidatePicking(G);
+          SceneInvalidate(G);
+        } else {
           /* single-threaded update */
           for (auto& obj : I->Obj) {
             obj->update();
           }
+        }
       }
       PyMOL_SetBusy(G->PyMOL, false);   /*  race condition -- may need to be fixed */
     } else { /* defer builds mode == 5 -- for now, only update non-molecular objects */
@@ -69,6 +69,7 @@ int SceneGetButtonMargin(PyMOLGlobals * G);
 void SceneDirty(PyMOLGlobals * G);      /* scene dirty, but leave the overlay if one exists */
 void SceneInvalidate(PyMOLGlobals * G); /* scene dirty and remove the overlay */
 void SceneChanged(PyMOLGlobals * G);    /* update 3D objects */
+void SceneCountChange(PyMOLGlobals * G);        /* new generation, no redraw */
 
 int SceneCountFrames(PyMOLGlobals * G);
 int SceneGetNFrame(PyMOLGlobals * G, int *has_movie=nullptr);
@@ -102,6 +103,8 @@ bool ScenePNG(PyMOLGlobals * G, const char *png, float dpi, int quiet,
              int prior_only, int format);
 int SceneCopyExternal(PyMOLGlobals * G, int width, int height, int rowbytes,
                       unsigned char *dest, int mode);
+int SceneCopyRayImageExternal(PyMOLGlobals * G, int width, int height,
+                              int rowbytes, unsigned char *dest, int mode);
 
 void SceneResetMatrix(PyMOLGlobals * G);
 
@@ -188,7 +191,6 @@ void SceneGetAdjustedLightValues(PyMOLGlobals * G,
     int limit = 8);
 
 void SceneAbortAnimation(PyMOLGlobals * G);
-void SceneObjectUpdateThread(CObjectUpdateThreadInfo * T);
 int SceneCaptureWindow(PyMOLGlobals * G);
 
 void SceneZoom(PyMOLGlobals * G, float scale);
@@ -25,7 +25,9 @@ Z* -------------------------------------------------------------------
 #include"View.h"
 #include"Image.h"
 #include"ScrollBar.h"
+#include<atomic>
 #include<list>
+#include<mutex>
 #include<vector>
 
 #define TRN_BKG 0x30
@@ -126,10 +128,12 @@ class CScene : public Block {
   double SweepTime;
   int DirtyFlag;
   int ChangedFlag;
+  std::atomic<int> ChangeCount { 0 }; /* generation of geometry, matrices and settings */
   int CopyType, CopyNextFlag, CopyForced;
   int NFrame { 0 };
   int HasMovie { 0 };
   std::shared_ptr<pymol::Image> Image { nullptr };
+  std::mutex ImageMutex;        /* guards replacing Image while ray tracing publishes previews */
   int MovieFrameFlag;
   double LastRender, RenderTime, LastFrameTime, LastFrameAdjust;
   double LastSweep, LastSweepTime;
@@ -193,8 +197,11 @@ class CScene : public Block {
   float ProjectionMatrix[16];
   int background_color_already_set;
   int do_not_clear;
-  GridInfo grid;
+  GridInfo grid {};
   int last_grid_size;
+  CRay *RayCache { nullptr };   /* primitives of the last ray traced frame */
+  int RayCacheChangeCount { 0 };
+  std::vector<float> RayCacheKey;
   int n_texture_refreshes { 0 };
   CGO *offscreenCGO { nullptr };
   CGO *offscreenOIT_CGO { nullptr };
@@ -80,6 +80,43 @@ static void SceneRaySetRayView(PyMOLGlobals * G, CScene *I, int stereo_hand,
   }
 }
 
+void SceneRayCacheFree(PyMOLGlobals * G)
+{
+  CScene *I = G->Scene;
+  if(I->RayCache) {
+    RayFree(I->RayCache);
+    I->RayCache = nullptr;
+  }
+  I->RayCacheKey.clear();
+}
+
+/*
+ * Everything besides the view matrix which goes into the primitives of a
+ * frame. If it matches the cached frame (and no geometry or setting changed
+ * since, see SceneCountChange), the primitives can be reused as they are.
+ */
+static std::vector<float> SceneRayCacheKey(CScene * I,
+    int ray_width, int ray_height, int tot_height, int antialias, int ortho,
+    float aspRat)
+{
+  std::vector<float> key = {
+    (float) ray_width, (float) ray_height, (float) tot_height,
+    (float) I->Height, (float) antialias, (float) ortho, aspRat,
+    I->m_view.m_pos[0], I->m_view.m_pos[1], I->m_view.m_pos[2],
+    I->m_view.m_clipSafe.m_front, I->m_view.m_clipSafe.m_back,
+  };
+
+  for (auto* obj : I->Obj) {
+    key.push_back(obj->type);
+    key.push_back(ObjectGetCurrentState(obj, false));
+    key.push_back(obj->TTTFlag);
+    if(obj->TTTFlag)
+      key.insert(key.end(), obj->TTT, obj->TTT + 16);
+  }
+
+  return key;
+}
+
 bool SceneRay(PyMOLGlobals * G,
               int ray_width, int ray_height, int mode,
               char **headerVLA_ptr,
@@ -198,7 +235,25 @@ bool SceneRay(PyMOLGlobals * G,
         OrthoBusySlow(G, slot, I->grid.last_slot);
       }
 
-      ray = RayNew(G, antialias);
+      /* camera-only frames (e.g. a "turn y" movie) reuse the primitives */
+      std::vector<float> cache_key;
+      bool cached = false;
+
+      if(mode == 0 && !I->grid.active &&
+          SettingGetGlobal_b(G, cSetting_ray_cache_primitives)) {
+        cache_key = SceneRayCacheKey(I, ray_width, ray_height, tot_height,
+            antialias, ortho, aspRat);
+        if(I->RayCache && I->RayCacheChangeCount == I->ChangeCount &&
+            I->RayCacheKey == cache_key) {
+          ray = I->RayCache;
+          I->RayCache = nullptr;
+          cached = true;
+        }
+      }
+      SceneRayCacheFree(G);
+
+      if(!ray)
+        ray = RayNew(G, antialias);
       if(!ray)
         break;
 
@@ -252,7 +307,11 @@ bool SceneRay(PyMOLGlobals * G,
                      I->m_view.m_clipSafe.m_front / I->m_view.m_clipSafe.m_back, ((float) ray_height) / I->Height);
         }
       }
-      {
+      if(cached) {
+        PRINTFB(G, FB_Ray, FB_Blather)
+          " Ray: reusing %d primitives of the previous frame.\n",
+          RayGetNPrimitives(ray) ENDFB(G);
+      } else {
         int *slot_vla = I->SlotVLA;
         int state = SceneGetState(G);
         RenderInfo info;
@@ -325,10 +384,36 @@ bool SceneRay(PyMOLGlobals * G,
           auto image = pymol::make_unique<pymol::Image>(ray_width, ray_height);
           std::uint32_t background;
 
-          RayRender(ray, image->pixels(), timing, angle, antialias, &background);
+          RayPreviewFn preview;
+
+          if(!I->grid.active) {
+            /* progressive rendering: publish each preview as scene image.
+               The preview is written to its own buffer, which then replaces
+               the scene image under ImageMutex, so readers on other threads
+               never see a partially copied image. */
+            preview = [&](const unsigned int *pixels, int pass, int n_pass) {
+              auto preview_image =
+                  std::make_shared<pymol::Image>(ray_width, ray_height);
+              std::copy(pixels, pixels + ray_width * ray_height,
+                        preview_image->pixels());
+              {
+                std::lock_guard<std::mutex> lock(I->ImageMutex);
+                I->Image.swap(preview_image);
+                I->DirtyFlag = false;
+                I->CopyType = true;
+                I->CopyForced = true;
+              }
+              PyMOL_SetImagePreview(G->PyMOL, pass);
+            };
+          }
+
+          RayRender(ray, image->pixels(), timing, angle, antialias, &background,
+                    preview);
+          PyMOL_SetImagePreview(G->PyMOL, 0);
 
           /*    RayRenderColorTable(ray,ray_width,ray_height,buffer); */
           if(!I->grid.active) {
+            std::lock_guard<std::mutex> lock(I->ImageMutex);
             I->Image = std::move(image);
           } else {
             if(!I->Image) {     /* alloc on first pass */
@@ -362,9 +447,12 @@ bool SceneRay(PyMOLGlobals * G,
               }
             }
           }
-          I->DirtyFlag = false;
-          I->CopyType = true;
-          I->CopyForced = true;
+          {
+            std::lock_guard<std::mutex> lock(I->ImageMutex);
+            I->DirtyFlag = false;
+            I->CopyType = true;
+            I->CopyForced = true;
+          }
 
           if (SettingGet<bool>(G, cSetting_ray_volume) && !I->Image->empty()) {
             rayVolumeImage = I->Image;
@@ -475,7 +563,14 @@ bool SceneRay(PyMOLGlobals * G,
         break;
 
       }
-      RayFree(ray);
+      if(!cache_key.empty() && RayRecycle(ray)) {
+        I->RayCache = ray;
+        I->RayCacheKey = std::move(cache_key);
+        I->RayCacheChangeCount = I->ChangeCount;
+      } else {
+        RayFree(ray);
+      }
+      ray = NULL;
     }
     if(I->grid.active)
       GridSetRayViewport(&I->grid, -1, &ray_x, &ray_y, &ray_width, &ray_height);
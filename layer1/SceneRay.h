@@ -31,5 +31,6 @@ bool SceneRay(PyMOLGlobals * G,
               int show_timing, int antialias);
 
 void SceneRenderRayVolume(PyMOLGlobals * G, CScene *I);
+void SceneRayCacheFree(PyMOLGlobals * G);
 
 #endif
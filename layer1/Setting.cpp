@@ -1923,6 +1923,8 @@ void SettingGenerateSideEffects(PyMOLGlobals * G, int index, const char *sele, i
     }
   }
 
+  SceneCountChange(G);          /* settings may affect the ray primitives */
+
   switch (index) {
   case cSetting_stereo:
     SceneUpdateStereo(G);
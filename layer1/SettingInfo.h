@@ -892,6 +892,16 @@ enum {
   REC_b( 782, openvr_cut_laser                        , global    , false ), // turn on to enable tu cut laser for molecule picker
   REC_f( 783, openvr_laser_width                      , global    , 3.0f ), // increase to make laser ray wider
   REC_f( 784, openvr_gui_distance                     , global    , 1.5f ),
+  REC_b( 785, ray_bvh                                 , global    , false ), // ray tracing: BVH instead of voxel map
+  REC_i( 786, ray_progressive                         , global    , 0, 0, 4 ), // number of coarse preview passes before the full ray trace
+  REC_b( 787, ray_cache_primitives                    , global    , true ), // reuse ray primitives while only the camera moves
+  REC_b( 788, traj_stream                             , global    , false ), // load_traj: read trajectory frames on demand
+  REC_f( 789, traj_stream_cache                       , global    , 512.f ), // MB of coordinate sets kept per streamed trajectory
+  REC_i( 790, traj_stream_prefetch                    , global    , 4, 0, 1000 ), // frames read ahead on a background thread
+  REC_b( 791, iterate_native                          , global    , true ), // alter/iterate: evaluate simple expressions without Python
+  REC_b( 792, assembly_instanced                      , global    , false ), // assembly: one coordinate set plus operators instead of a copy per operator
+  REC_s( 793, surface_cache_dir                       , global    , "" ), // directory of the persistent surface cache (empty = disabled)
+  REC_f( 794, surface_cache_max                       , global    , 1024.f ), // MB, least recently used surfaces are evicted beyond this
 
 
 #ifdef SETTINGINFO_IMPLEMENTATION
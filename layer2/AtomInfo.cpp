@@ -1024,6 +1024,26 @@ int AtomInfoFromPyList(PyMOLGlobals * G, AtomInfoType * I, PyObject * list)
   return (ok);
 }
 
+/*
+ * Fill the columns from `n` atom records
+ */
+void AtomInfoColumns::assign(const AtomInfoType * ai, size_t n)
+{
+  visRep.resize(n);
+  color.resize(n);
+  flags.resize(n);
+  protons.resize(n);
+
+  for(size_t a = 0; a < n; ++a, ++ai) {
+    visRep[a] = ai->visRep;
+    color[a] = ai->color;
+    flags[a] = ai->flags;
+    protons[a] = ai->protons;
+  }
+
+  valid = true;
+}
+
 void AtomInfoCopy(PyMOLGlobals * G, const AtomInfoType * src, AtomInfoType * dst, int copy_properties)
 {
   /* copy, handling resource management issues... */
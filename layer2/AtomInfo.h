@@ -23,6 +23,8 @@ Z* -------------------------------------------------------------------
 #include"Setting.h"
 #include"Version.h"
 
+#include <vector>
+
 #if _PyMOL_VERSION_int < 1770
 #define AtomInfoVERSION  176
 #define BondInfoVERSION  176
@@ -359,6 +361,25 @@ typedef struct AtomInfoType {
   bool has_anisou() const { return anisou; }
 } AtomInfoType;
 
+/*
+ * Structure-of-arrays copy of the AtomInfoType fields which representation
+ * builders and selection predicates test for every atom or bond. Reading
+ * these dense columns touches a few bytes per atom instead of the whole
+ * record. Owned by ObjectMolecule, see ObjectMolecule::getAtomColumns().
+ */
+struct AtomInfoColumns {
+  std::vector<int> visRep;
+  std::vector<int> color;
+  std::vector<unsigned int> flags;
+  std::vector<signed char> protons;
+
+  bool valid = false;
+
+  void assign(const AtomInfoType * ai, size_t n);
+  size_t size() const { return visRep.size(); }
+  bool isHydrogen(size_t atm) const { return protons[atm] == cAN_H; }
+};
+
 void AtomInfoFree(PyMOLGlobals * G);
 int AtomInfoInit(PyMOLGlobals * G);
 void BondTypeInit(BondType *bt);
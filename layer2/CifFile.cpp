@@ -10,12 +10,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include "CifFile.h"
+#include "ThreadPool.h"
 #include "File.h"
 #include "MemoryDebug.h"
 #include "strcasecmp.h"
@@ -23,10 +25,114 @@
 namespace pymol {
 namespace _cif_detail {
 
+static bool isdigit09(char c) { return '0' <= c && c <= '9'; }
+
+/**
+ * Fast path for plain integers like "-123". Returns false for anything
+ * else (leading whitespace, trailing characters, more than 9 digits) which
+ * then has to go through atoi().
+ */
+static bool parse_int_fast(const char* s, int& out)
+{
+  bool neg = (*s == '-');
+  if (neg || *s == '+')
+    ++s;
+
+  if (!isdigit09(*s))
+    return false;
+
+  int value = 0;
+  for (int ndigit = 0; isdigit09(*s); ++s) {
+    if (++ndigit > 9)
+      return false;
+    value = value * 10 + (*s - '0');
+  }
+
+  if (*s)
+    return false;
+
+  out = neg ? -value : value;
+  return true;
+}
+
+/**
+ * Fast path for plain decimal numbers like "-12.345" or "1.5e-3". Returns
+ * false for anything else (uncertainty notation, more than 15 significant
+ * digits, exponents beyond 1e22, ...) which then has to go through atof().
+ *
+ * In the accepted range both the mantissa and the power of ten are exact
+ * doubles, so the single multiplication or division is correctly rounded
+ * and gives the same result as atof().
+ */
+static bool parse_decimal_fast(const char* s, double& out)
+{
+  static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+      1e20, 1e21, 1e22};
+
+  bool neg = (*s == '-');
+  if (neg || *s == '+')
+    ++s;
+
+  unsigned long long mantissa = 0;
+  int nsignificant = 0;
+  int ndigit = 0;
+  int exponent = 0;
+
+  for (; isdigit09(*s); ++s, ++ndigit) {
+    mantissa = mantissa * 10 + (*s - '0');
+    if (mantissa)
+      ++nsignificant;
+  }
+
+  if (*s == '.') {
+    for (++s; isdigit09(*s); ++s, ++ndigit, --exponent) {
+      mantissa = mantissa * 10 + (*s - '0');
+      if (mantissa)
+        ++nsignificant;
+    }
+  }
+
+  if (!ndigit || nsignificant > 15)
+    return false;
+
+  if (*s == 'e' || *s == 'E') {
+    ++s;
+    bool eneg = (*s == '-');
+    if (eneg || *s == '+')
+      ++s;
+
+    if (!isdigit09(*s))
+      return false;
+
+    int e = 0;
+    for (int n = 0; isdigit09(*s); ++s) {
+      if (++n > 3)
+        return false;
+      e = e * 10 + (*s - '0');
+    }
+
+    exponent += eneg ? -e : e;
+  }
+
+  if (*s || exponent > 22 || exponent < -22)
+    return false;
+
+  double value = double(mantissa);
+  value = (exponent < 0) ? value / pow10[-exponent] : value * pow10[exponent];
+  out = neg ? -value : value;
+  return true;
+}
+
 template <> const char* raw_to_typed(const char* s) { return s; }
 template <> std::string raw_to_typed(const char* s) { return s; }
 template <> char        raw_to_typed(const char* s) { return s[0]; }
-template <> int         raw_to_typed(const char* s) { return atoi(s); }
+
+template <> int raw_to_typed(const char* s)
+{
+  int value;
+  return parse_int_fast(s, value) ? value : atoi(s);
+}
 
 /**
  * Convert to floating point number, ignores uncertainty notation
@@ -34,6 +140,11 @@ template <> int         raw_to_typed(const char* s) { return atoi(s); }
  */
 template <> double raw_to_typed(const char* s)
 {
+  double value;
+  if (parse_decimal_fast(s, value)) {
+    return value;
+  }
+
   const char *close, *open = strchr(s, '(');
   if (open && (close = strchr(open, ')'))) {
     return atof(std::string(s, open - s).append(close + 1).c_str());
@@ -136,6 +247,39 @@ const char* cif_array::get_value_raw(unsigned pos) const
   return pointer.loop->get_value_raw(pos, col);
 }
 
+template <typename T>
+void cif_array::to_array_impl(T* out, unsigned n, T d) const
+{
+  unsigned i = 0;
+
+  if (col != NOT_IN_LOOP) {
+    const cif_loop* loop = pointer.loop;
+    const char* const* values = loop->values + col;
+    unsigned i_end = std::min<unsigned>(n, loop->nrows);
+
+    for (; i < i_end; ++i, values += loop->ncols) {
+      out[i] = *values ? _cif_detail::raw_to_typed<T>(*values) : d;
+    }
+  }
+
+  // single value, and rows beyond size()
+  for (; i < n; ++i) {
+    out[i] = as<T>(i, d);
+  }
+}
+
+void cif_array::to_array(int* out, unsigned n, int d) const {
+  to_array_impl(out, n, d);
+}
+
+void cif_array::to_array(float* out, unsigned n, float d) const {
+  to_array_impl(out, n, d);
+}
+
+void cif_array::to_array(double* out, unsigned n, double d) const {
+  to_array_impl(out, n, d);
+}
+
 // true if all values in ['.', '?']
 bool cif_array::is_missing_all() const {
   for (unsigned i = 0, n = size(); i != n; ++i) {
@@ -215,7 +359,17 @@ void cif_file::error(const char* msg) {
 }
 
 // constructor
-cif_file::cif_file(const char* filename, const char* contents_) {
+cif_file::cif_file(const char* filename, const char* contents_)
+    : cif_file(filename, contents_, nullptr, 1)
+{
+}
+
+// constructor
+cif_file::cif_file(const char* filename, const char* contents_,
+    ThreadPool* pool, std::size_t n_thread)
+    : m_pool(pool)
+    , m_n_thread(n_thread)
+{
   if (contents_) {
     parse_string(contents_);
   } else if (filename) {
@@ -233,67 +387,211 @@ cif_file& cif_file::operator=(cif_file&&) = default;
 // destructor
 cif_file::~cif_file() = default;
 
-bool cif_file::parse(char*&& p) {
-  m_datablocks.clear();
-  m_tokens.clear();
-  m_contents.reset(p);
+namespace {
 
-  if (!p) {
-    error("parse(nullptr)");
-    return false;
+/*
+ * Tokens of one chunk of the input buffer. Tokens are recorded as
+ * (start, length) and the buffer is not modified while tokenizing, so chunks
+ * can be tokenized speculatively and in parallel.
+ */
+struct cif_token_chunk {
+  char* begin = nullptr;
+  const char* end = nullptr;
+
+  std::vector<char*> tokens;
+  std::vector<unsigned> lengths;
+  std::vector<bool> keypossible;
+
+  // where tokenizing stopped (>= end) and the character preceding it
+  char* stop = nullptr;
+  char stop_prev = '\0';
+
+  void push(char* token, std::size_t length, bool key) {
+    tokens.push_back(token);
+    lengths.push_back(length);
+    keypossible.push_back(key);
   }
 
-  auto& tokens = m_tokens;
-  char quote;
-  char prev = '\0';
+  /**
+   * Tokenize [p, end). A token which starts before `end` is read to
+   * completion, even if it extends past `end`.
+   * @param prev character preceding `p`
+   */
+  void tokenize(char* p, char prev);
+};
 
-  std::vector<bool> keypossible;
+void cif_token_chunk::tokenize(char* p, char prev)
+{
+  tokens.clear();
+  lengths.clear();
+  keypossible.clear();
 
-  // tokenize
   while (true) {
     while (iswhitespace(*p))
       prev = *(p++);
 
-    if (!*p)
+    if (!*p || p >= end)
       break;
 
     if (*p == '#') {
       while (!(islinefeed0(*++p)));
       prev = *p;
-    } else if (isquote(*p)) { // will NULL the closing quote
-      quote = *p;
-      keypossible.push_back(false);
-      tokens.push_back(p + 1);
+    } else if (isquote(*p)) { // terminated by the closing quote
+      char quote = *p;
+      char* q = p + 1;
       while (*++p && !(*p == quote && iswhitespace0(p[1])));
+      push(q, p - q, false);
       if (*p)
-        *(p++) = 0;
+        ++p;
       prev = *p;
-    } else if (*p == ';' && islinefeed(prev)) { // will NULL the line feed before the closing semicolon
-      keypossible.push_back(false);
-      tokens.push_back(p + 1);
+    } else if (*p == ';' && islinefeed(prev)) { // terminated by the line feed before the closing semicolon
+      char* q = p + 1;
       while (*++p && !(islinefeed(*p) && p[1] == ';'));
-      if (*p) {
-        *p = 0;
+      push(q, p - q, false);
+      if (*p)
         p += 2;
-      }
       prev = ';';
-    } else { // will null the whitespace
+    } else { // terminated by the whitespace
       char * q = p++;
       while (!iswhitespace0(*p)) ++p;
       prev = *p;
       if (p - q == 1 && (*q == '?' || *q == '.')) {
         // store values '.' (inapplicable) and '?' (unknown) as null-pointers
-        q = nullptr;
-        keypossible.push_back(false);
+        push(nullptr, 0, false);
       } else {
+        push(q, p - q, true);
         if (*p)
-          *(p++) = 0;
-        keypossible.push_back(true);
+          ++p;
+      }
+    }
+  }
+
+  stop = p;
+  stop_prev = prev;
+}
+
+// minimum input size per chunk for parallel tokenizing
+const std::size_t cCifMinBytesPerTask = 1 << 20;
+
+} // namespace
+
+/**
+ * Tokenizing happens in two phases: First, chunks of the buffer which start
+ * at line boundaries are tokenized in parallel without modifying the buffer.
+ * A chunk assumes that it doesn't start inside a quoted string or text
+ * field. The previous chunk stops after skipping whitespace, so the
+ * assumption was right if it stopped at the first non-whitespace character
+ * of this chunk. Chunks where it was wrong (or which follow such a chunk)
+ * are tokenized again, starting where the previous chunk stopped. Second,
+ * the chunks are stitched together and the token terminators are replaced
+ * by null characters.
+ */
+void cif_file::tokenize(char* p, std::vector<bool>& keypossible)
+{
+  std::size_t n_task = 1;
+  std::size_t len = 0;
+
+  if (m_pool && m_n_thread > 1) {
+    len = strlen(p);
+    n_task = std::max<std::size_t>(1,
+        std::min(m_n_thread * 2, len / cCifMinBytesPerTask));
+  }
+
+  std::vector<cif_token_chunk> chunks(n_task);
+
+  if (n_task == 1) {
+    chunks[0].begin = p;
+    chunks[0].end = p + (len ? len : strlen(p));
+    chunks[0].tokenize(p, '\0');
+  } else {
+    for (std::size_t t = 0; t < n_task; ++t) {
+      char* begin = p + len * t / n_task;
+
+      // start after a line feed
+      if (t != 0) {
+        begin = std::max(begin, chunks[t - 1].begin);
+        while (*begin && *(begin++) != '\n');
+        chunks[t - 1].end = begin;
       }
-      tokens.push_back(q);
+
+      chunks[t].begin = begin;
     }
+
+    chunks[n_task - 1].end = p + len;
+
+    m_pool->run(n_task, m_n_thread, [&](std::size_t t) {
+      auto& chunk = chunks[t];
+      chunk.tokenize(chunk.begin, t ? '\n' : '\0');
+    });
+
+    for (std::size_t t = 1; t < n_task; ++t) {
+      // e.g. blank or indented lines at the chunk start
+      char* first = chunks[t].begin;
+      while (iswhitespace(*first))
+        ++first;
+
+      if (chunks[t - 1].stop != first) {
+        chunks[t].tokenize(chunks[t - 1].stop, chunks[t - 1].stop_prev);
+      }
+    }
+  }
+
+  // replace terminators by null characters
+  auto terminate = [](char** tokens, const cif_token_chunk& chunk) {
+    for (std::size_t i = 0, n = chunk.lengths.size(); i != n; ++i) {
+      char* token = tokens[i];
+      if (token && token[chunk.lengths[i]]) {
+        token[chunk.lengths[i]] = 0;
+      }
+    }
+  };
+
+  if (n_task == 1) {
+    m_tokens = std::move(chunks[0].tokens);
+    keypossible = std::move(chunks[0].keypossible);
+    terminate(m_tokens.data(), chunks[0]);
+    return;
+  }
+
+  std::vector<std::size_t> offsets(n_task + 1, 0);
+  for (std::size_t t = 0; t < n_task; ++t) {
+    offsets[t + 1] = offsets[t] + chunks[t].tokens.size();
+  }
+
+  m_tokens.resize(offsets[n_task]);
+  keypossible.clear();
+  keypossible.reserve(offsets[n_task]);
+
+  for (auto& chunk : chunks) {
+    keypossible.insert(keypossible.end(), chunk.keypossible.begin(),
+        chunk.keypossible.end());
+    chunk.keypossible = std::vector<bool>();
   }
 
+  m_pool->run(n_task, m_n_thread, [&](std::size_t t) {
+    auto& chunk = chunks[t];
+    std::copy(chunk.tokens.begin(), chunk.tokens.end(),
+        m_tokens.begin() + offsets[t]);
+    terminate(m_tokens.data() + offsets[t], chunk);
+    chunk = cif_token_chunk();
+  });
+}
+
+bool cif_file::parse(char*&& p) {
+  m_datablocks.clear();
+  m_tokens.clear();
+  m_contents.reset(p);
+
+  if (!p) {
+    error("parse(nullptr)");
+    return false;
+  }
+
+  std::vector<bool> keypossible;
+  tokenize(p, keypossible);
+
+  auto& tokens = m_tokens;
+
   cif_data* current_frame = nullptr;
   std::vector<cif_data*> frame_stack;
   std::unique_ptr<cif_data> global_block;
@@ -17,6 +17,8 @@
 #include "MemoryDebug.h"
 
 namespace pymol {
+class ThreadPool;
+
 namespace _cif_detail {
 
 /**
@@ -84,6 +86,17 @@ class cif_file {
   std::vector<cif_data> m_datablocks;
   std::unique_ptr<char, pymol::default_free> m_contents;
 
+  // optional worker threads for tokenizing large inputs
+  ThreadPool* m_pool = nullptr;
+  std::size_t m_n_thread = 1;
+
+  /**
+   * Split the buffer into tokens
+   * @param p null-terminated buffer, will be modified
+   * @param[out] keypossible false for values which can't be a key
+   */
+  void tokenize(char* p, std::vector<bool>& keypossible);
+
   /**
    * Parse CIF string
    * @param p CIF string (takes ownership)
@@ -112,6 +125,14 @@ public:
   /// Construct from file name or buffer
   cif_file(const char* filename, const char* contents = nullptr);
 
+  /**
+   * Construct from file name or buffer, tokenize large inputs in parallel
+   * @param pool worker threads
+   * @param n_thread maximum number of threads
+   */
+  cif_file(const char* filename, const char* contents, ThreadPool* pool,
+      std::size_t n_thread);
+
   /// Data blocks
   const std::vector<cif_data>& datablocks() const { return m_datablocks; }
 };
@@ -149,6 +170,9 @@ private:
     pointer.value = value;
   };
 
+  // implementation of to_array()
+  template <typename T> void to_array_impl(T* out, unsigned n, T d) const;
+
 public:
   // constructor
   cif_array() = default;
@@ -192,6 +216,19 @@ public:
   /// Alias for as<double>()
   double as_d(unsigned pos = 0, double d = 0.) const { return as(pos, d); }
 
+  /**
+   * Convert the first `n` elements to numbers in a single pass over the
+   * column. Same results as calling as<T>(i, d) for every `i < n`, but
+   * without the per-element lookup and with a fast path for plain decimal
+   * numbers.
+   * @param[out] out array of length `n`
+   * @param n number of elements, may exceed size()
+   * @param d default value for unknown/inapplicable elements
+   */
+  void to_array(int* out, unsigned n, int d = 0) const;
+  void to_array(float* out, unsigned n, float d = 0.f) const;
+  void to_array(double* out, unsigned n, double d = 0.) const;
+
   /**
    * Get a copy of the array.
    * @param d default value for unknown/inapplicable elements
@@ -651,6 +651,35 @@ static oper_collection_t parse_oper_expression(const std::string &expr) {
   return collection;
 }
 
+/*
+ * Operator matrices for an operation expression, in the same order as the
+ * coordinate sets of a non-instanced assembly
+ */
+static std::vector<std::array<float, 16>> get_oper_matrices(
+    const oper_collection_t& collection, oper_list_t& oper_list)
+{
+  std::vector<std::array<float, 16>> matrices(1);
+  identity44f(matrices[0].data());
+
+  // cartesian product
+  for (auto c_it = collection.rbegin(); c_it != collection.rend(); ++c_it) {
+    std::vector<std::array<float, 16>> product;
+    product.reserve(matrices.size() * c_it->size());
+
+    for (auto& s_item : *c_it) {
+      const float * matrix = oper_list[s_item].data();
+      for (const auto& m : matrices) {
+        product.push_back(m);
+        left_multiply44f44f(matrix, product.back().data());
+      }
+    }
+
+    matrices = std::move(product);
+  }
+
+  return matrices;
+}
+
 /*
  * Get chains which are part of the assembly
  *
@@ -738,6 +767,7 @@ CoordSet ** read_pdbx_struct_assembly(PyMOLGlobals * G,
 
   CoordSet ** csets = nullptr;
   int csetbeginidx = 0;
+  bool instanced = SettingGetGlobal_b(G, cSetting_assembly_instanced);
 
   // assembly
   for (unsigned i = 0, nrows = arr_oper_expr->size(); i < nrows; ++i) {
@@ -759,8 +789,10 @@ CoordSet ** read_pdbx_struct_assembly(PyMOLGlobals * G,
 
     // new coord set VLA
     int ncsets = 1;
-    for (const auto& c_item : collection) {
-      ncsets *= c_item.size();
+    if (!instanced) {
+      for (const auto& c_item : collection) {
+        ncsets *= c_item.size();
+      }
     }
 
     if (!csets) {
@@ -777,6 +809,12 @@ CoordSet ** read_pdbx_struct_assembly(PyMOLGlobals * G,
     CoordSet ** c_csets = csets + csetbeginidx;
     c_csets[0] = CoordSetCopyFilterChains(cset, atInfo, chains_set);
 
+    if (instanced) {
+      // single copy, operators are applied at render time
+      c_csets[0]->Instances = get_oper_matrices(collection, oper_list);
+      continue;
+    }
+
     // build new coord sets
     for (auto c_it = collection.rbegin(); c_it != collection.rend(); ++c_it) {
       // copy
@@ -1106,10 +1144,35 @@ static CoordSet ** read_atom_site(PyMOLGlobals * G, const cif_data * data,
   CoordSet * cset;
   int mod_num, ncsets = 0;
 
+  // convert numeric columns in bulk
+  std::vector<int> col_mod_num(nrows), col_id(nrows), col_resv(nrows),
+      col_label_seq_id(nrows), col_formal_charge(nrows);
+  std::vector<float> col_x(nrows), col_y(nrows), col_z(nrows);
+  std::vector<double> col_b(nrows), col_q(nrows);
+
+  arr_mod_num->to_array(col_mod_num.data(), nrows, 1);
+  arr_ID->to_array(col_id.data(), nrows);
+  arr_resi->to_array(col_resv.data(), nrows);
+  arr_label_seq_id->to_array(col_label_seq_id.data(), nrows);
+  arr_formal_charge->to_array(col_formal_charge.data(), nrows);
+  arr_x->to_array(col_x.data(), nrows);
+  arr_y->to_array(col_y.data(), nrows);
+  arr_z->to_array(col_z.data(), nrows);
+  arr_q->to_array(col_q.data(), nrows, 1.0);
+
+  if (arr_u) {
+    arr_u->to_array(col_b.data(), nrows);
+    for (auto& b : col_b) {
+      b *= 78.95683520871486; // B = U * 8 * pi^2
+    }
+  } else {
+    arr_b->to_array(col_b.data(), nrows);
+  }
+
   // collect number of atoms per model and number of coord sets
   std::map<int, int> atoms_per_model;
   for (int i = 0, n = nrows; i < n; i++) {
-    mod_num = model_to_state(arr_mod_num->as_i(i, 1));
+    mod_num = model_to_state(col_mod_num[i]);
 
     if (mod_num < 1) {
       PRINTFB(G, FB_ObjectMolecule, FB_Errors)
@@ -1142,15 +1205,15 @@ static CoordSet ** read_atom_site(PyMOLGlobals * G, const cif_data * data,
       continue;
     }
 
-    mod_num = model_to_state(arr_mod_num->as_i(i, 1));
+    mod_num = model_to_state(col_mod_num[i]);
 
     // copy coordinates into coord set
     cset = csets[mod_num - 1];
     int idx = cset->NIndex++;
     float * coord = cset->coordPtr(idx);
-    coord[0] = arr_x->as_d(i);
-    coord[1] = arr_y->as_d(i);
-    coord[2] = arr_z->as_d(i);
+    coord[0] = col_x[i];
+    coord[1] = col_y[i];
+    coord[2] = col_z[i];
 
     if (!discrete && ncsets > 1) {
       // mm_atom_site_label aggregate
@@ -1182,11 +1245,9 @@ static CoordSet ** read_atom_site(PyMOLGlobals * G, const cif_data * data,
     ai->rank = atomCount;
     ai->alt[0] = arr_alt->as_s(i)[0];
 
-    ai->id = arr_ID->as_i(i);
-    ai->b = (arr_u != nullptr) ?
-             arr_u->as_d(i) * 78.95683520871486 : // B = U * 8 * pi^2
-             arr_b->as_d(i);
-    ai->q = arr_q->as_d(i, 1.0);
+    ai->id = col_id[i];
+    ai->b = col_b[i];
+    ai->q = col_q[i];
 
     strncpy_alpha(ai->elem, arr_symbol->as_s(i), cElemNameLen);
 
@@ -1200,8 +1261,8 @@ static CoordSet ** read_atom_site(PyMOLGlobals * G, const cif_data * data,
       ai->flags = cAtomFlag_ignore;
     }
 
-    ai->resv = arr_resi->as_i(i);
-    ai->temp1 = arr_label_seq_id->as_i(i); // for add_missing_ca
+    ai->resv = col_resv[i];
+    ai->temp1 = col_label_seq_id[i]; // for add_missing_ca
 
     if (arr_ins_code) {
       ai->setInscode(arr_ins_code->as_s(i)[0]);
@@ -1215,7 +1276,7 @@ static CoordSet ** read_atom_site(PyMOLGlobals * G, const cif_data * data,
     }
 
     ai->ssType[0] = arr_ss->as_s(i)[0];
-    ai->formalCharge = arr_formal_charge->as_i(i);
+    ai->formalCharge = col_formal_charge[i];
 
     AtomInfoAssignParameters(G, ai);
 
@@ -2242,7 +2303,8 @@ ObjectMolecule *ObjectMoleculeReadCifStr(PyMOLGlobals * G, ObjectMolecule * I,
   }
 
   const char * filename = nullptr;
-  auto cif = std::make_shared<cif_file>(filename, st);
+  auto cif = std::make_shared<cif_file>(filename, st, G->ThreadPool,
+      SettingGetGlobal_i(G, cSetting_max_threads));
 
   for (const auto& datablock : cif->datablocks()) {
     ObjectMolecule * obj = ObjectMoleculeReadCifData(G, &datablock, discrete, quiet);
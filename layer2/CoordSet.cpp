@@ -20,6 +20,8 @@ Z* -------------------------------------------------------------------
 #include"os_std.h"
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include"Base.h"
 #include"OOMac.h"
@@ -225,6 +227,12 @@ int CoordSetFromPyList(PyMOLGlobals * G, PyObject * list, CoordSet ** cs)
 	}
       }
     }
+    if(ok && (ll > 12)) {
+      CPythonVal *val = CPythonVal_PyList_GetItem(G, list, 12);
+      if (!CPythonVal_IsNone(val))
+        ok = PConvFromPyObject(G, val, I->Instances);
+      CPythonVal_Free(val);
+    }
     if(!ok) {
       if(I)
         I->fFree();
@@ -285,7 +293,7 @@ PyObject *CoordSetAsPyList(CoordSet * I)
     auto G = I->G;
     int pse_export_version = SettingGet<float>(G, cSetting_pse_export_version) * 1000;
     bool dump_binary = SettingGet<bool>(G, cSetting_pse_binary_dump) && (!pse_export_version || pse_export_version >= 1765);
-    result = PyList_New(12);
+    result = PyList_New(13);
     PyList_SetItem(result, 0, PyInt_FromLong(I->NIndex));
     PyList_SetItem(result, 1, PyInt_FromLong(I->NAtIndex));
     PyList_SetItem(result, 2, PConvFloatArrayToPyList(I->Coord, I->NIndex * 3, dump_binary));
@@ -325,6 +333,11 @@ PyObject *CoordSetAsPyList(CoordSet * I)
     } else {
       PyList_SetItem(result, 11, PConvAutoNone(NULL));
     }
+    if (!I->Instances.empty()) {
+      PyList_SetItem(result, 12, PConvToPyObject(I->Instances));
+    } else {
+      PyList_SetItem(result, 12, PConvAutoNone(NULL));
+    }
     /* TODO symmetry, spheroid, periodic box ... */
   }
   return (PConvAutoNone(result));
@@ -741,6 +754,15 @@ void CoordSetRealToFrac(CoordSet * I, const CCrystal * cryst)
 }
 
 
+/*========================================================================*/
+const float * CoordSet::instanceCoordPtr(int idx, int instance, float * buf) const
+{
+  if (Instances.empty())
+    return coordPtr(idx);
+  transform44f3f(Instances[instance].data(), coordPtr(idx), buf);
+  return buf;
+}
+
 /*========================================================================*/
 void CoordSetTransform44f(CoordSet * I, const float *mat)
 {
@@ -1114,10 +1136,15 @@ void CoordSet::invalidateRep(int type, int level)
 {
   CoordSet * I = this;
   int a;
+  SceneCountChange(G);          /* invalidates cached ray primitives */
   if(level >= cRepInvVisib) {
     if (I->Obj)
       I->Obj->RepVisCacheValid = false;
   }
+  if(level >= cRepInvColor && level != cRepInvCoord) {
+    if (I->Obj)
+      I->Obj->atomColumnsChanged();
+  }
   /* graphical representations need redrawing */
   if(level == cRepInvVisib) {
     /* cartoon_side_chain_helper */
@@ -1190,8 +1217,7 @@ void CoordSet::invalidateRep(int type, int level)
   }
 
   if(level >= cRepInvCoord) {   /* if coordinates change, then this map becomes invalid */
-    MapFree(I->Coord2Idx);
-    I->Coord2Idx = NULL;
+    I->Coord2Idx.reset();
     ExecutiveInvalidateSelectionIndicatorsCGO(G);
     SceneInvalidatePicking(G);
     /* invalidate distances */
@@ -1212,22 +1238,84 @@ void CoordSet::invalidateRep(int type, int level)
 
 /*========================================================================*/
 
-#define RepUpdateMacro(I,rep,new_fn,state) {\
-  if(I->Active[rep]&&(!G->Interrupt)) {\
-    if(!I->Rep[rep]) {\
-      I->Rep[rep]=new_fn(I,state);\
-      if(I->Rep[rep]){ \
-         I->Rep[rep]->fNew=(struct Rep *(*)(struct CoordSet *,int state))new_fn;\
-         SceneInvalidatePicking(G);\
-      } else {  \
-	I->Active[rep] = false;			\
-      }         \
-    } else {\
-      if(I->Rep[rep]->fUpdate)\
-         I->Rep[rep] = I->Rep[rep]->fUpdate(I->Rep[rep],I,state,rep);\
-    }\
-  }\
-OrthoBusyFast(G,rep,cRepCnt);\
+/**
+ * Create or update representation `rep`
+ * @return true if a new representation was created
+ */
+static bool CoordSetUpdateRep(CoordSet * I, int rep,
+    Rep *(*new_fn)(CoordSet *, int), int state)
+{
+  PyMOLGlobals *G = I->G;
+  bool created = false;
+
+  if(I->Active[rep] && (!G->Interrupt)) {
+    if(!I->Rep[rep]) {
+      I->Rep[rep] = new_fn(I, state);
+      if(I->Rep[rep]) {
+        I->Rep[rep]->fNew = new_fn;
+        created = true;
+      } else {
+        I->Active[rep] = false;
+      }
+    } else {
+      if(I->Rep[rep]->fUpdate)
+        I->Rep[rep] = I->Rep[rep]->fUpdate(I->Rep[rep], I, state, rep);
+    }
+  }
+  OrthoBusyFast(G, rep, cRepCnt);
+  return created;
+}
+
+/**
+ * Representation builders in update order. Concurrent builders read the
+ * coordinate set, the object (with precomputed neighbors) and global
+ * state, and only write their own Rep/Active slot. Evaluating selections
+ * (see CoordSetRepUsesSelector) is not in that list.
+ */
+static const struct {
+  int rep;
+  Rep *(*fNew)(CoordSet *, int);
+  bool concurrent;
+} RepBuilders[] = {
+  { cRepLine, RepWireBondNew, false },
+  { cRepCyl, RepCylBondNew, true },
+  { cRepDot, RepDotNew, false },
+  { cRepMesh, RepMeshNew, true },
+  { cRepSphere, RepSphereNew, true },
+  { cRepRibbon, RepRibbonNew, false },
+  { cRepCartoon, RepCartoonNew, true },
+  { cRepSurface, RepSurfaceNew, true },
+  { cRepLabel, RepLabelNew, false },
+  { cRepNonbonded, RepNonbondedNew, false },
+  { cRepNonbondedSphere, RepNonbondedSphereNew, false },
+  { cRepEllipsoid, RepEllipsoidNew, false },
+};
+
+/**
+ * True if the builder of `rep` looks up atoms by selection (carving and
+ * clearing), which updates the selector's atom table.
+ */
+static bool CoordSetRepUsesSelector(const CoordSet* cs, int rep)
+{
+  auto G = cs->G;
+  auto obj = cs->Obj;
+  int carve = 0, clear = 0;
+
+  switch (rep) {
+  case cRepSurface:
+    carve = cSetting_surface_carve_selection;
+    clear = cSetting_surface_clear_selection;
+    break;
+  case cRepMesh:
+    carve = cSetting_mesh_carve_selection;
+    clear = cSetting_mesh_clear_selection;
+    break;
+  default:
+    return false;
+  }
+
+  return SettingGet_s(G, cs->Setting, obj->Setting, carve)[0] ||
+         SettingGet_s(G, cs->Setting, obj->Setting, clear)[0];
 }
 
 /*========================================================================*/
@@ -1235,6 +1323,7 @@ void CoordSet::update(int state)
 {
   CoordSet * I = this;
   int a;
+  bool created = false;
   assert(G == I->Obj->G);
 
   PRINTFB(G, FB_CoordSet, FB_Blather) " CoordSetUpdate-Entered: object %s state %d cset %p\n",
@@ -1242,23 +1331,17 @@ void CoordSet::update(int state)
     ENDFB(G);
 
   OrthoBusyFast(G, 0, cRepCnt);
-  RepUpdateMacro(I, cRepLine, RepWireBondNew, state);
-  RepUpdateMacro(I, cRepCyl, RepCylBondNew, state);
-  RepUpdateMacro(I, cRepDot, RepDotNew, state);
-  RepUpdateMacro(I, cRepMesh, RepMeshNew, state);
-  RepUpdateMacro(I, cRepSphere, RepSphereNew, state);
-  RepUpdateMacro(I, cRepRibbon, RepRibbonNew, state);
-  RepUpdateMacro(I, cRepCartoon, RepCartoonNew, state);
-  RepUpdateMacro(I, cRepSurface, RepSurfaceNew, state);
-  RepUpdateMacro(I, cRepLabel, RepLabelNew, state);
-  RepUpdateMacro(I, cRepNonbonded, RepNonbondedNew, state);
-  RepUpdateMacro(I, cRepNonbondedSphere, RepNonbondedSphereNew, state);
-  RepUpdateMacro(I, cRepEllipsoid, RepEllipsoidNew, state);
+  for(auto& builder : RepBuilders) {
+    if(CoordSetUpdateRep(I, builder.rep, builder.fNew, state))
+      created = true;
+  }
 
   for(a = 0; a < cRepCnt; a++)
     if(!I->Rep[a])
       I->Active[a] = false;
 
+  if(created)
+    SceneInvalidatePicking(G);
   SceneInvalidate(G);
   OrthoBusyFast(G, 1, 1);
   if(Feedback(G, FB_CoordSet, FB_Blather)) {
@@ -1267,28 +1350,92 @@ void CoordSet::update(int state)
   }
 }
 
+/*========================================================================*/
+void CoordSet::addUpdateTasks(pymol::TaskGraph& graph, int state,
+    pymol::TaskGraph::TaskId dep)
+{
+  std::vector<pymol::TaskGraph::TaskId> tasks;
+
+  // builders which can't run concurrently
+  std::vector<int> serial_reps;
+
+  for(auto& builder : RepBuilders) {
+    if(!Active[builder.rep]) {
+      continue;
+    } else if(!builder.concurrent ||
+              CoordSetRepUsesSelector(this, builder.rep)) {
+      serial_reps.push_back(&builder - RepBuilders);
+    } else {
+      auto rep = builder.rep;
+      auto new_fn = builder.fNew;
+      tasks.push_back(graph.add([this, rep, new_fn, state] {
+        CoordSetUpdateRep(this, rep, new_fn, state);
+      }, {dep}));
+    }
+  }
+
+  if(!serial_reps.empty()) {
+    tasks.push_back(graph.add([this, state, serial_reps] {
+      // one at a time, also across coordinate sets
+      static std::mutex mutex;
+      std::lock_guard<std::mutex> lock(mutex);
+      for(int i : serial_reps) {
+        auto& builder = RepBuilders[i];
+        CoordSetUpdateRep(this, builder.rep, builder.fNew, state);
+      }
+    }, {dep}));
+  }
+
+  auto finish = graph.add([this] {
+    for(int a = 0; a < cRepCnt; a++)
+      if(!Rep[a])
+        Active[a] = false;
+  }, {dep});
+
+  for(auto task : tasks) {
+    graph.addDependency(finish, task);
+  }
+}
+
 
 /*========================================================================*/
-void CoordSetUpdateCoord2IdxMap(CoordSet * I, float cutoff)
+/**
+ * Get the spatial index of the coordinates, for neighbor queries up to
+ * `cutoff`. The index persists until the coordinates get invalidated
+ * (cRepInvCoord), so repeated queries (selections, picking, nearest atom
+ * lookups) don't rebuild it.
+ *
+ * Thread-safe for concurrent representation builders (e.g. ramp coloring
+ * by the same object from several builders), as long as they ask for the
+ * same cutoff.
+ *
+ * @return NULL for small coordinate sets, which are cheaper to scan
+ */
+const pymol::SpatialHash* CoordSetUpdateCoord2IdxMap(CoordSet * I, float cutoff)
 {
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+
   if(cutoff < R_SMALL4)
     cutoff = R_SMALL4;
   if(I->NIndex > 10) {
     if(I->Coord2Idx) {
       if((I->Coord2IdxDiv < cutoff) ||
-         (((cutoff - I->Coord2IdxReq) / I->Coord2IdxReq) < -0.5F)) {
-        MapFree(I->Coord2Idx);
-        I->Coord2Idx = NULL;
+         (((cutoff - I->Coord2IdxReq) / I->Coord2IdxReq) < -0.5F) ||
+         (I->Coord2Idx->size() != I->NIndex)) {
+        I->Coord2Idx.reset();
       }
     }
     if(I->NIndex && (!I->Coord2Idx)) {  /* NOTE: map based on stored coords */
       I->Coord2IdxReq = cutoff;
       I->Coord2IdxDiv = cutoff * 1.25F;
-      I->Coord2Idx = MapNew(I->G, I->Coord2IdxDiv, I->Coord, I->NIndex, NULL);
-      if(I->Coord2IdxDiv < I->Coord2Idx->Div)
-        I->Coord2IdxDiv = I->Coord2Idx->Div;
+      I->Coord2Idx.reset(new pymol::SpatialHash(
+          I->Coord2IdxDiv, I->Coord.data(), I->NIndex));
     }
+  } else {
+    I->Coord2Idx.reset();
   }
+  return I->Coord2Idx.get();
 }
 
 /*
@@ -1546,6 +1693,7 @@ CoordSet::CoordSet(const CoordSet& cs)
   if(cs.PeriodicBox) {
     this->PeriodicBox = pymol::make_unique<CCrystal>(*cs.PeriodicBox);
   }
+  this->Instances = cs.Instances;
   std::copy(std::begin(cs.Name), std::end(cs.Name), std::begin(this->Name));
   this->PeriodicBoxType = cs.PeriodicBoxType;
   this->tmp_index = cs.tmp_index;
@@ -1692,7 +1840,6 @@ CoordSet::~CoordSet()
           obj->DiscreteAtmToIdx[I->IdxToAtm[a]] = -1;
           obj->DiscreteCSet[I->IdxToAtm[a]] = NULL;
         }
-    MapFree(I->Coord2Idx);
     SettingFreeP(I->Setting);
     CGOFree(I->SculptCGO);
   }
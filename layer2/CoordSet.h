@@ -24,6 +24,10 @@ Z* -------------------------------------------------------------------
 #include"Setting.h"
 #include"ObjectMolecule.h"
 #include"vla.h"
+#include"SpatialHash.h"
+#include"TaskGraph.h"
+
+#include <array>
 
 #define COORD_SET_HAS_ANISOU 0x01
 
@@ -45,6 +49,19 @@ struct CoordSet : CObjectState {
 
   // methods
   void update(int state);
+
+  /**
+   * Add the work of update() to `graph`: one task for each independent
+   * representation builder (cartoon, surface, sticks, spheres, mesh), one
+   * for the remaining representations, and a final task which depends on
+   * all of them. Scene invalidation is left to the caller, after the graph
+   * has run.
+   *
+   * @param dep task which must finish first (e.g. object neighbors)
+   */
+  void addUpdateTasks(pymol::TaskGraph& graph, int state,
+      pymol::TaskGraph::TaskId dep);
+
   void render(RenderInfo * info);
   void enumIndices();
   void appendIndices(int offset);
@@ -66,6 +83,14 @@ struct CoordSet : CObjectState {
     return Obj->AtomInfo + IdxToAtm[idx];
   }
 
+  // number of copies in which this coord set is shown (see Instances)
+  int instanceCount() const {
+    return Instances.empty() ? 1 : int(Instances.size());
+  }
+
+  // coordinate of `idx` in copy `instance`, transformed into `buf` if needed
+  const float * instanceCoordPtr(int idx, int instance, float * buf) const;
+
   // true if any atom in this coord set has any of the reps in "bitmask" shown
   bool hasRep(int bitmask) {
     if (Obj->RepVisCache & bitmask)
@@ -87,6 +112,9 @@ struct CoordSet : CObjectState {
   int NTmpLinkBond = 0;             /* optional, temporary storage of linkage  info. */
   pymol::vla<BondType> TmpLinkBond;        /* first atom is in obj, second is in cset */
   std::unique_ptr<CSymmetry> Symmetry;
+  /* instanced biological assembly (assembly_instanced): row-major 4x4
+   * operators, each rendering a transformed copy of Coord */
+  std::vector<std::array<float, 16>> Instances;
   WordType Name = {0};
   std::vector<float> Spheroid;
   std::vector<float> SpheroidNormal;
@@ -113,7 +141,8 @@ struct CoordSet : CObjectState {
 
   CGO *SculptCGO = nullptr;
   CGO *SculptShaderCGO = nullptr;
-  MapType *Coord2Idx = nullptr;
+  /* spatial index of Coord, dropped when the coordinates change */
+  std::unique_ptr<pymol::SpatialHash> Coord2Idx;
   float Coord2IdxReq = 0, Coord2IdxDiv = 0;
 
   /* temporary / optimization */
@@ -183,11 +212,7 @@ void CoordSetPurge(CoordSet * I);
 void CoordSetAdjustAtmIdx(CoordSet * I, int *lookup, int nAtom);
 int CoordSetMerge(ObjectMolecule *OM, CoordSet * I, CoordSet * cs);        /* must be non-overlapping */
 void CoordSetRecordTxfApplied(CoordSet * I, const float *TTT, int homogenous);
-void CoordSetUpdateCoord2IdxMap(CoordSet * I, float cutoff);
-
-typedef struct _CCoordSetUpdateThreadInfo CCoordSetUpdateThreadInfo;
-
-void CoordSetUpdateThread(CCoordSetUpdateThreadInfo * T);
+const pymol::SpatialHash* CoordSetUpdateCoord2IdxMap(CoordSet * I, float cutoff);
 
 void LabPosTypeCopy(const LabPosType * src, LabPosType * dst);
 void RefPosTypeCopy(const RefPosType * src, RefPosType * dst);
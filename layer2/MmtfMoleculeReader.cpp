@@ -73,11 +73,14 @@ CoordSet ** get_assembly_csets(PyMOLGlobals * G,
   PRINTFB(G, FB_Executive, FB_Details)
     " ExecutiveLoad-Detail: Creating assembly '%s'\n", assembly_id ENDFB(G);
 
-  int ncsets = assembly->transformListCount;
-  CoordSet ** csets = VLACalloc(CoordSet *, ncsets);
+  bool instanced = SettingGetGlobal_b(G, cSetting_assembly_instanced);
+  int ntrans = assembly->transformListCount;
+  int ncsets = 0;
+  CoordSet ** csets = VLACalloc(CoordSet *, ntrans);
+  std::set<lexborrow_t> prev_chains_set;
 
-  for (int state = 0; state < ncsets; ++state) {
-    auto trans = assembly->transformList + state;
+  for (int t = 0; t < ntrans; ++t) {
+    auto trans = assembly->transformList + t;
 
     // get set of chains for this transformation
     std::set<lexborrow_t> chains_set;
@@ -91,11 +94,25 @@ CoordSet ** get_assembly_csets(PyMOLGlobals * G,
       }
     }
 
+    if (instanced) {
+      // consecutive transformations of the same chains share one copy
+      if (!ncsets || chains_set != prev_chains_set) {
+        csets[ncsets++] = CoordSetCopyFilterChains(cset, atInfo, chains_set);
+        prev_chains_set = std::move(chains_set);
+      }
+
+      auto& instances = csets[ncsets - 1]->Instances;
+      instances.emplace_back();
+      std::copy_n(trans->matrix, 16, instances.back().data());
+      continue;
+    }
+
     // copy and transform
-    csets[state] = CoordSetCopyFilterChains(cset, atInfo, chains_set);
-    CoordSetTransform44f(csets[state], trans->matrix);
+    csets[ncsets] = CoordSetCopyFilterChains(cset, atInfo, chains_set);
+    CoordSetTransform44f(csets[ncsets++], trans->matrix);
   }
 
+  VLASize(csets, CoordSet *, ncsets);
   return csets;
 }
 #endif
@@ -1156,6 +1156,7 @@ void ObjectAlignment::render(RenderInfo * info)
 
 void ObjectAlignment::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   if((rep == cRepAll) || (rep == cRepCGO)) {
     for(StateIterator iter(G, Setting, state, getNFrame()); iter.next();) {
       ObjectAlignmentState& sobj = State[iter.state];
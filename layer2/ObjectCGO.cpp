@@ -210,6 +210,7 @@ void ObjectCGORecomputeExtent(ObjectCGO * I)
 /*========================================================================*/
 void ObjectCGO::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   auto I = this;
   ObjectCGOState *sobj = NULL;
 
@@ -312,6 +312,7 @@ static CSetting **ObjectDistGetSettingHandle(ObjectDist * I, int state)
 #endif
 
 void ObjectDist::invalidate(int rep, int level, int state){
+  SceneCountChange(G);
   auto I = this;
   for(StateIterator iter(I->G, I->Setting, state, I->NDSet);
       iter.next();) {
@@ -195,7 +195,8 @@ int ObjectMapStateGetExcludedStats(PyMOLGlobals * G, ObjectMapState * ms, float
             within_flag = within_default;
             beyond_flag = true;
 
-            const float* v = F4Ptr(field->points, a, b, c, 0);
+            float v[3];
+            field->getPoint(a, b, c, v);
 
             MapLocus(voxelmap, v, &h, &k, &l);
             i = *(MapEStart(voxelmap, h, k, l));
@@ -408,7 +409,6 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
   int fdim[4];
   int new_min[3], new_max[3], new_fdim[3];
   int a, b, c, d, e, f;
-  float *vt, *vr;
   float v[3];
   float grid[3];
   Isofield *field;
@@ -480,7 +480,7 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
       orig_size = fdim[0] * fdim[1] * fdim[2];
       new_size = new_fdim[0] * new_fdim[1] * new_fdim[2];
 
-      field = new Isofield(G, new_fdim);
+      field = new Isofield(G, new_fdim, !ms->Field->points);
       field->save_points = ms->Field->save_points;
 
       for(c = 0; c < new_fdim[2]; c++) {
@@ -489,9 +489,8 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
           e = b + (new_min[1] - min[1]);
           for(a = 0; a < new_fdim[0]; a++) {
             d = a + (new_min[0] - min[0]);
-            vt = F4Ptr(field->points, a, b, c, 0);
-            vr = F4Ptr(ms->Field->points, d, e, f, 0);
-            copy3f(vr, vt);
+            if(field->points)
+              ms->Field->getPoint(d, e, f, F4Ptr(field->points, a, b, c, 0));
             F3(field->data, a, b, c) = F3(ms->Field->data, d, e, f);
           }
         }
@@ -502,6 +501,8 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
         ms->FDim[a] = new_fdim[a];
       }
       ms->Field.reset(field);
+      if(!field->points)
+        ObjectMapStateRegeneratePoints(ms);
 
       /* compute new extents */
       v[2] = (ms->Min[2]) / ((float) ms->Div[2]);
@@ -582,7 +583,7 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
       orig_size = fdim[0] * fdim[1] * fdim[2];
       new_size = new_fdim[0] * new_fdim[1] * new_fdim[2];
 
-      field = new Isofield(G, new_fdim);
+      field = new Isofield(G, new_fdim, !ms->Field->points);
       field->save_points = ms->Field->save_points;
 
       for(c = 0; c < new_fdim[2]; c++) {
@@ -591,9 +592,8 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
           e = b + (new_min[1] - min[1]);
           for(a = 0; a < new_fdim[0]; a++) {
             d = a + (new_min[0] - min[0]);
-            vt = F4Ptr(field->points, a, b, c, 0);
-            vr = F4Ptr(ms->Field->points, d, e, f, 0);
-            copy3f(vr, vt);
+            if(field->points)
+              ms->Field->getPoint(d, e, f, F4Ptr(field->points, a, b, c, 0));
             F3(field->data, a, b, c) = F3(ms->Field->data, d, e, f);
           }
         }
@@ -607,6 +607,8 @@ static void ObjectMapStateTrim(PyMOLGlobals * G, ObjectMapState * ms,
       }
 
       ms->Field.reset(field);
+      if(!field->points)
+        ObjectMapStateRegeneratePoints(ms);
 
       for(e = 0; e < 3; e++) {
         ms->ExtentMin[e] = ms->Origin[e] + ms->Grid[e] * ms->Min[e];
@@ -643,8 +645,6 @@ static void ObjectMapStateDouble(PyMOLGlobals * G, ObjectMapState * ms)
   int max[3];
   int fdim[4];
   int a, b, c;
-  float v[3], vr[3];
-  float *vt;
   float x, y, z;
   float grid[3];
 
@@ -658,20 +658,14 @@ static void ObjectMapStateDouble(PyMOLGlobals * G, ObjectMapState * ms)
       fdim[a] = ms->FDim[a] * 2 - 1;
     }
     fdim[3] = 3;
-    field = new Isofield(G, fdim);
+    field = new Isofield(G, fdim, true);
     field->save_points = ms->Field->save_points;
     for(c = 0; c < fdim[2]; c++) {
-      v[2] = (c + min[2]) / ((float) div[2]);
       z = (c & 0x1) ? 0.5F : 0.0F;
       for(b = 0; b < fdim[1]; b++) {
-        v[1] = (b + min[1]) / ((float) div[1]);
         y = (b & 0x1) ? 0.5F : 0.0F;
         for(a = 0; a < fdim[0]; a++) {
-          v[0] = (a + min[0]) / ((float) div[0]);
-          transform33f3f(ms->Symmetry->Crystal.FracToReal, v, vr);
           x = (a & 0x1) ? 0.5F : 0.0F;
-          vt = F4Ptr(field->points, a, b, c, 0);
-          copy3f(vr, vt);
           if((a & 0x1) || (b & 0x1) || (c & 0x1)) {
             F3(field->data, a, b, c) = FieldInterpolatef(ms->Field->data.get(),
                                                          a / 2, b / 2, c / 2, x, y, z);
@@ -689,6 +683,7 @@ static void ObjectMapStateDouble(PyMOLGlobals * G, ObjectMapState * ms)
     }
 
     ms->Field.reset(field);
+    ObjectMapStateRegeneratePoints(ms);
   } else {
     for(a = 0; a < 3; a++) {
       grid[a] = ms->Grid[a] / 2.0F;
@@ -698,20 +693,15 @@ static void ObjectMapStateDouble(PyMOLGlobals * G, ObjectMapState * ms)
     }
     fdim[3] = 3;
 
-    field = new Isofield(G, fdim);
+    field = new Isofield(G, fdim, true);
     field->save_points = ms->Field->save_points;
 
     for(c = 0; c < fdim[2]; c++) {
-      v[2] = ms->Origin[2] + grid[2] * (c + min[2]);
       z = (c & 0x1) ? 0.5F : 0.0F;
       for(b = 0; b < fdim[1]; b++) {
-        v[1] = ms->Origin[1] + grid[1] * (b + min[1]);
         y = (b & 0x1) ? 0.5F : 0.0F;
         for(a = 0; a < fdim[0]; a++) {
-          v[0] = ms->Origin[0] + grid[0] * (a + min[0]);
           x = (a & 0x1) ? 0.5F : 0.0F;
-          vt = F4Ptr(field->points, a, b, c, 0);
-          copy3f(v, vt);
           if((a & 0x1) || (b & 0x1) || (c & 0x1)) {
             F3(field->data, a, b, c) = FieldInterpolatef(ms->Field->data.get(),
                                                          a / 2, b / 2, c / 2, x, y, z);
@@ -731,6 +721,7 @@ static void ObjectMapStateDouble(PyMOLGlobals * G, ObjectMapState * ms)
         ms->Grid[a] = grid[a];
     }
     ms->Field.reset(field);
+    ObjectMapStateRegeneratePoints(ms);
   }
 }
 
@@ -741,8 +732,7 @@ static void ObjectMapStateHalve(PyMOLGlobals * G, ObjectMapState * ms, int smoot
   int max[3];
   int fdim[4];
   int a, b, c;
-  float v[3], vr[3];
-  float *vt;
+  float v[3];
   float x, y, z;
   float grid[3];
 
@@ -775,7 +765,7 @@ static void ObjectMapStateHalve(PyMOLGlobals * G, ObjectMapState * ms, int smoot
     if(smooth)
       FieldSmooth3f(ms->Field->data.get());
 
-    field = new Isofield(G, fdim);
+    field = new Isofield(G, fdim, true);
     field->save_points = ms->Field->save_points;
 
     /*
@@ -809,9 +799,6 @@ static void ObjectMapStateHalve(PyMOLGlobals * G, ObjectMapState * ms, int smoot
             a_2 = old_max[0] - 1;
             x = (v[0] - ((a_2 + old_min[0]) / (float) old_div[0])) * old_div[0];
           }
-          transform33f3f(ms->Symmetry->Crystal.FracToReal, v, vr);
-          vt = F4Ptr(field->points, a, b, c, 0);
-          copy3f(vr, vt);
           F3(field->data, a, b, c) = FieldInterpolatef(ms->Field->data.get(),
                                                        a_2, b_2, c_2, x, y, z);
         }
@@ -825,6 +812,7 @@ static void ObjectMapStateHalve(PyMOLGlobals * G, ObjectMapState * ms, int smoot
     }
 
     ms->Field.reset(field);
+    ObjectMapStateRegeneratePoints(ms);
 
     /* compute new extents */
     v[2] = (ms->Min[2]) / ((float) ms->Div[2]);
@@ -866,17 +854,12 @@ static void ObjectMapStateHalve(PyMOLGlobals * G, ObjectMapState * ms, int smoot
     }
     fdim[3] = 3;
 
-    field = new Isofield(G, fdim);
+    field = new Isofield(G, fdim, true);
     field->save_points = ms->Field->save_points;
 
     for(c = 0; c < fdim[2]; c++) {
-      v[2] = ms->Origin[2] + grid[2] * (c + min[2]);
       for(b = 0; b < fdim[1]; b++) {
-        v[1] = ms->Origin[1] + grid[1] * (b + min[1]);
         for(a = 0; a < fdim[0]; a++) {
-          v[0] = ms->Origin[0] + grid[0] * (a + min[0]);
-          vt = F4Ptr(field->points, a, b, c, 0);
-          copy3f(v, vt);
           F3(field->data, a, b, c) = F3(ms->Field->data, a * 2, b * 2, c * 2);
         }
       }
@@ -891,7 +874,7 @@ static void ObjectMapStateHalve(PyMOLGlobals * G, ObjectMapState * ms, int smoot
         ms->Grid[a] = grid[a];
     }
     ms->Field.reset(field);
-
+    ObjectMapStateRegeneratePoints(ms);
   }
 }
 
@@ -1189,38 +1172,30 @@ void ObjectMapRegeneratePoints(ObjectMap * om){
   }
 }
 
+/*
+ * Replaces the stored grid coordinates by the implicit (affine) grid
+ * description of the map, which takes no memory per grid point.
+ */
 void ObjectMapStateRegeneratePoints(ObjectMapState * ms)
 {
-  int a, b, c, e;
-  float v[3], vr[3];
+  int a, e;
+  float v[3], origin[3], axes[9] = {};
 
   if(ObjectMapStateValidXtal(ms)) {
-    for(c = 0; c < ms->FDim[2]; c++) {
-      v[2] = (c + ms->Min[2]) / ((float) ms->Div[2]);
-      for(b = 0; b < ms->FDim[1]; b++) {
-        v[1] = (b + ms->Min[1]) / ((float) ms->Div[1]);
-        for(a = 0; a < ms->FDim[0]; a++) {
-          v[0] = (a + ms->Min[0]) / ((float) ms->Div[0]);
-          transform33f3f(ms->Symmetry->Crystal.FracToReal, v, vr);
-          for(e = 0; e < 3; e++)
-            F4(ms->Field->points, a, b, c, e) = vr[e];
-        }
-      }
+    const float *frac2real = ms->Symmetry->Crystal.FracToReal;
+    for(a = 0; a < 3; a++) {
+      v[a] = ms->Min[a] / ((float) ms->Div[a]);
+      for(e = 0; e < 3; e++)
+        axes[3 * a + e] = frac2real[3 * e + a] / ms->Div[a];
     }
+    transform33f3f(frac2real, v, origin);
   } else {
-    for(c = 0; c < ms->FDim[2]; c++) {
-      v[2] = ms->Origin[2] + ms->Grid[2] * (c + ms->Min[2]);
-      for(b = 0; b < ms->FDim[1]; b++) {
-        v[1] = ms->Origin[1] + ms->Grid[1] * (b + ms->Min[1]);
-        for(a = 0; a < ms->FDim[0]; a++) {
-          v[0] = ms->Origin[0] + ms->Grid[0] * (a + ms->Min[0]);
-          for(e = 0; e < 3; e++) {
-            F4(ms->Field->points, a, b, c, e) = v[e];
-          }
-        }
-      }
+    for(a = 0; a < 3; a++) {
+      origin[a] = ms->Origin[a] + ms->Grid[a] * ms->Min[a];
+      axes[4 * a] = ms->Grid[a];
     }
   }
+  ms->Field->setImplicitPoints(origin, axes);
 }
 
 static PyObject *ObjectMapStateAsPyList(ObjectMapState * I)
@@ -1663,6 +1638,7 @@ void ObjectMap::update()
 
 void ObjectMap::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   auto I = this;
   if(level >= cRepInvExtents) {
     I->ExtentFlag = false;
@@ -1892,6 +1868,16 @@ void ObjectMap::render(RenderInfo * info)
           int cnt = data->dim[0] * data->dim[1] * data->dim[2];
           CField *points = ms->Field->points.get();
           CField *gradients = NULL;
+          std::unique_ptr<CField> implicit_points;
+
+          if(!points) {
+            /* dots walk the raw arrays, so spell out implicit coordinates */
+            int dim4[4] = { data->dim[0], data->dim[1], data->dim[2], 3 };
+            int zero[3] = { 0, 0, 0 };
+            implicit_points.reset(CField::make<float>(G, dim4, 4));
+            IsofieldFillPoints(ms->Field.get(), implicit_points.get(), zero);
+            points = implicit_points.get();
+          }
 
           if(SettingGet_b(G, NULL, I->Setting, cSetting_dot_normals)) {
             gradients = ms->Field->gradients.get();
@@ -2227,18 +2213,27 @@ ObjectMapState *ObjectMapNewStateFromDesc(PyMOLGlobals * G, ObjectMap * I,
 
 
 /*========================================================================*/
-static float ccp4_next_value(char ** pp, int mode) {
-  char * p = *pp;
+/* reads the next value, swapping its bytes if `swap` is set (leaves the
+   buffer untouched, so it can be a read-only file mapping) */
+static float ccp4_next_value(const char ** pp, int mode, bool swap = false) {
+  const char * p = *pp;
+  char tmp[4];
+  if(swap && mode) {
+    int width = (mode == 1) ? 2 : 4;
+    for(int w = 0; w < width; w++)
+      tmp[w] = p[width - 1 - w];
+    p = tmp;
+  }
   switch(mode) {
     case 0:
       *pp += 1;
-      return (float) *((int8_t *) p);
+      return (float) *((const int8_t *) p);
     case 1:
       *pp += 2;
-      return (float) *((int16_t *) p);
+      return (float) *((const int16_t *) p);
     case 2:
       *pp += 4;
-      return *((float *) p);
+      return *((const float *) p);
   }
   printf("ERROR unsupported mode\n");
   return 0.f;
@@ -2255,16 +2250,17 @@ static void swap_endian(char * p, int n, int width) {
   }
 }
 
-static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int state,
+static int ObjectMapCCP4StrToMap(ObjectMap * I, const char *CCP4Str, size_t bytes, int state,
                                  int quiet, int format)
 {
   auto G = I->G;
-  char *p;
-  int *i;
+  const char *p;
+  int header[256];
+  const int *i;
   size_t bytes_per_pt;
-  char *q;
+  const char *q;
   float dens;
-  int a, b, c, d, e;
+  int a, b, c, d;
   float v[3], vr[3], maxd, mind;
   int ok = true;
   int little_endian = 1, map_endian;
@@ -2283,7 +2279,8 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
   float mean, stdev;
   int normalize;
   ObjectMapState *ms;
-  int expectation;
+  size_t expectation;
+  bool swap;
 
   switch (format) {
   case cLoadTypeCCP4Map:
@@ -2317,16 +2314,20 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
   p = CCP4Str;
   little_endian = *((char *) &little_endian);
   map_endian = (*p || *(p + 1)); // NOTE: this assumes 0x0 < NC < 0x10000
+  swap = (little_endian != map_endian);
 
-  if(little_endian != map_endian) {
+  /* swap a copy of the header, the buffer may be a read-only mapping */
+  memcpy(header, p, sizeof(header));
+
+  if(swap) {
     if(!quiet) {
       PRINTFB(I->G, FB_ObjectMap, FB_Blather)
         " ObjectMapCCP4: Map appears to be reverse endian, swapping...\n" ENDFB(I->G);
     }
-    swap_endian(p, 256, sizeof(int));
+    swap_endian((char *) header, 256, sizeof(int));
   }
 
-  i = (int *) p;
+  i = header;
   nc = *(i++);                  /* columns */
   nr = *(i++);                  /* rows */
   ns = *(i++);                  /* sections */
@@ -2496,11 +2497,11 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
     }
   }
 
-  expectation = sym_skip + sizeof(int) * 256 + bytes_per_pt * n_pts;
+  expectation = sym_skip + sizeof(int) * 256 + bytes_per_pt * (size_t) n_pts;
 
   if(!quiet) {
     PRINTFB(I->G, FB_ObjectMap, FB_Blather)
-      " ObjectMapCCP4: sym_skip %d bytes %d expectation %d\n",
+      " ObjectMapCCP4: sym_skip %d bytes %zu expectation %zu\n",
       sym_skip, bytes, expectation ENDFB(I->G);
   }
 
@@ -2525,17 +2526,13 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
 
   q = p + (sizeof(int) * 256) + sym_skip;
 
-  if(little_endian != map_endian && bytes_per_pt > 1) {
-    swap_endian(q, n_pts, bytes_per_pt);
-  }
-
   // with normalize == 2, use mean and stdev from file header
   if(normalize == 1 && n_pts > 1) {
     c = n_pts;
     sum = 0.0;
     sumsq = 0.0;
     while(c--) {
-      dens = ccp4_next_value(&q, map_mode);
+      dens = ccp4_next_value(&q, map_mode, swap);
       sumsq += dens * dens;
       sum += dens;
     }
@@ -2600,7 +2597,7 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
   else {
     SymmetryUpdate(ms->Symmetry.get());
     /*    CrystalDump(ms->Crystal); */
-    ms->Field.reset(new Isofield(I->G, ms->FDim));
+    ms->Field.reset(new Isofield(I->G, ms->FDim, true));
     ms->MapSource = cMapSourceCCP4;
     ms->Field->save_points = false;
 
@@ -2608,15 +2605,9 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
     mind = FLT_MAX;
 
     for(cc[maps] = 0; cc[maps] < ms->FDim[maps]; cc[maps]++) {
-      v[maps] = (cc[maps] + ms->Min[maps]) / ((float) ms->Div[maps]);
-
       for(cc[mapr] = 0; cc[mapr] < ms->FDim[mapr]; cc[mapr]++) {
-        v[mapr] = (cc[mapr] + ms->Min[mapr]) / ((float) ms->Div[mapr]);
-
         for(cc[mapc] = 0; cc[mapc] < ms->FDim[mapc]; cc[mapc]++) {
-          v[mapc] = (cc[mapc] + ms->Min[mapc]) / ((float) ms->Div[mapc]);
-
-          dens = ccp4_next_value(&q, map_mode);
+          dens = ccp4_next_value(&q, map_mode, swap);
 
           if(normalize)
             dens = (dens - mean) / stdev;
@@ -2625,9 +2616,6 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
             maxd = dens;
           if(mind > dens)
             mind = dens;
-          transform33f3f(ms->Symmetry->Crystal.FracToReal, v, vr);
-          for(e = 0; e < 3; e++)
-            F4(ms->Field->points, cc[0], cc[1], cc[2], e) = vr[e];
         }
       }
     }
@@ -2695,6 +2683,7 @@ static int ObjectMapCCP4StrToMap(ObjectMap * I, char *CCP4Str, int bytes, int st
     ErrMessage(I->G, "ObjectMap", "Error reading map");
   } else {
     ms->Active = true;
+    ObjectMapStateRegeneratePoints(ms);
     ObjectMapUpdateExtents(I);
     if(!quiet) {
       PRINTFB(I->G, FB_ObjectMap, FB_Results)
@@ -4634,8 +4623,8 @@ static ObjectMap *ObjectMapReadXPLORStr(PyMOLGlobals * G, ObjectMap * I, char *X
 
 
 /*========================================================================*/
-static ObjectMap *ObjectMapReadCCP4Str(PyMOLGlobals * G, ObjectMap * I, char *XPLORStr,
-                                       int bytes, int state, int quiet,
+static ObjectMap *ObjectMapReadCCP4Str(PyMOLGlobals * G, ObjectMap * I, const char *XPLORStr,
+                                       size_t bytes, int state, int quiet,
                                        int format)
 {
   int ok = true;
@@ -4666,28 +4655,31 @@ ObjectMap *ObjectMapLoadCCP4(PyMOLGlobals * G, ObjectMap * obj, const char *fnam
                              int format)
 {
   ObjectMap *I = NULL;
-  char *buffer;
-  long size;
+  const char *buffer;
+  size_t size;
+  std::unique_ptr<pymol::MappedFile> file;
 
   if(!is_string) {
     if (!quiet)
       PRINTFB(G, FB_ObjectMap, FB_Actions)
         " ObjectMapLoadCCP4File: Loading from '%s'.\n", fname ENDFB(G);
 
-    buffer = FileGetContents(fname, &size);
+    /* map the file instead of reading it, the voxels are decoded straight
+       from the page cache into the map field */
+    file.reset(new pymol::MappedFile(fname));
+    buffer = file->data();
+    size = file->size();
 
     if(!buffer)
       ErrMessage(G, "ObjectMapLoadCCP4File", "Unable to open file!");
   } else {
-    buffer = (char*) fname;
-    size = (long) bytes;
+    buffer = fname;
+    size = bytes;
   }
 
   if (buffer) {
     I = ObjectMapReadCCP4Str(G, obj, buffer, size, state, quiet, format);
-
-    if(!is_string)
-      mfree(buffer);
+    file.reset();
 
     if(!quiet) {
       if(state < 0)
@@ -5990,9 +5982,9 @@ void ObjectMapDump(const ObjectMap* om, const char* fname, int state, int quiet)
     for (int yi = 0; yi < field->dimensions[1]; yi++) {
       for (int zi = 0; zi < field->dimensions[2]; zi++) {
 
-        float x = Ffloat4(field->points, xi, yi, zi, 0);
-        float y = Ffloat4(field->points, xi, yi, zi, 1);
-        float z = Ffloat4(field->points, xi, yi, zi, 2);
+        float xyz[3];
+        field->getPoint(xi, yi, zi, xyz);
+        float x = xyz[0], y = xyz[1], z = xyz[2];
 
         switch (field->data->type) {
           case cFieldFloat: {
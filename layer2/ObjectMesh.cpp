@@ -333,6 +333,7 @@ void ObjectMeshDump(ObjectMesh * I, const char *fname, int state, int quiet)
 
 void ObjectMesh::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   auto I = this;
   if(level >= cRepInvExtents) {
     I->ExtentFlag = false;
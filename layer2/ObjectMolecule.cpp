@@ -20,6 +20,7 @@ Z* -------------------------------------------------------------------
 #include"os_gl.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <set>
 
@@ -53,6 +54,9 @@ Z* -------------------------------------------------------------------
 #include "Lex.h"
 #include "MolV3000.h"
 #include "HydrogenAdder.h"
+#include "TrajStream.h"
+#include "TaskGraph.h"
+#include "ThreadPool.h"
 
 #ifdef _WEBGL
 #endif
@@ -2697,6 +2701,8 @@ void ObjectGotoState(CObject* I, int state)
 /*========================================================================*/
 CObjectState* ObjectMolecule::_getObjectState(int state)
 {
+  if (TrajStream && TrajStream->hasState(state))
+    return TrajStreamFetch(TrajStream, state);
   return CSet[state];
 }
 
@@ -3156,6 +3162,7 @@ int ObjectMoleculeRenameAtoms(ObjectMolecule * I, int *flag, int force)
     }
   }
   result = AtomInfoUniquefyNames(I->G, NULL, 0, I->AtomInfo.data(), flag, I->NAtom);
+  I->atomPropertiesChanged();
   return result;
 }
 
@@ -7593,7 +7600,7 @@ ObjectMolecule *ObjectMoleculeLoadCoords(PyMOLGlobals * G, ObjectMolecule * I,
     cset->Coord[a] = coords[a];
   }
 
-  cset->invalidateRep(cRepAll, cRepInvRep);
+  cset->invalidateRep(cRepAll, cRepInvCoord);
 
   // include coordinate set
   if (is_new) {
@@ -7697,7 +7704,7 @@ ObjectMolecule *ObjectMoleculeLoadCoords(PyMOLGlobals * G, ObjectMolecule * I,
     ok_assert(2, !PyErr_Occurred());
   }
 
-  cset->invalidateRep(cRepAll, cRepInvRep);
+  cset->invalidateRep(cRepAll, cRepInvCoord);
 
   // include coordinate set
   if (is_new) {
@@ -9199,7 +9206,7 @@ void ObjectMoleculeTransformTTTf(ObjectMolecule * I, float *ttt, int frame)
 /*========================================================================*/
 bool ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op)
 {
-  float *coord;
+  const float *coord;
   int a, b, s;
   int c, d, t_i;
   int a1 = 0, ind;
@@ -9910,23 +9917,25 @@ bool ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op
               }
 							/* if valid coordinate set and atom info for this atom */
               if(cs && (a1 >= 0)) {
-                coord = cs->coordPtr(a1);
-                if(op_i2) {     /* do we want transformed coordinates? */
-                  if(use_matrices) {
-                    if(!cs->Matrix.empty()) {      /* state transformation */
-                      transform44d3f(cs->Matrix.data(), coord, v1);
+                for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                  coord = cs->instanceCoordPtr(a1, k, v1);
+                  if(op_i2) {     /* do we want transformed coordinates? */
+                    if(use_matrices) {
+                      if(!cs->Matrix.empty()) {      /* state transformation */
+                        transform44d3f(cs->Matrix.data(), coord, v1);
+                        coord = v1;
+                      }
+                    }
+                    if(obj_TTTFlag) {
+                      transformTTT44f3f(I->TTT, coord, v1);
                       coord = v1;
                     }
                   }
-                  if(obj_TTTFlag) {
-                    transformTTT44f3f(I->TTT, coord, v1);
-                    coord = v1;
-                  }
+                  /* op_v1 += coord */
+                  add3f(op_v1, coord, op_v1);
+                  /* count += 1 */
+                  op_i1++;
                 }
-								/* op_v1 += coord */
-                add3f(op_v1, coord, op_v1);
-								/* count += 1 */
-                op_i1++;
               }
               if(i_DiscreteFlag)
                 break;
@@ -9967,41 +9976,43 @@ bool ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op
                   a1 = cs->AtmToIdx[a];
               }
               if(cs && (a1 >= 0)) {
-                coord = cs->coordPtr(a1);
-                if(op_i2) {     /* do we want transformed coordinates? */
-                  if(use_matrices) {
-                    if(!cs->Matrix.empty()) {      /* state transformation */
-                      transform44d3f(cs->Matrix.data(), coord, v1);
+                for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                  coord = cs->instanceCoordPtr(a1, k, v1);
+                  if(op_i2) {     /* do we want transformed coordinates? */
+                    if(use_matrices) {
+                      if(!cs->Matrix.empty()) {      /* state transformation */
+                        transform44d3f(cs->Matrix.data(), coord, v1);
+                        coord = v1;
+                      }
+                    }
+                    if(obj_TTTFlag) {
+                      transformTTT44f3f(I->TTT, coord, v1);
                       coord = v1;
                     }
                   }
-                  if(obj_TTTFlag) {
-                    transformTTT44f3f(I->TTT, coord, v1);
-                    coord = v1;
-                  }
-                }
-                if(op_i1) {
-                  if(op_v1[0] > coord[0])
+                  if(op_i1) {
+                    if(op_v1[0] > coord[0])
+                      op_v1[0] = coord[0];
+                    if(op_v1[1] > coord[1])
+                      op_v1[1] = coord[1];
+                    if(op_v1[2] > coord[2])
+                      op_v1[2] = coord[2];
+                    if(op_v2[0] < coord[0])
+                      op_v2[0] = coord[0];
+                    if(op_v2[1] < coord[1])
+                      op_v2[1] = coord[1];
+                    if(op_v2[2] < coord[2])
+                      op_v2[2] = coord[2];
+                  } else {
                     op_v1[0] = coord[0];
-                  if(op_v1[1] > coord[1])
                     op_v1[1] = coord[1];
-                  if(op_v1[2] > coord[2])
                     op_v1[2] = coord[2];
-                  if(op_v2[0] < coord[0])
                     op_v2[0] = coord[0];
-                  if(op_v2[1] < coord[1])
                     op_v2[1] = coord[1];
-                  if(op_v2[2] < coord[2])
                     op_v2[2] = coord[2];
-                } else {
-                  op_v1[0] = coord[0];
-                  op_v1[1] = coord[1];
-                  op_v1[2] = coord[2];
-                  op_v2[0] = coord[0];
-                  op_v2[1] = coord[1];
-                  op_v2[2] = coord[2];
+                  }
+                  op_i1++;
                 }
-                op_i1++;
               }
               if(i_DiscreteFlag)
                 break;
@@ -10246,149 +10257,162 @@ bool ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op
                 case OMOP_CSetSumVertices:
                   a1 = cs->atmToIdx(a);
                   if(a1 >= 0) {
-                    coord = cs->coordPtr(a1);
-                    if(op->i2) {        /* do we want transformed coordinates? */
-                      if(use_matrices) {
-                        if(!cs->Matrix.empty()) {  /* state transformation */
-                          transform44d3f(cs->Matrix.data(), coord, v1);
+                    for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                      coord = cs->instanceCoordPtr(a1, k, v1);
+                      if(op->i2) {        /* do we want transformed coordinates? */
+                        if(use_matrices) {
+                          if(!cs->Matrix.empty()) {  /* state transformation */
+                            transform44d3f(cs->Matrix.data(), coord, v1);
+                            coord = v1;
+                          }
+                        }
+                        if(I->TTTFlag) {
+                          transformTTT44f3f(I->TTT, coord, v1);
                           coord = v1;
                         }
                       }
-                      if(I->TTTFlag) {
-                        transformTTT44f3f(I->TTT, coord, v1);
-                        coord = v1;
-                      }
+                      add3f(op->v1, coord, op->v1);
+                      op->i1++;
                     }
-                    add3f(op->v1, coord, op->v1);
-                    op->i1++;
                   }
                   break;
                 case OMOP_CSetMinMax:
                   a1 = cs->atmToIdx(a);
                   if(a1 >= 0) {
-                    coord = cs->coordPtr(a1);
-                    if(op->i2) {        /* do we want transformed coordinates? */
-                      if(use_matrices) {
-                        if(!cs->Matrix.empty()) {  /* state transformation */
-                          transform44d3f(cs->Matrix.data(), coord, v1);
+                    for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                      coord = cs->instanceCoordPtr(a1, k, v1);
+                      if(op->i2) {        /* do we want transformed coordinates? */
+                        if(use_matrices) {
+                          if(!cs->Matrix.empty()) {  /* state transformation */
+                            transform44d3f(cs->Matrix.data(), coord, v1);
+                            coord = v1;
+                          }
+                        }
+                        if(I->TTTFlag) {
+                          transformTTT44f3f(I->TTT, coord, v1);
                           coord = v1;
                         }
                       }
-                      if(I->TTTFlag) {
-                        transformTTT44f3f(I->TTT, coord, v1);
-                        coord = v1;
-                      }
-                    }
-                    if(op->i1) {
-                      for(c = 0; c < 3; c++) {
-                        if(*(op->v1 + c) > *(coord + c))
+                      if(op->i1) {
+                        for(c = 0; c < 3; c++) {
+                          if(*(op->v1 + c) > *(coord + c))
+                            *(op->v1 + c) = *(coord + c);
+                          if(*(op->v2 + c) < *(coord + c))
+                            *(op->v2 + c) = *(coord + c);
+                        }
+                      } else {
+                        for(c = 0; c < 3; c++) {
                           *(op->v1 + c) = *(coord + c);
-                        if(*(op->v2 + c) < *(coord + c))
                           *(op->v2 + c) = *(coord + c);
+                        }
                       }
-                    } else {
-                      for(c = 0; c < 3; c++) {
-                        *(op->v1 + c) = *(coord + c);
-                        *(op->v2 + c) = *(coord + c);
-                      }
+                      op->i1++;
                     }
-                    op->i1++;
                   }
                   break;
                 case OMOP_CSetCameraMinMax:
                   a1 = cs->atmToIdx(a);
                   if(a1 >= 0) {
-                    coord = cs->coordPtr(a1);
-                    if(op->i2) {        /* do we want transformed coordinates? */
-                      if(use_matrices) {
-                        if(!cs->Matrix.empty()) {  /* state transformation */
-                          transform44d3f(cs->Matrix.data(), coord, v1);
+                    for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                      coord = cs->instanceCoordPtr(a1, k, v1);
+                      if(op->i2) {        /* do we want transformed coordinates? */
+                        if(use_matrices) {
+                          if(!cs->Matrix.empty()) {  /* state transformation */
+                            transform44d3f(cs->Matrix.data(), coord, v1);
+                            coord = v1;
+                          }
+                        }
+                        if(I->TTTFlag) {
+                          transformTTT44f3f(I->TTT, coord, v1);
                           coord = v1;
                         }
                       }
-                      if(I->TTTFlag) {
-                        transformTTT44f3f(I->TTT, coord, v1);
-                        coord = v1;
-                      }
-                    }
-                    MatrixTransformC44fAs33f3f(op->mat1, coord, v1);
-                    /* convert to view-space */
-                    coord = v1;
-                    if(op->i1) {
-                      for(c = 0; c < 3; c++) {
-                        if(*(op->v1 + c) > *(coord + c))
+                      MatrixTransformC44fAs33f3f(op->mat1, coord, v1);
+                      /* convert to view-space */
+                      coord = v1;
+                      if(op->i1) {
+                        for(c = 0; c < 3; c++) {
+                          if(*(op->v1 + c) > *(coord + c))
+                            *(op->v1 + c) = *(coord + c);
+                          if(*(op->v2 + c) < *(coord + c))
+                            *(op->v2 + c) = *(coord + c);
+                        }
+                      } else {
+                        for(c = 0; c < 3; c++) {
                           *(op->v1 + c) = *(coord + c);
-                        if(*(op->v2 + c) < *(coord + c))
                           *(op->v2 + c) = *(coord + c);
+                        }
                       }
-                    } else {
-                      for(c = 0; c < 3; c++) {
-                        *(op->v1 + c) = *(coord + c);
-                        *(op->v2 + c) = *(coord + c);
-                      }
+                      op->i1++;
                     }
-                    op->i1++;
                   }
                   break;
                 case OMOP_CSetSumSqDistToPt:
                   a1 = cs->atmToIdx(a);
                   if(a1 >= 0) {
                     float dist;
-                    coord = cs->coordPtr(a1);
-                    if(op->i2) {        /* do we want transformed coordinates? */
-                      if(use_matrices) {
-                        if(!cs->Matrix.empty()) {  /* state transformation */
-                          transform44d3f(cs->Matrix.data(), coord, v1);
+                    for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                      coord = cs->instanceCoordPtr(a1, k, v1);
+                      if(op->i2) {        /* do we want transformed coordinates? */
+                        if(use_matrices) {
+                          if(!cs->Matrix.empty()) {  /* state transformation */
+                            transform44d3f(cs->Matrix.data(), coord, v1);
+                            coord = v1;
+                          }
+                        }
+                        if(I->TTTFlag) {
+                          transformTTT44f3f(I->TTT, coord, v1);
                           coord = v1;
                         }
                       }
-                      if(I->TTTFlag) {
-                        transformTTT44f3f(I->TTT, coord, v1);
-                        coord = v1;
-                      }
+                      dist = (float) diff3f(op->v1, coord);
+                      op->d1 += dist * dist;
+                      op->i1++;
                     }
-                    dist = (float) diff3f(op->v1, coord);
-                    op->d1 += dist * dist;
-                    op->i1++;
                   }
                   break;
                 case OMOP_CSetMaxDistToPt:
                   a1 = cs->atmToIdx(a);
                   if(a1 >= 0) {
                     float dist;
-                    coord = cs->coordPtr(a1);
-                    if(op->i2) {        /* do we want transformed coordinates? */
-                      if(use_matrices) {
-                        if(!cs->Matrix.empty()) {  /* state transformation */
-                          transform44d3f(cs->Matrix.data(), coord, v1);
+                    for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                      coord = cs->instanceCoordPtr(a1, k, v1);
+                      if(op->i2) {        /* do we want transformed coordinates? */
+                        if(use_matrices) {
+                          if(!cs->Matrix.empty()) {  /* state transformation */
+                            transform44d3f(cs->Matrix.data(), coord, v1);
+                            coord = v1;
+                          }
+                        }
+                        if(I->TTTFlag) {
+                          transformTTT44f3f(I->TTT, coord, v1);
                           coord = v1;
                         }
                       }
-                      if(I->TTTFlag) {
-                        transformTTT44f3f(I->TTT, coord, v1);
-                        coord = v1;
-                      }
+                      dist = (float) diff3f(op->v1, coord);
+                      if(dist > op->f1)
+                        op->f1 = dist;
+                      op->i1++;
                     }
-                    dist = (float) diff3f(op->v1, coord);
-                    if(dist > op->f1)
-                      op->f1 = dist;
-                    op->i1++;
                   }
                   break;
                 case OMOP_CSetMoment:
                   a1 = cs->atmToIdx(a);
                   if(a1 >= 0) {
-                    subtract3f(cs->coordPtr(a1), op->v1, v1);
-                    v2 = v1[0] * v1[0] + v1[1] * v1[1] + v1[2] * v1[2];
-                    op->d[0][0] += v2 - v1[0] * v1[0];
-                    op->d[0][1] += -v1[0] * v1[1];
-                    op->d[0][2] += -v1[0] * v1[2];
-                    op->d[1][0] += -v1[1] * v1[0];
-                    op->d[1][1] += v2 - v1[1] * v1[1];
-                    op->d[1][2] += -v1[1] * v1[2];
-                    op->d[2][0] += -v1[2] * v1[0];
-                    op->d[2][1] += -v1[2] * v1[1];
-                    op->d[2][2] += v2 - v1[2] * v1[2];
+                    for(int k = 0, n_inst = cs->instanceCount(); k < n_inst; ++k) {
+                      coord = cs->instanceCoordPtr(a1, k, v1);
+                      subtract3f(coord, op->v1, v1);
+                      v2 = v1[0] * v1[0] + v1[1] * v1[1] + v1[2] * v1[2];
+                      op->d[0][0] += v2 - v1[0] * v1[0];
+                      op->d[0][1] += -v1[0] * v1[1];
+                      op->d[0][2] += -v1[0] * v1[2];
+                      op->d[1][0] += -v1[1] * v1[0];
+                      op->d[1][1] += v2 - v1[1] * v1[1];
+                      op->d[1][2] += -v1[1] * v1[2];
+                      op->d[2][0] += -v1[2] * v1[0];
+                      op->d[2][1] += -v1[2] * v1[1];
+                      op->d[2][2] += v2 - v1[2] * v1[2];
+                    }
                   }
                   break;
 
@@ -10620,6 +10644,19 @@ bool ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op
     }
 
     /* always run on exit... */
+    switch (op->code) {
+    case OMOP_Flag:
+    case OMOP_FlagSet:
+    case OMOP_FlagClear:
+    case OMOP_COLR:
+    case OMOP_VISI:
+    case OMOP_Spectrum:
+    case OMOP_PrepareFromTemplate:
+    case OMOP_LABL:
+      I->atomColumnsChanged();
+      break;
+    }
+
     switch (op->code) {
     case OMOP_LABL:
       if (op->i2 != cExecutiveLabelEvalOn){
@@ -10700,64 +10737,24 @@ int ObjectMolecule::getNFrame() const
   return NCSet;
 }
 
-struct _CCoordSetUpdateThreadInfo {
-  CoordSet *cs;
-  int a;
-};
-
-void CoordSetUpdateThread(CCoordSetUpdateThreadInfo * T)
-{
-  if(T->cs) {
-    T->cs->update(T->a);
-  }
-}
-
-#ifndef _PYMOL_NOPY
-static void ObjMolCoordSetUpdateSpawn(PyMOLGlobals * G,
-                                      CCoordSetUpdateThreadInfo * Thread, int n_thread,
-                                      int n_total)
-{
-  if(n_total == 1) {
-    CoordSetUpdateThread(Thread);
-  } else if(n_total) {
-    int blocked;
-    PyObject *info_list;
-    int a, n = 0;
-    blocked = PAutoBlock(G);
-
-    PRINTFB(G, FB_Scene, FB_Blather)
-      " Scene: updating coordinate sets with %d threads...\n", n_thread ENDFB(G);
-    info_list = PyList_New(n_total);
-    for(a = 0; a < n_total; a++) {
-      PyList_SetItem(info_list, a, PyCapsule_New(Thread + a, nullptr, nullptr));
-      n++;
-    }
-    PXDecRef(PYOBJECT_CALLMETHOD
-             (G->P_inst->cmd, "_coordset_update_spawn", "Oi", info_list, n_thread));
-    Py_DECREF(info_list);
-    PAutoUnblock(G, blocked);
-  }
-}
-#endif
-
-
 /*========================================================================*/
-void ObjectMolecule::update()
+void ObjectMolecule::prepareUpdate(int& start, int& stop)
 {
   auto I = this;
-  int a; /*, ok; */
+  int a;
 
   OrthoBusyPrime(G);
   /* if the cached representation is invalid, reset state */
+  /* refresh before coordinate sets (possibly in threads) read them */
+  const AtomInfoColumns& columns = I->getAtomColumns();
+
   if(!I->RepVisCacheValid) {
     /* note which representations are active */
     /* for each atom in each coordset, blank out the representation cache */
     if(I->NCSet > 1) {
-      const AtomInfoType *ai = I->AtomInfo.data();
       I->RepVisCache = 0;
       for(a = 0; a < I->NAtom; a++) {
-        I->RepVisCache |= ai->visRep;
-        ai++;
+        I->RepVisCache |= columns.visRep[a];
       }
     } else {
       I->RepVisCache = cRepBitmask;     /* if only one coordinate set, then
@@ -10766,76 +10763,84 @@ void ObjectMolecule::update()
     }
     I->RepVisCacheValid = true;
   }
-  {
-    /* determine the start/stop states */
-    int start = 0;
-    int stop = I->NCSet;
-    /* set start and stop given an object */
-    ObjectAdjustStateRebuildRange(I, &start, &stop);
-    if((I->NCSet == 1)
-       && (SettingGet_b(G, I->Setting, NULL, cSetting_static_singletons))) {
-      start = 0;
-      stop = 1;
-    }
-    if(stop > I->NCSet)
-      stop = I->NCSet;
 
-    /* single and multithreaded coord set updates */
-    {
-#ifndef _PYMOL_NOPY
-      int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
-      int multithread = SettingGetGlobal_i(G, cSetting_async_builds);
+  /* determine the start/stop states */
+  start = 0;
+  stop = I->NCSet;
+  /* set start and stop given an object */
+  ObjectAdjustStateRebuildRange(I, &start, &stop);
+  if((I->NCSet == 1)
+     && (SettingGet_b(G, I->Setting, NULL, cSetting_static_singletons))) {
+    start = 0;
+    stop = 1;
+  }
+  if(stop > I->NCSet)
+    stop = I->NCSet;
+  if(I->TrajStream)
+    TrajStreamUpdateRange(I->TrajStream, &start, &stop);
 
-      if(multithread && (n_thread) && (stop - start) > 1) {
-        int cnt = 0;
+  /* if the unit cell is shown, redraw it */
+  if((I->visRep & cRepCellBit)) {
+    if (I->Symmetry) {
+      CGOFree(I->UnitCellCGO);
+      I->UnitCellCGO = CrystalGetUnitCellCGO(&I->Symmetry->Crystal);
+    }
+  }
+}
 
-        ObjectMoleculeUpdateNeighbors(I);
-        /* must precalculate to avoid race-condition since this isn't
-           mutexed yet and neighbors are needed by cartoons */
+/*========================================================================*/
+void ObjectMolecule::addUpdateTasks(pymol::TaskGraph& graph)
+{
+  int start, stop;
+  prepareUpdate(start, stop);
 
-        for(a = start; a < stop; a++)
-          if((a<I->NCSet) && I->CSet[a])
-            cnt++;
-        {
-          CCoordSetUpdateThreadInfo *thread_info = pymol::malloc<CCoordSetUpdateThreadInfo>(cnt);
-          if(thread_info) {
-            cnt = 0;
-            for(a = start; a < stop; a++) {
-              if((a<I->NCSet) && I->CSet[a]) {
-                thread_info[cnt].cs = I->CSet[a];
-                thread_info[cnt].a = a;
-                cnt++;
-              }
-            }
-            ObjMolCoordSetUpdateSpawn(G, thread_info, n_thread, cnt);
-            FreeP(thread_info);
-          }
+  pymol::TaskGraph::TaskId neighbors = 0;
+  bool have_neighbors = false;
 
-        }
+  for(int a = start; a < stop; a++) {
+    if(!CSet[a])
+      continue;
 
-      } else
-#endif
-      {                         /* single thread */
-        for(a = start; a < stop; a++) {
-          if((a<I->NCSet) && I->CSet[a] && (!G->Interrupt)) {
-	    /* status bar */
-            OrthoBusySlow(G, a, I->NCSet);
-            PRINTFB(G, FB_ObjectMolecule, FB_Blather)
-              " ObjectMolecule-DEBUG: updating representations for state %d of \"%s\".\n",
-              a + 1, I->Name ENDFB(G);
-            I->CSet[a]->update(a);
-          }
-        }
-      }
+    /* neighbors are needed by cartoons, update them once before the
+       representations get built concurrently */
+    if(!have_neighbors) {
+      neighbors = graph.add([this] { ObjectMoleculeUpdateNeighbors(this); });
+      have_neighbors = true;
     }
-    /* if the unit cell is shown, redraw it */
-    if((I->visRep & cRepCellBit)) {
-      if (I->Symmetry) {
-        CGOFree(I->UnitCellCGO);
-        I->UnitCellCGO = CrystalGetUnitCellCGO(&I->Symmetry->Crystal);
+
+    CSet[a]->addUpdateTasks(graph, a, neighbors);
+  }
+}
+
+/*========================================================================*/
+void ObjectMolecule::update()
+{
+  auto I = this;
+
+  int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
+  if(SettingGetGlobal_i(G, cSetting_async_builds) && n_thread > 1) {
+    /* coordinate set updates on the worker threads */
+    pymol::TaskGraph graph;
+    addUpdateTasks(graph);
+    graph.run(*G->ThreadPool, n_thread);
+    SceneInvalidatePicking(G);
+    SceneInvalidate(G);
+  } else {
+    int start, stop;
+    prepareUpdate(start, stop);
+
+    /* single thread */
+    for(int a = start; a < stop; a++) {
+      if(I->CSet[a] && (!G->Interrupt)) {
+        /* status bar */
+        OrthoBusySlow(G, a, I->NCSet);
+        PRINTFB(G, FB_ObjectMolecule, FB_Blather)
+          " ObjectMolecule-DEBUG: updating representations for state %d of \"%s\".\n",
+          a + 1, I->Name ENDFB(G);
+        I->CSet[a]->update(a);
       }
     }
-  } /* end block */
+  }
 
   PRINTFD(G, FB_ObjectMolecule)
     " ObjectMolecule: updates complete for object %s.\n", I->Name ENDFD;
@@ -10844,6 +10849,7 @@ void ObjectMolecule::update()
 /*========================================================================*/
 void ObjectMolecule::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   auto I = this;
   int a;
   PRINTFD(I->G, FB_ObjectMolecule)
@@ -10853,6 +10859,14 @@ void ObjectMolecule::invalidate(int rep, int level, int state)
     I->RepVisCacheValid = false;
   }
 
+  if(level >= cRepInvColor && level != cRepInvCoord) {
+    I->atomColumnsChanged();
+  }
+
+  if(level >= cRepInvProp && level != cRepInvCoord) {
+    I->atomPropertiesChanged();
+  }
+
   if (level >= cRepInvBondsNoNonbonded) {
     if (level < cRepInvBonds) {
       level = cRepInvBonds;
@@ -11289,7 +11303,17 @@ void ObjectMolecule::render(RenderInfo * info)
     if(cs) {
       if(use_matrices)
         pop_matrix = ObjectStatePushAndApplyMatrix(cs, info);
-      cs->render(info);
+      if(cs->Instances.empty()) {
+        cs->render(info);
+      } else {
+        /* instanced assembly: same reps, one transformed copy per operator */
+        for(const auto& matrix : cs->Instances) {
+          int pop_instance = ObjectPushAndApplyMatrix(G, info, matrix.data());
+          cs->render(info);
+          if(pop_instance)
+            ObjectPopMatrix(G, info);
+        }
+      }
       if(pop_matrix)
         ObjectStatePopMatrix(cs, info);
     }
@@ -11409,6 +11433,7 @@ ObjectMolecule::ObjectMolecule(PyMOLGlobals * G, int discreteFlag) : CObject(G)
     I->UndoState[a] = -1;
   }
   I->UndoIter = 0;
+  I->atomPropertiesChanged();
 }
 
 
@@ -11431,12 +11456,15 @@ void ObjectMoleculeCopyNoAlloc(const ObjectMolecule* obj, ObjectMolecule* I)
 
   I->ViewElem = NULL;
   I->gridSlotSelIndicatorsCGO = NULL;
+  I->TrajStream = NULL;         /* copy reads all states into memory */
+  I->atomPropertiesChanged();
 
   for(a = 0; a <= cUndoMask; a++)
     I->UndoCoord[a] = NULL;
   I->CSet = pymol::vla<CoordSet*>(I->NCSet);   /* auto-zero */
   for(a = 0; a < I->NCSet; a++) {
-    I->CSet[a] = CoordSetCopy(obj->CSet[a]);
+    I->CSet[a] = obj->TrajStream ? TrajStreamCopyState(obj->TrajStream, a)
+                                 : CoordSetCopy(obj->CSet[a]);
     if (I->CSet[a])
       I->CSet[a]->Obj = I;
   }
@@ -11514,6 +11542,7 @@ ObjectMolecule::~ObjectMolecule()
   auto I = this;
   int a;
   SelectorPurgeObjectMembers(I->G, I);
+  delete I->TrajStream;
   for(a = 0; a < I->NCSet; a++){
     if(I->CSet[a]) {
       I->CSet[a]->fFree();
@@ -12083,6 +12112,34 @@ bool ObjectMolecule::atomHasAnyCoordinates(size_t atm) const
   return false;
 }
 
+/**
+ * Renew AtomGeneration. Must be called after modifying atom identifiers
+ * (name, resi, chain, ...), unless the object gets invalidated with
+ * cRepInvProp or higher anyway.
+ */
+void ObjectMolecule::atomPropertiesChanged()
+{
+  static std::atomic<unsigned> counter{0};
+  AtomGeneration = ++counter;
+  atomColumnsChanged();
+}
+
+/**
+ * Structure-of-arrays copy of visRep, color, flags and protons for all
+ * atoms, refreshed on demand after atomColumnsChanged().
+ *
+ * Not thread-safe when stale. ObjectMolecule::update() refreshes the columns
+ * before any coordinate set gets updated, so representation builders (which
+ * may run concurrently for several states) only read them.
+ */
+const AtomInfoColumns& ObjectMolecule::getAtomColumns()
+{
+  if(!AtomColumns.valid || AtomColumns.size() != size_t(NAtom)) {
+    AtomColumns.assign(AtomInfo.data(), NAtom);
+  }
+  return AtomColumns;
+}
+
 CObject* ObjectMolecule::clone() const
 {
   return ObjectMoleculeCopy(this);
@@ -95,12 +95,32 @@ struct ObjectMolecule : public CObject {
   // hetatm and ignore-flag by non-polymer classification
   bool need_hetatm_classification = false;
 
+  // on-demand trajectory states (not copied with the object)
+  struct CTrajStream *TrajStream = nullptr;
+
+  // unique stamp, renewed whenever atom properties may have changed
+  // (for caching selection results)
+  unsigned AtomGeneration = 0;
+
+  // dense copies of hot atom fields (not stored), see getAtomColumns()
+  AtomInfoColumns AtomColumns;
+
   // methods
   ObjectMolecule(PyMOLGlobals* G, int discreteFlag);
   ~ObjectMolecule();
   bool setNDiscrete(int natom);
   bool updateAtmToIdx();
   bool atomHasAnyCoordinates(size_t atm) const;
+  void atomPropertiesChanged();
+  const AtomInfoColumns& getAtomColumns();
+
+  /// Must be called after modifying visRep, color, flags or protons of any
+  /// atom, unless the object gets invalidated with cRepInvColor or higher
+  void atomColumnsChanged() { AtomColumns.valid = false; }
+
+  /// Refresh what the (possibly concurrent) coordinate set updates read, and
+  /// get the range of states to update
+  void prepareUpdate(int& start, int& stop);
 
   /// Typed version of getObjectState
   CoordSet* getCoordSet(int state);
@@ -108,6 +128,7 @@ struct ObjectMolecule : public CObject {
 
   // virtual methods
   void update() override;
+  void addUpdateTasks(pymol::TaskGraph& graph) override;
   void render(RenderInfo* info) override;
   void invalidate(int rep, int level, int state) override;
   int getNFrame() const override;
@@ -40,6 +40,8 @@
 #include"ObjectCGO.h"
 #include"Scene.h"
 #include "Lex.h"
+#include "ThreadPool.h"
+#include "TrajStream.h"
 
 #include"AtomInfoHistory.h"
 #include"BondTypeHistory.h"
@@ -551,47 +553,37 @@ int ObjectMoleculeGetNearestBlendedColor(ObjectMolecule * I, const float *point,
 
   {
     if(cs) {
-      MapType *map;
-      CoordSetUpdateCoord2IdxMap(cs, cutoff);
+      const pymol::SpatialHash *map = CoordSetUpdateCoord2IdxMap(cs, cutoff);
       if(sub_vdw) {
         cutoff -= MAX_VDW;
         cutoff2 = cutoff * cutoff;
       }
       nearest = cutoff2;
-      if((map = cs->Coord2Idx)) {
-        int a, b, c, d, e, f, j;
+      if(map) {
         float test;
-        float *v;
-        MapLocus(map, point, &a, &b, &c);
-        for(d = a - 1; d <= a + 1; d++)
-          for(e = b - 1; e <= b + 1; e++)
-            for(f = c - 1; f <= c + 1; f++) {
-              j = *(MapFirst(map, d, e, f));
-              while(j >= 0) {
-                v = cs->coordPtr(j);
-                test = diffsq3f(v, point);
-                if(sub_vdw) {
-                  test = sqrt1f(test);
-                  test -= I->AtomInfo[cs->IdxToAtm[j]].vdw;
-                  if(test < 0.0F)
-                    test = 0.0F;
-                  test = test * test;
-                }
-                if(test < cutoff2) {
-                  float weight = cutoff - sqrt1f(test);
-                  const float *at_col = ColorGet(I->G, I->AtomInfo[cs->IdxToAtm[j]].color);
-                  color[0] += at_col[0] * weight;
-                  color[1] += at_col[1] * weight;
-                  color[2] += at_col[2] * weight;
-                  tot_weight += weight;
-                }
-                if(test <= nearest) {
-                  result = j;
-                  nearest = test;
-                }
-                j = MapNext(map, j);
-              }
-            }
+        for(auto it = map->query(point); it != it.end(); ++it) {
+          int j = *it;
+          test = diffsq3f(it.coord(), point);
+          if(sub_vdw) {
+            test = sqrt1f(test);
+            test -= I->AtomInfo[cs->IdxToAtm[j]].vdw;
+            if(test < 0.0F)
+              test = 0.0F;
+            test = test * test;
+          }
+          if(test < cutoff2) {
+            float weight = cutoff - sqrt1f(test);
+            const float *at_col = ColorGet(I->G, I->AtomInfo[cs->IdxToAtm[j]].color);
+            color[0] += at_col[0] * weight;
+            color[1] += at_col[1] * weight;
+            color[2] += at_col[2] * weight;
+            tot_weight += weight;
+          }
+          if(test <= nearest) {
+            result = j;
+            nearest = test;
+          }
+        }
       } else {
         int j;
         float test;
@@ -650,28 +642,17 @@ int ObjectMoleculeGetNearestAtomIndex(ObjectMolecule * I, const float *point, fl
 
   {
     if(cs) {
-      MapType *map;
-      CoordSetUpdateCoord2IdxMap(cs, cutoff);
+      const pymol::SpatialHash *map = CoordSetUpdateCoord2IdxMap(cs, cutoff);
       nearest = cutoff * cutoff;
-      if((map = cs->Coord2Idx)) {
-        int a, b, c, d, e, f, j;
+      if(map) {
         float test;
-        float *v;
-        MapLocus(map, point, &a, &b, &c);
-        for(d = a - 1; d <= a + 1; d++)
-          for(e = b - 1; e <= b + 1; e++)
-            for(f = c - 1; f <= c + 1; f++) {
-              j = *(MapFirst(map, d, e, f));
-              while(j >= 0) {
-                v = cs->coordPtr(j);
-                test = diffsq3f(v, point);
-                if(test <= nearest) {
-                  result = j;
-                  nearest = test;
-                }
-                j = MapNext(map, j);
-              }
-            }
+        for(auto it = map->query(point); it != it.end(); ++it) {
+          test = diffsq3f(it.coord(), point);
+          if(test <= nearest) {
+            result = *it;
+            nearest = test;
+          }
+        }
       } else {
         int j;
         float test;
@@ -3036,6 +3017,12 @@ static PyObject *ObjectMoleculeCSetAsPyList(ObjectMolecule * I)
   for(a = 0; a < I->NCSet; a++) {
     if(I->CSet[a]) {
       PyList_SetItem(result, a, CoordSetAsPyList(I->CSet[a]));
+    } else if(I->TrajStream && I->TrajStream->hasState(a)) {
+      /* not resident: save a temporary copy read from the trajectory */
+      CoordSet *cs = TrajStreamCopyState(I->TrajStream, a);
+      PyList_SetItem(result, a, cs ? CoordSetAsPyList(cs) : PConvAutoNone(Py_None));
+      if(cs)
+        cs->fFree();
     } else {
       PyList_SetItem(result, a, PConvAutoNone(Py_None));
     }
@@ -3694,6 +3681,73 @@ bool is_distance_bonded(
   return true;
 }
 
+/*
+ * Candidate bond from the distance search, in coordinate set index space
+ */
+struct DistanceBondCandidate {
+  int i, j;
+};
+
+// minimum number of coordinates per task in the parallel bond search. Small
+// enough that little work is wasted when the search stops early.
+static const int cConnectMinIndexPerTask = 5000;
+
+/*
+ * Distance-based bond search for the coordinates [i_begin, i_end) of `cs`.
+ * Appends candidates to `out` in the same order as a serial search over all
+ * coordinates would find them. Doesn't modify anything else, so ranges can be
+ * searched concurrently.
+ */
+static void find_distance_bonds(PyMOLGlobals* G, const CoordSet* cs,
+    const AtomInfoType* ai, MapType* map, int i_begin, int i_end, float cutoff,
+    int connect_mode, int discrete_chains, bool connect_bonded,
+    bool unbond_cations, std::vector<DistanceBondCandidate>& out)
+{
+  const int dim12 = map->D1D2;
+  const int dim2 = map->Dim[2];
+  const int* const link = map->Link;
+  const int* const idx_to_atm = cs->IdxToAtm.data();
+  const float* const coord = cs->Coord.data();
+
+  for (int i = i_begin; i < i_end; ++i) {
+    const float* v1 = coord + 3 * i;
+    const AtomInfoType* ai1 = ai + idx_to_atm[i];
+    int a, b, c;
+
+    // upper bound of the bond length (without ai2->vdw), for rejecting
+    // pairs before the exact test. 0.2 is the largest
+    // connect_cutoff_adjustment, 0.01 covers rounding.
+    const float max_dist1 = cutoff + 0.2f + 0.01f + ai1->vdw / 2;
+
+    MapLocus(map, v1, &a, &b, &c);
+
+    for (int d = a - 1; d <= a + 1; ++d) {
+      const int* j_ptr1 = map->Head + d * dim12 + (b - 1) * dim2;
+      for (int e = b - 1; e <= b + 1; ++e) {
+        const int* j_ptr2 = j_ptr1 + c - 1;
+        j_ptr1 += dim2;
+        for (int f = c - 1; f <= c + 1; ++f) {
+          for (int j = *(j_ptr2++); j >= 0; j = link[j]) {
+            if (i >= j)
+              continue;
+
+            const float* v2 = coord + 3 * j;
+            const AtomInfoType* ai2 = ai + idx_to_atm[j];
+            const float max_dist = max_dist1 + ai2->vdw / 2;
+
+            if (diffsq3f(v1, v2) <= max_dist * max_dist &&
+                is_distance_bonded(G, cs, ai1, ai2, v1, v2, cutoff,
+                    connect_mode, discrete_chains, connect_bonded,
+                    unbond_cations)) {
+              out.push_back({i, j});
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 /**
  * Do bonding of atoms in `I`, using distances and/or temporary bonds in `cs`.
  *
@@ -3727,14 +3781,12 @@ bool ObjectMoleculeConnect(ObjectMolecule* I, int& nBond, pymol::vla<BondType>&
 {
 #define cMULT 1
   PyMOLGlobals *G = I->G;
-  int a, b, c, d, e, f, i, j;
+  int a, i, j;
   int a1, a2;
-  float *v1, *v2;
   int maxBond;
   MapType *map;
   BondType *ii1;
   const BondType* ii2;
-  int flag;
   int order;
   AtomInfoType* const ai = I->AtomInfo.data();
   AtomInfoType *ai1, *ai2;
@@ -3816,86 +3868,85 @@ bool ObjectMoleculeConnect(ObjectMolecule* I, int& nBond, pymol::vla<BondType>&
 	    map = MapNew(G, max_cutoff + MAX_VDW, cs->Coord, cs->NIndex, NULL);
 	  CHECKOK(ok, map);
           if(ok) {
-            int dim12 = map->D1D2;
-            int dim2 = map->Dim[2];
-
-            for(i = 0; ok && i < cs->NIndex; i++) {
-              if(nBond > maxBond)
-                break;
-	      /* atom i's position in space */
-              v1 = cs->coordPtr(i);
-
-              a1 = cs->IdxToAtm[i];
-              ai1 = ai + a1;
-
-              MapLocus(map, v1, &a, &b, &c);
-	      /* d = [a-1, a, a+1] */
-              for(d = a - 1; ok && d <= a + 1; d++) {
-                int *j_ptr1 = map->Head + d * dim12 + (b - 1) * dim2;
-		/* e = [b-1, b, b+1] */
-                for(e = b - 1; ok && e <= b + 1; e++) {
-                  int *j_ptr2 = j_ptr1 + c - 1;
-                  j_ptr1 += dim2;
-		  /* f = [c-1, c, c+1] */
-                  for(f = c - 1; ok && f <= c + 1; f++) {
-                    j = *(j_ptr2++);    /*  *MapFirst(map,d,e,f)); */
-                    while(ok && j >= 0) {
-                      if(i < j) {
-			/* position in space for atom 2 */
-                        v2 = cs->coordPtr(j);
-                        a2 = cs->IdxToAtm[j];
-                        ai2 = ai + a2;
-
-                        flag = is_distance_bonded(G, cs, ai1, ai2, v1, v2,
-                            cutoff_v, connect_mode, discrete_chains,
-                            connect_bonded, unbond_cations);
-
-                        {
-
-			  /* we have a bond, now process it */
-                          if(flag) {
-                            auto bnd = bondvla.check(nBond);
-			    CHECKOK(ok, bool(bondvla));
-			    if (ok){
-                              BondTypeInit2(bnd, a1, a2);
-			      order = 1;
-			    }
-			    /* if we allow bonds between chains and it screws up the
-			     * bonding, disallow inter-chain bonds */
-                            if(ok && discrete_chains < 0) {   /* if we're allowing bonds between chains,
-								 then make sure things don't get out of hand */
-                              if(cnt[i] == -1)
-                                violations++;
-                              if(cnt[j] == -1)
-                                violations++;
-			      /* decrement free valences, since we have a bond */
-                              cnt[i]--;
-                              cnt[j]--;
-                              if(violations > (cs->NIndex >> 3)) {
-                                /* if more than 12% of the structure has excessive #'s of bonds... */
-                                PRINTFB(G, FB_ObjectMolecule, FB_Blather)
-                                  " %s: Assuming chains are discrete...\n", __func__
-                                  ENDFB(G);
-                                discrete_chains = 1;
-                                repeat = true;
-                                goto do_it_again;
-                              }
-                            }
-
-                            if(!ai1->hetatm || ai1->resn == G->lex_const.MSE) {
-                              if(AtomInfoSameResidue(I->G, ai1, ai2)) {
-                                /* hookup standard disconnected PDB residue */
-                                assign_pdb_known_residue(G, ai1, ai2, &order);
-                              }
-                            }
-                            bnd->order = -order;      /* store tentative valence as negative */
-                            nBond++;
-                          }
-                        }
-                      }
-                      j = MapNext(map, j);
+            /* search in parallel, then merge serially in index order, so the
+             * result (including the valence check below) doesn't depend on
+             * the number of threads. Each batch of tasks is merged before
+             * the next one is searched, so that the restart and the bond
+             * limit below stop the search as early as in a serial loop. */
+            int n_thread = std::max(1, SettingGetGlobal_i(G, cSetting_max_threads));
+            int n_task = std::max(1, cs->NIndex / cConnectMinIndexPerTask);
+
+            std::vector<std::vector<DistanceBondCandidate>> found(n_thread);
+
+            PRINTFB(G, FB_ObjectMolecule, FB_Blather)
+              " %s: Searching %d coordinates with %d tasks.\n", __func__,
+              cs->NIndex, n_task ENDFB(G);
+
+            i = -1;
+            for(int task_begin = 0; task_begin < n_task; task_begin += n_thread) {
+              int n_batch = std::min(n_thread, n_task - task_begin);
+
+              G->ThreadPool->run(n_batch, n_thread, [&](size_t k) {
+                size_t task = task_begin + k;
+                int i_begin = int(size_t(cs->NIndex) * task / n_task);
+                int i_end = int(size_t(cs->NIndex) * (task + 1) / n_task);
+                found[k].clear();
+                find_distance_bonds(G, cs, ai, map, i_begin, i_end, cutoff_v,
+                    connect_mode, discrete_chains, connect_bonded,
+                    unbond_cations, found[k]);
+              });
+
+              for(int k = 0; k < n_batch; ++k) {
+                for(const auto& candidate : found[k]) {
+                  if(candidate.i != i) {
+                    if(nBond > maxBond)
+                      goto do_it_again;
+                    i = candidate.i;
+                  }
+                  j = candidate.j;
+                  a1 = cs->IdxToAtm[i];
+                  a2 = cs->IdxToAtm[j];
+                  ai1 = ai + a1;
+                  ai2 = ai + a2;
+
+                  /* we have a bond, now process it */
+                  auto bnd = bondvla.check(nBond);
+                  CHECKOK(ok, bool(bondvla));
+                  if(!ok)
+                    goto do_it_again;
+                  BondTypeInit2(bnd, a1, a2);
+                  order = 1;
+
+                  /* if we allow bonds between chains and it screws up the
+                   * bonding, disallow inter-chain bonds */
+                  if(discrete_chains < 0) {   /* if we're allowing bonds between chains,
+                                                 then make sure things don't get out of hand */
+                    if(cnt[i] == -1)
+                      violations++;
+                    if(cnt[j] == -1)
+                      violations++;
+                    /* decrement free valences, since we have a bond */
+                    cnt[i]--;
+                    cnt[j]--;
+                    if(violations > (cs->NIndex >> 3)) {
+                      /* if more than 12% of the structure has excessive #'s of bonds... */
+                      PRINTFB(G, FB_ObjectMolecule, FB_Blather)
+                        " %s: Assuming chains are discrete...\n", __func__
+                        ENDFB(G);
+                      discrete_chains = 1;
+                      repeat = true;
+                      goto do_it_again;
+                    }
+                  }
+
+                  if(!ai1->hetatm || ai1->resn == G->lex_const.MSE) {
+                    if(AtomInfoSameResidue(I->G, ai1, ai2)) {
+                      /* hookup standard disconnected PDB residue */
+                      assign_pdb_known_residue(G, ai1, ai2, &order);
                     }
                   }
+                  bnd->order = -order;      /* store tentative valence as negative */
+                  nBond++;
                 }
               }
             }
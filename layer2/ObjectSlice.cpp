@@ -205,6 +205,7 @@ PyObject *ObjectSliceAsPyList(ObjectSlice * I)
 
 void ObjectSlice::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   int a;
   int once_flag = true;
   for(a = 0; a < State.size(); a++) {
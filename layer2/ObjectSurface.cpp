@@ -268,6 +268,7 @@ void ObjectSurfaceDump(ObjectSurface * I, const char *fname, int state, int quie
 
 void ObjectSurface::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   auto I = this;
   int once_flag = true;
   if(level >= cRepInvExtents) {
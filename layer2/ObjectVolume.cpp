@@ -326,6 +326,7 @@ int ObjectVolumeInvalidateMapName(ObjectVolume * I, const char *name, const char
 
 void ObjectVolume::invalidate(int rep, int level, int state)
 {
+  SceneCountChange(G);
   auto I = this;
   int a;
   int once_flag = true;
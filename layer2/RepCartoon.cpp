@@ -2692,15 +2692,14 @@ int RepCartoonSameVis(RepCartoon * I, CoordSet * cs)
   int same = true;
   const char *lv;
   int a;
-  const AtomInfoType *ai;
 
   if (!I->LastVisib)
     return false;
-  ai = cs->Obj->AtomInfo;
+  const int *visRep = cs->Obj->getAtomColumns().visRep.data();
   lv = I->LastVisib;
 
   for(a = 0; a < cs->NIndex; a++) {
-    if(*(lv++) != GET_BIT((ai + cs->IdxToAtm[a])->visRep, cRepCartoon)) {
+    if(*(lv++) != GET_BIT(visRep[cs->IdxToAtm[a]], cRepCartoon)) {
       same = false;
       break;
     }
@@ -2802,14 +2801,16 @@ void RepCartoonGeneratePASS1(PyMOLGlobals *G, RepCartoon *I, ObjectMolecule *obj
   auto gap_cutoff =
     SettingGet_i(G, cs->Setting, obj->Setting, cSetting_cartoon_gap_cutoff);
 
+  const int *visRep = obj->getAtomColumns().visRep.data();
+
   // iterate over (sorted) atoms
   for(CoordSetAtomIterator iter(cs); iter.next();) {
-    ai = iter.getAtomInfo();
-
     // cartoon rep for this atom?
-    if(!(*(lv++) = GET_BIT(ai->visRep, cRepCartoon)))
+    if(!(*(lv++) = GET_BIT(visRep[iter.getAtm()], cRepCartoon)))
       continue;
 
+    ai = iter.getAtomInfo();
+
     const char * ai_name = LexStr(G, ai->name);
 
     // atom indices
@@ -3072,13 +3073,11 @@ void RepCartoonComputePuttyValues(ObjectMolecule *obj, float *putty_vals){
   double sum = 0.0, sumsq = 0.0;
   float value;
   int cnt = 0;
-  AtomInfoType *ai;
   int a;
+  const int *visRep = obj->getAtomColumns().visRep.data();
   for(a = 0; a < obj->NAtom; a++) {
-    ai = obj->AtomInfo + a;
-    
-    if(ai->visRep & cRepCartoonBit) {
-      value = ai->b;
+    if(visRep[a] & cRepCartoonBit) {
+      value = obj->AtomInfo[a].b;
       sum += value;
       sumsq += (value * value);
       if(value < putty_vals[2])
@@ -581,12 +581,13 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
   obj = cs->Obj;
   visFlag = false;
   b = obj->Bond;
-  ai1 = obj->AtomInfo;
+  const AtomInfoColumns& columns = obj->getAtomColumns();
+  const int* visRep = columns.visRep.data();
   if(obj->RepVisCache & cRepCylBit)
     for(a = 0; a < obj->NBond; a++) {
       b1 = b->index[0];
       b2 = b->index[1];
-      if((cRepCylBit & ai1[b1].visRep & ai1[b2].visRep)) {
+      if((cRepCylBit & visRep[b1] & visRep[b2])) {
 	visFlag = true;
 	break;
       }
@@ -633,10 +634,8 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
     a2 = cs->atmToIdx(b2);
 
     if((a1 >= 0) && (a2 >= 0)) {
-      AtomInfoType *ati1 = obj->AtomInfo + b1;
-      AtomInfoType *ati2 = obj->AtomInfo + b2;
-      s1 = GET_BIT(ati1->visRep, cRepCyl);
-      s2 = GET_BIT(ati2->visRep, cRepCyl);
+      s1 = GET_BIT(visRep[b1], cRepCyl);
+      s2 = GET_BIT(visRep[b2], cRepCyl);
 
       if (s1 && s2){
         if((!variable_alpha) && AtomInfoCheckBondSetting(G, b, cSetting_stick_transparency))
@@ -718,6 +717,19 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
       a2 = cs->atmToIdx(b2);
 
       if((a1 >= 0) && (a2 >= 0)) {
+        s1 = GET_BIT(visRep[b1], cRepCyl);
+        s2 = GET_BIT(visRep[b2], cRepCyl);
+
+        if(!(s1 && s2))
+          if(!half_bonds) {
+            s1 = 0;
+            s2 = 0;
+          }
+
+        /* skip hidden bonds without touching the atom records */
+        if(!(s1 || s2))
+          continue;
+
         AtomInfoType *ati1 = obj->AtomInfo + b1;
         AtomInfoType *ati2 = obj->AtomInfo + b2;
         float bd_radius_full;
@@ -746,7 +758,7 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
         bd_radius_full = bd_radius;
 
         // scaling for bonds involving hydrogen
-        if (ati1->isHydrogen() || ati2->isHydrogen())
+        if (columns.isHydrogen(b1) || columns.isHydrogen(b2))
           bd_radius *= h_scale;
 
         if(bd_stick_color < 0) {
@@ -755,8 +767,8 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
           } else if(ColorCheckRamped(G, bd_stick_color)) {
             c1 = (c2 = bd_stick_color);
           } else {
-            c1 = ati1->color;
-            c2 = ati2->color;
+            c1 = columns.color[b1];
+            c2 = columns.color[b2];
           }
         } else {
           c1 = (c2 = bd_stick_color);
@@ -764,15 +776,6 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
         float *vv1 = cs->coordPtr(a1);
         float *vv2 = cs->coordPtr(a2);
 
-        s1 = GET_BIT(ati1->visRep, cRepCyl);
-        s2 = GET_BIT(ati2->visRep, cRepCyl);
-
-        if(!(s1 && s2))
-          if(!half_bonds) {
-            s1 = 0;
-            s2 = 0;
-          }
-
         if(hide_long && (s1 || s2)) {
           float cutoff = (ati1->vdw + ati2->vdw) * _0p9;
           ai1 = obj->AtomInfo + b1;
@@ -781,8 +784,8 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
         }
 
         // side chain helpers
-        if ((s1 || s2) && (ati1->flags & ati2->flags & cAtomFlag_polymer)) {
-          if ((cRepCartoonBit & ati1->visRep & ati2->visRep)) {
+        if ((s1 || s2) && (columns.flags[b1] & columns.flags[b2] & cAtomFlag_polymer)) {
+          if ((cRepCartoonBit & visRep[b1] & visRep[b2])) {
             bool sc_helper =
               AtomSettingGetWD(G, ati1,
                   cSetting_cartoon_side_chain_helper, cartoon_side_chain_helper) ||
@@ -793,7 +796,7 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
               s1 = s2 = 0;
           }
 
-          if ((s1 || s2) && (cRepRibbonBit & ati1->visRep & ati2->visRep)) {
+          if ((s1 || s2) && (cRepRibbonBit & visRep[b1] & visRep[b2])) {
             bool sc_helper =
               AtomSettingGetWD(G, ati1,
                   cSetting_ribbon_side_chain_helper, ribbon_side_chain_helper) ||
@@ -909,7 +912,7 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
        the sphere shader excessively. */
     for (auto at : all_zero_order_bond_atoms){
       ai1 = obj->AtomInfo + at;
-      c1 = ai1->color;
+      c1 = columns.color[at];
       float *v1 = cs->coordPtr(cs->atmToIdx(at));
       float v2[3];
       float rgb1[3];
@@ -1129,7 +1132,8 @@ void RepCylBondRenderImmediate(CoordSet * cs, RenderInfo * info)
       int a;
       int nBond = obj->NBond;
       const BondType *bd = obj->Bond.data();
-      const AtomInfoType *ai = obj->AtomInfo.data();
+      const AtomInfoColumns& columns = obj->getAtomColumns();
+      const int *visRep = columns.visRep.data();
       int last_color = -9;
       const float *coord = cs->Coord.data();
       const float _pt5 = 0.5F;
@@ -1137,19 +1141,18 @@ void RepCylBondRenderImmediate(CoordSet * cs, RenderInfo * info)
       for(a = 0; a < nBond; a++) {
         int b1 = bd->index[0];
         int b2 = bd->index[1];
-        const AtomInfoType *ai1, *ai2;
         bd++;
 
-        if( ((ai1 = ai + b1)->visRep & cRepCylBit) &&
-            ((ai2 = ai + b2)->visRep & cRepCylBit)) {
+        if((visRep[b1] & cRepCylBit) &&
+           (visRep[b2] & cRepCylBit)) {
           int a1, a2;
           active = true;
           a1 = cs->atmToIdx(b1);
           a2 = cs->atmToIdx(b2);
 
           if((a1 >= 0) && (a2 >= 0)) {
-            int c1 = ai1->color;
-            int c2 = ai2->color;
+            int c1 = columns.color[b1];
+            int c2 = columns.color[b2];
 
             const float *v1 = coord + 3 * a1;
             const float *v2 = coord + 3 * a2;
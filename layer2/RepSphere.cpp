@@ -209,17 +209,17 @@ int RepSphereSameVis(RepSphere * I, CoordSet * cs)
   bool *lv;
   int *lc;
   int a;
-  AtomInfoType *ai;
   if(I->LastVisib && I->LastColor) {
+    const AtomInfoColumns& columns = cs->Obj->getAtomColumns();
     lv = I->LastVisib;
     lc = I->LastColor;
 
     for(a = 0; a < cs->NIndex; a++) {
-      ai = cs->getAtomInfo(a);
-      if(*(lv++) != GET_BIT(ai->visRep, cRepSphere)) {
+      int atm = cs->IdxToAtm[a];
+      if(*(lv++) != GET_BIT(columns.visRep[atm], cRepSphere)) {
         return false;
       }
-      if(*(lc++) != ai->color) {
+      if(*(lc++) != columns.color[atm]) {
         return false;
       }
     }
@@ -491,6 +491,7 @@ Rep *RepSphereNew(CoordSet * cs, int state)
   if (!ok)
     return NULL;
   obj = cs->Obj;
+  const AtomInfoColumns& columns = obj->getAtomColumns();
 
   marked = pymol::calloc<bool>(obj->NAtom);
   CHECKOK(ok, marked);
@@ -549,7 +550,7 @@ Rep *RepSphereNew(CoordSet * cs, int state)
     a1 = cs->IdxToAtm[a];
     ati1 = obj->AtomInfo + a1;
     /* store temporary visibility information */
-    marked[a1] = GET_BIT(ati1->visRep,cRepSphere) &&
+    marked[a1] = GET_BIT(columns.visRep[a1], cRepSphere) &&
         RepSphereDetermineAtomVisibility(G, ati1, 
                                          cartoon_side_chain_helper, ribbon_side_chain_helper);
     if(marked[a1]) {
@@ -584,7 +585,7 @@ Rep *RepSphereNew(CoordSet * cs, int state)
       a1 = cs->IdxToAtm[a];
       ati1 = obj->AtomInfo + a1;
       /* store temporary visibility information */
-      marked[a1] = GET_BIT(ati1->visRep,cRepSphere) && 
+      marked[a1] = GET_BIT(columns.visRep[a1], cRepSphere) &&
         RepSphereDetermineAtomVisibility(G, ati1, 
                                          cartoon_side_chain_helper, ribbon_side_chain_helper);
       if(marked[a1]) {
@@ -607,12 +608,11 @@ Rep *RepSphereNew(CoordSet * cs, int state)
       lv = I->LastVisib;
       lc = I->LastColor;
       obj = cs->Obj;
-      const AtomInfoType *ai2 = obj->AtomInfo.data();
       if(sphere_color == -1){
 	for(a = 0; a < cs->NIndex; a++) {
           int at = cs->IdxToAtm[a];
 	  *(lv++) = marked[at];
-	  *(lc++) = (ai2 + at)->color;
+	  *(lc++) = columns.color[at];
 	}
       } else {
 	for(a = 0; a < cs->NIndex; a++) {
@@ -39,6 +39,17 @@ Z* -------------------------------------------------------------------
 #include"PConv.h"
 #include"Selector.h"
 #include"ShaderMgr.h"
+#include"ThreadPool.h"
+#include"DiskCache.h"
+#include"pymol/memory.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #ifdef NT
 #undef NT
@@ -126,6 +137,32 @@ typedef struct {
   int flags;
 } SurfaceJobAtomInfo;
 
+/* minimum work per task for the parallel surface passes */
+static const int cSurfaceMinDotsPerTask = 64;     /* atoms or solvent dots (one sphere each) */
+static const int cSurfaceMinPointsPerTask = 1024; /* surface points */
+
+/*
+ * Number of tasks for a parallel pass over `n` items on G->ThreadPool, with
+ * a few tasks per thread for load balancing. The items are split into
+ * contiguous ranges (see SurfaceTaskBegin), and callers merge the output of
+ * the tasks in task order, so the result is the same as from a serial loop,
+ * independent of the number of threads.
+ */
+static int SurfaceTaskCount(PyMOLGlobals * G, int n, int min_per_task,
+                            int *n_thread)
+{
+  *n_thread = std::max(1, SettingGetGlobal_i(G, cSetting_max_threads));
+  return std::max(1, std::min(*n_thread * 4, n / min_per_task));
+}
+
+/*
+ * First item of `task` (`n_task` is past the last item)
+ */
+static int SurfaceTaskBegin(int n, int n_task, int task)
+{
+  return int(size_t(n) * task / n_task);
+}
+
 static SolventDot *SolventDotNew(PyMOLGlobals * G,
                                  float *coord,
                                  SurfaceJobAtomInfo * atom_info,
@@ -3068,6 +3105,168 @@ static void SurfaceJobFree(PyMOLGlobals * G, SurfaceJob * I)
   OOFreeP(I);
 }
 
+/*========================================================================*/
+/* binary (de)serialization for the on-disk surface cache */
+
+template <typename T>
+static void SurfaceCacheAppend(std::string& buf, const T& value)
+{
+  buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/* number of elements + 1 (0 for NULL), followed by the first `n` elements
+ * (default: all) of the VLA */
+template <typename T>
+static void SurfaceCacheAppendVLA(std::string& buf, const T* vla,
+    size_t n = size_t(-1))
+{
+  if(vla)
+    n = std::min<size_t>(n, VLAGetSize(vla));
+  else
+    n = 0;
+  SurfaceCacheAppend(buf, std::uint64_t(vla ? n + 1 : 0));
+  if(n)
+    buf.append(reinterpret_cast<const char*>(vla), n * sizeof(T));
+}
+
+template <typename T>
+static bool SurfaceCacheRead(const std::string& buf, size_t& pos, T& value)
+{
+  if(buf.size() - pos < sizeof(T))
+    return false;
+  memcpy(&value, buf.data() + pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+template <typename T>
+static bool SurfaceCacheReadVLA(const std::string& buf, size_t& pos, T** vla)
+{
+  std::uint64_t n = 0;
+  if(!SurfaceCacheRead(buf, pos, n))
+    return false;
+  if(n--) {
+    if((buf.size() - pos) / sizeof(T) < n)
+      return false;
+    *vla = VLAlloc(T, n);
+    if(!*vla)
+      return false;
+    if(n)
+      memcpy(*vla, buf.data() + pos, n * sizeof(T));
+    pos += n * sizeof(T);
+  }
+  return true;
+}
+
+/**
+ * All inputs of a surface job (coordinates, radii, probe radius, surface
+ * type, quality, ...), as key for the on-disk surface cache
+ */
+static std::string SurfaceJobInputAsKey(SurfaceJob * I)
+{
+  std::string key = "SurfaceJob 1";
+  SurfaceCacheAppendVLA(key, I->coord);
+
+  std::uint64_t n_atom = I->atomInfo ? VLAGetSize(I->atomInfo) : 0;
+  SurfaceCacheAppend(key, n_atom);
+  for(std::uint64_t a = 0; a < n_atom; a++) {
+    SurfaceCacheAppend(key, I->atomInfo[a].vdw);
+    SurfaceCacheAppend(key, I->atomInfo[a].flags);
+  }
+
+  SurfaceCacheAppend(key, I->maxVdw);
+  SurfaceCacheAppend(key, I->allVisibleFlag);
+  SurfaceCacheAppend(key, I->nPresent);
+  SurfaceCacheAppendVLA(key, I->presentVla);
+  SurfaceCacheAppend(key, I->solventSphereIndex);
+  SurfaceCacheAppend(key, I->sphereIndex);
+  SurfaceCacheAppend(key, I->surfaceType);
+  SurfaceCacheAppend(key, I->circumscribe);
+  SurfaceCacheAppend(key, I->probeRadius);
+  SurfaceCacheAppend(key, I->carveCutoff);
+  SurfaceCacheAppendVLA(key, I->carveVla);
+  SurfaceCacheAppend(key, I->surfaceMode);
+  SurfaceCacheAppend(key, I->surfaceSolvent);
+  SurfaceCacheAppend(key, I->cavityCull);
+  SurfaceCacheAppend(key, I->pointSep);
+  SurfaceCacheAppend(key, I->trimCutoff);
+  SurfaceCacheAppend(key, I->trimFactor);
+  SurfaceCacheAppend(key, I->cavityMode);
+  SurfaceCacheAppend(key, I->cavityRadius);
+  SurfaceCacheAppend(key, I->cavityCutoff);
+  return key;
+}
+
+/**
+ * Length of a strip VLA (count, count + 2 vertices, ..., 0), including the
+ * terminating zero
+ */
+static size_t SurfaceJobStripLength(const int *s)
+{
+  size_t size = VLAGetSize(s);
+  size_t i = 0;
+  while(i < size && s[i] > 0)
+    i += s[i] + 3;
+  return std::min(i + 1, size);
+}
+
+/**
+ * Surface job results (without unused VLA capacity)
+ */
+static std::string SurfaceJobResultAsBytes(SurfaceJob * I)
+{
+  std::string buf;
+  SurfaceCacheAppend(buf, I->N);
+  SurfaceCacheAppend(buf, I->NT);
+  SurfaceCacheAppendVLA(buf, I->V, I->N * 3);
+  SurfaceCacheAppendVLA(buf, I->VN, I->N * 3);
+  SurfaceCacheAppendVLA(buf, I->T, I->NT * 3);
+  SurfaceCacheAppendVLA(buf, I->S, I->S ? SurfaceJobStripLength(I->S) : 0);
+  return buf;
+}
+
+static bool SurfaceJobResultFromBytes(PyMOLGlobals * G, SurfaceJob * I,
+    const std::string& buf)
+{
+  size_t pos = 0;
+  SurfaceJobPurgeResult(G, I);
+  bool ok = SurfaceCacheRead(buf, pos, I->N) &&
+            SurfaceCacheRead(buf, pos, I->NT) &&
+            SurfaceCacheReadVLA(buf, pos, &I->V) &&
+            SurfaceCacheReadVLA(buf, pos, &I->VN) &&
+            SurfaceCacheReadVLA(buf, pos, &I->T) &&
+            SurfaceCacheReadVLA(buf, pos, &I->S) && pos == buf.size();
+  if(!ok)
+    SurfaceJobPurgeResult(G, I);
+  return ok;
+}
+
+/**
+ * On-disk surface cache, or NULL if disabled (empty surface_cache_dir).
+ * One instance per directory, so its size and recency bookkeeping persists
+ * across surface builds.
+ */
+static pymol::DiskCache* SurfaceCacheGet(PyMOLGlobals * G)
+{
+  static std::mutex s_mutex;
+  static std::map<std::string, std::unique_ptr<pymol::DiskCache>> s_caches;
+
+  const char *dir = SettingGetGlobal_s(G, cSetting_surface_cache_dir);
+  if(!dir || !dir[0])
+    return nullptr;
+  float max_mb = SettingGetGlobal_f(G, cSetting_surface_cache_max);
+  size_t max_bytes = max_mb > 0.f ? size_t(max_mb * 1024.0 * 1024.0) : 0;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto& cache = s_caches[dir];
+  if(!cache) {
+    cache = pymol::make_unique<pymol::DiskCache>(dir, max_bytes);
+  } else {
+    cache->setMaxBytes(max_bytes);
+  }
+  return cache.get();
+}
+
 static int SurfaceJobEliminateCloseDotsType3orMore(PyMOLGlobals * G,
     SurfaceJob * I, int *repeat_flag, int *dot_flag)
 {
@@ -3234,48 +3433,92 @@ static int SurfaceJobEliminateCloseDots(PyMOLGlobals * G, SurfaceJob * I){
   return ok;
 }
 
+/*
+ * Average dot product of the normal of vertex `a` with the normals of all
+ * flagged vertices within the neighborhood
+ * @return false if there are no such vertices
+ */
+static bool SurfaceJobVertexNeighborDot(SurfaceJob * I, MapType *map,
+    const int *dot_flag, float neighborhood, int a, float *dot_avg)
+{
+  float *v = I->V + 3 * a;
+  float *vn = I->VN + 3 * a;
+  int i = *(MapLocusEStart(map, v));
+  if(!i || !map->EList)
+    return false;
+  int j = map->EList[i++];
+  int n_nbr = 0;
+  float dot_sum = 0.0F;
+  while(j >= 0) {
+    if(j != a) {
+      if(dot_flag[j]) {
+	float *v0 = I->V + 3 * j;
+	if(within3f(v0, v, neighborhood)) {
+	  float *n0 = I->VN + 3 * j;
+	  dot_sum += dot_product3f(n0, vn);
+	  n_nbr++;
+	}
+      }
+    }
+    j = map->EList[i++];
+  }
+  if(!n_nbr)
+    return false;
+  *dot_avg = dot_sum / n_nbr;
+  return true;
+}
+
 /* For each vertex, lookup all vertices within the neighborhood, and sum the dot_product of the normals.  
    If the average of the dot_products of the normals is less than the trim_cutoff,
-   then the middle vertex is eliminated. */
+   then the middle vertex is eliminated.
+
+   Vertices are tested in order against the neighbors which haven't been
+   eliminated yet. All vertices are first tested in parallel as if nothing
+   was eliminated (dot_flag is all true on entry), then a serial pass in
+   order only retests the vertices next to an already eliminated vertex, which
+   gives exactly the result of the serial loop. */
 static int SurfaceJobEliminateTroublesomeVerticesMark(PyMOLGlobals * G,
     SurfaceJob * I, int *repeat_flag, MapType *map, int *dot_flag,
     float neighborhood, float trim_cutoff)
 {
   int ok = true;
   int a;
-  float *v = I->V;
-  float *vn = I->VN;
+  int n_thread;
+  int n_task = SurfaceTaskCount(G, I->N, cSurfaceMinPointsPerTask, &n_thread);
+  std::vector<char> trim(I->N), dirty(I->N);
+
+  G->ThreadPool->run(n_task, n_thread, [&](size_t task) {
+    int a_end = SurfaceTaskBegin(I->N, n_task, task + 1);
+    for(int a = SurfaceTaskBegin(I->N, n_task, task); a < a_end; a++) {
+      float dot_avg;
+      trim[a] = SurfaceJobVertexNeighborDot(I, map, dot_flag, neighborhood,
+                                            a, &dot_avg) &&
+                (dot_avg < trim_cutoff);
+    }
+  });
+
   for(a = 0; ok && a < I->N; a++) {
-    if(dot_flag[a]) {
+    if(dirty[a]) {
+      float dot_avg;
+      trim[a] = SurfaceJobVertexNeighborDot(I, map, dot_flag, neighborhood,
+                                            a, &dot_avg) &&
+                (dot_avg < trim_cutoff);
+    }
+    if(trim[a]) {
+      float *v = I->V + 3 * a;
       int i = *(MapLocusEStart(map, v));
+      dot_flag[a] = false;
+      *repeat_flag = true;
+      /* vertices after this one which counted it as a neighbor */
       if(i && map->EList) {
 	int j = map->EList[i++];
-	int n_nbr = 0;
-	float dot_sum = 0.0F;
 	while(j >= 0) {
-	  if(j != a) {
-	    if(dot_flag[j]) {
-	      float *v0 = I->V + 3 * j;
-	      if(within3f(v0, v, neighborhood)) {
-		float *n0 = I->VN + 3 * j;
-		dot_sum += dot_product3f(n0, vn);
-		n_nbr++;
-	      }
-	    }
-	  }
+	  if(j > a && within3f(I->V + 3 * j, v, neighborhood))
+	    dirty[j] = true;
 	  j = map->EList[i++];
 	}
-	if(n_nbr) {
-	  dot_sum /= n_nbr;
-	  if(dot_sum < trim_cutoff) {
-	    dot_flag[a] = false;
-	    *repeat_flag = true;
-	  }
-	}
       }
     }
-    v += 3;
-    vn += 3;
     ok &= !G->Interrupt;
   }
   return ok;
@@ -3575,6 +3818,50 @@ static void SurfaceJobSetProbeRadius(int surface_type, float point_sep,
   *probe_rad_less2 = (*probe_rad_less) * (*probe_rad_less);
 }
 
+/*
+ * Surface points (and normals) on the probe spheres around the solvent dots
+ * [a_begin, a_end), appended to `V` and `VN`
+ */
+static int SurfaceJobSolventDotPoints(PyMOLGlobals * G, SurfaceJob * I,
+    SolventDot *sol_dot, MapType *map, MapType *solv_map, SphereRec *sp,
+    const Vector3f *dot, int *present_vla, float probe_rad_more,
+    float probe_rad_less, float probe_rad_less2, int a_begin, int a_end,
+    std::vector<float>& V, std::vector<float>& VN)
+{
+  int ok = true;
+  int a, b;
+  int sp_nDot = sp->nDot;
+  int surface_type = I->surfaceType;
+  float v[3];
+  for(a = a_begin; ok && a < a_end; a++) {
+    if(sol_dot->dotCode[a] || (surface_type < 6)) {     /* surface type 6 is completely scribed */
+      const float *v0 = sol_dot->dot + 3 * a;
+      OrthoBusyFast(G, a + sol_dot->nDot * 2, sol_dot->nDot * 5); /* 2/5 to 3/5 */
+      for(b = 0; b < sp_nDot; b++) {
+        const float *dot_b = dot[b];
+        int flag = true;
+        v[0] = v0[0] + dot_b[0];
+        v[1] = v0[1] + dot_b[1];
+        v[2] = v0[2] + dot_b[2];
+        SurfaceJobCheckInteriorSolventSurface(solv_map, v, sol_dot, probe_rad_less, probe_rad_less2, a, &flag);
+        /* at this point, we have points on the interior of the solvent surface,
+           so now we need to further trim that surface to cover atoms that are present */
+        if(flag) {
+          SurfaceJobCheckPresentAndWithin(map, I, present_vla, v, probe_rad_more, &flag);
+          if(!flag) {   /* compute the normals */
+            V.insert(V.end(), v, v + 3);
+            VN.push_back(-sp->dot[b][0]);
+            VN.push_back(-sp->dot[b][1]);
+            VN.push_back(-sp->dot[b][2]);
+          }
+        }
+      }
+    }
+    ok &= !G->Interrupt;
+  }
+  return ok;
+}
+
 static int SurfaceJobRun(PyMOLGlobals * G, SurfaceJob * I)
 {
   int ok = true;
@@ -3644,6 +3931,10 @@ static int SurfaceJobRun(PyMOLGlobals * G, SurfaceJob * I)
             int a;
             float *v0 = sol_dot->dot;
             float *n0 = sol_dot->dotNormal;
+            VLACheck(I->V, float, 3 * sol_dot->nDot + 2);
+            VLACheck(I->VN, float, 3 * sol_dot->nDot + 2);
+            v = I->V;
+            vn = I->VN;
             for(a = 0; a < sol_dot->nDot; a++) {
               scale3f(n0, -probe_radius, v);
               add3f(v0, v, v);
@@ -3673,7 +3964,6 @@ static int SurfaceJobRun(PyMOLGlobals * G, SurfaceJob * I)
 	    ok &= map->EList && solv_map->EList;
             if(sol_dot->nDot && ok) {
               Vector3f *dot = pymol::malloc<Vector3f>(sp->nDot);
-              float *v0, *n0;
 	      CHECKOK(ok, dot);
               if (ok){
                 int b;
@@ -3681,46 +3971,36 @@ static int SurfaceJobRun(PyMOLGlobals * G, SurfaceJob * I)
                   scale3f(sp->dot[b], probe_radius, dot[b]);
                 }
               }
-              v0 = sol_dot->dot;
-              n0 = sol_dot->dotNormal;
               if (ok) {
-                int a, b;
-                int sp_nDot = sp->nDot;
-                for(a = 0; ok && a < sol_dot->nDot; a++) {
-                  if(sol_dot->dotCode[a] || (surface_type < 6)) {     /* surface type 6 is completely scribed */
-                    OrthoBusyFast(G, a + sol_dot->nDot * 2, sol_dot->nDot * 5); /* 2/5 to 3/5 */
-                    for(b = 0; ok && b < sp_nDot; b++) {
-                      float *dot_b = dot[b];
-                      v[0] = v0[0] + dot_b[0];
-                      v[1] = v0[1] + dot_b[1];
-                      v[2] = v0[2] + dot_b[2];
-                      {
-                        int flag = true;
-			SurfaceJobCheckInteriorSolventSurface(solv_map, v, sol_dot, probe_rad_less, probe_rad_less2, a, &flag);
-                        /* at this point, we have points on the interior of the solvent surface,
-                           so now we need to further trim that surface to cover atoms that are present */
-                        if(flag) {
-			  SurfaceJobCheckPresentAndWithin(map, I, present_vla, v, probe_rad_more, &flag);
-                          if(!flag) {   /* compute the normals */
-                            vn[0] = -sp->dot[b][0];
-                            vn[1] = -sp->dot[b][1];
-                            vn[2] = -sp->dot[b][2];
-                              I->N++;
-			    VLACheck(I->V, float, 3 * (I->N + 1));
-			    VLACheck(I->VN, float, 3 * (I->N + 1));
-			      CHECKOK(ok, I->V);
-			      CHECKOK(ok, I->VN);
-			    v = I->V + I->N * 3;
-			    vn = I->VN + I->N * 3;
-                          }
-                        }
-                      }
-		      ok &= !G->Interrupt;
-                    }
-                  }
-                  v0 += 3;
-                  n0 += 3;
-		  ok &= !G->Interrupt;
+                /* one list of points per task, concatenated in order */
+                int n_thread;
+                int n_task = SurfaceTaskCount(G, sol_dot->nDot,
+                                              cSurfaceMinDotsPerTask, &n_thread);
+                std::vector<std::vector<float>> task_v(n_task), task_vn(n_task);
+                std::vector<char> task_ok(n_task);
+                size_t n_new = 0;
+                G->ThreadPool->run(n_task, n_thread, [&](size_t task) {
+                  task_ok[task] = SurfaceJobSolventDotPoints(G, I, sol_dot,
+                      map, solv_map, sp, dot, present_vla, probe_rad_more,
+                      probe_rad_less, probe_rad_less2,
+                      SurfaceTaskBegin(sol_dot->nDot, n_task, task),
+                      SurfaceTaskBegin(sol_dot->nDot, n_task, task + 1),
+                      task_v[task], task_vn[task]);
+                });
+                for(int task = 0; task < n_task; task++) {
+                  ok &= task_ok[task];
+                  n_new += task_v[task].size();
+                }
+                if(ok) {
+                  VLACheck(I->V, float, 3 * I->N + n_new + 2);
+                  VLACheck(I->VN, float, 3 * I->N + n_new + 2);
+                  CHECKOK(ok, I->V);
+                  CHECKOK(ok, I->VN);
+                }
+                for(int task = 0; ok && task < n_task; task++) {
+                  std::copy(task_v[task].begin(), task_v[task].end(), I->V + 3 * I->N);
+                  std::copy(task_vn[task].begin(), task_vn[task].end(), I->VN + 3 * I->N);
+                  I->N += task_v[task].size() / 3;
                 }
               }
               FreeP(dot);
@@ -3981,7 +4261,8 @@ static
 void RepSurfaceConvertSurfaceJobToPyObject(PyMOLGlobals *G, SurfaceJob *surf_job, CoordSet *cs, ObjectMolecule *obj, PyObject **entry, PyObject **input, PyObject **output, int *found){
   int cache_mode = SettingGet_i(G, cs->Setting, obj->Setting, cSetting_cache_mode);
   
-  if(cache_mode > 0) {
+  // the cache lives in Python, not reachable from native worker threads
+  if(cache_mode > 0 && !pymol::ThreadPool::isWorkerThread()) {
     int blocked = PAutoBlock(G);
     *input = SurfaceJobInputAsTuple(G, surf_job);
     
@@ -4289,17 +4570,31 @@ Rep *RepSurfaceNew(CoordSet * cs, int state)
 
           if(ok) {
             int found = false;
+            auto disk_cache = SurfaceCacheGet(G);
+            std::string disk_cache_key;
+            if(disk_cache) {
+              std::string cached;
+              disk_cache_key = SurfaceJobInputAsKey(surf_job);
+              found = disk_cache->get(disk_cache_key, cached) &&
+                      SurfaceJobResultFromBytes(G, surf_job, cached);
+            }
 #ifndef _PYMOL_NOPY
             PyObject *entry = NULL;
             PyObject *output = NULL;
             PyObject *input = NULL;
-	    int cache_mode = SettingGet_i(G, cs->Setting, obj->Setting, cSetting_cache_mode);
-	    RepSurfaceConvertSurfaceJobToPyObject(G, surf_job, cs, obj, &entry, &input, &output, &found);
+	    int cache_mode = pymol::ThreadPool::isWorkerThread() ? 0 :
+              SettingGet_i(G, cs->Setting, obj->Setting, cSetting_cache_mode);
+	    if(!found)
+	      RepSurfaceConvertSurfaceJobToPyObject(G, surf_job, cs, obj, &entry, &input, &output, &found);
 #endif
             if(ok && !found) {
 
               ok &= SurfaceJobRun(G, surf_job);
 
+              if(ok && disk_cache && !G->Interrupt) {
+                disk_cache->put(disk_cache_key, SurfaceJobResultAsBytes(surf_job));
+              }
+
 #ifndef _PYMOL_NOPY
               if(cache_mode > 1) {
                 int blocked = PAutoBlock(G);
@@ -4791,20 +5086,46 @@ static SolventDot *SolventDotNew(PyMOLGlobals * G,
     if(map && ok) {
       ok &= MapSetupExpress(map);
       if (ok) {
-        int a;
-        int skip_flag;
-        SurfaceJobAtomInfo *a_atom_info = atom_info;
-        for(a = 0; ok && a < n_coord; a++) {
-          OrthoBusyFast(G, a, n_coord * 5);
-          if((!present) || (present[a])) {
-            skip_flag = false;
-	    ok = SolventDotFilterOutSameXYZ(G, map, atom_info, a_atom_info, coord, a, present, &skip_flag);
-            if(ok && !skip_flag) {
-	      ok = SolventDotGetDotsAroundVertexInSphere(G, I, map, atom_info, a_atom_info, coord, a, present, sp, probe_radius, &dotCnt, stopDot, I->dot, I->dotNormal, &I->nDot);
+        /* each task writes the dots of its atoms to the start of the
+           space reserved for them (sp->nDot per atom), then the dots are
+           moved down in task order */
+        int n_thread;
+        int n_task = SurfaceTaskCount(G, n_coord, cSurfaceMinDotsPerTask, &n_thread);
+        std::vector<int> task_nDot(n_task);
+        std::vector<char> task_ok(n_task);
+        G->ThreadPool->run(n_task, n_thread, [&](size_t task) {
+          int a_begin = SurfaceTaskBegin(n_coord, n_task, task);
+          int a_end = SurfaceTaskBegin(n_coord, n_task, task + 1);
+          float *task_dot = I->dot + a_begin * sp->nDot * 3;
+          float *task_normal = I->dotNormal + a_begin * sp->nDot * 3;
+          int ok_task = true;
+          int task_dotCnt = 0;
+          int a;
+          int skip_flag;
+          SurfaceJobAtomInfo *a_atom_info = atom_info + a_begin;
+          for(a = a_begin; ok_task && a < a_end; a++) {
+            OrthoBusyFast(G, a, n_coord * 5);
+            if((!present) || (present[a])) {
+              skip_flag = false;
+              ok_task = SolventDotFilterOutSameXYZ(G, map, atom_info, a_atom_info, coord, a, present, &skip_flag);
+              if(ok_task && !skip_flag) {
+                ok_task = SolventDotGetDotsAroundVertexInSphere(G, I, map, atom_info, a_atom_info, coord, a, present, sp, probe_radius, &task_dotCnt, stopDot, task_dot, task_normal, &task_nDot[task]);
+              }
             }
+            a_atom_info++;
           }
-          a_atom_info++;
+          task_ok[task] = ok_task;
+        });
+        for(int task = 0; task < n_task; task++) {
+          int a_begin = SurfaceTaskBegin(n_coord, n_task, task);
+          ok &= task_ok[task];
+          memmove(I->dot + I->nDot * 3, I->dot + a_begin * sp->nDot * 3,
+                  sizeof(float) * 3 * task_nDot[task]);
+          memmove(I->dotNormal + I->nDot * 3, I->dotNormal + a_begin * sp->nDot * 3,
+                  sizeof(float) * 3 * task_nDot[task]);
+          I->nDot += task_nDot[task];
         }
+        dotCnt = I->nDot;
       }
 
       /* for each pair of proximal atoms, circumscribe a circle for their intersection */
@@ -0,0 +1,305 @@
+#include "TrajStream.h"
+
+#include <algorithm>
+
+#include "os_std.h"
+#include "CoordSet.h"
+#include "Feedback.h"
+#include "ObjectMolecule.h"
+#include "Setting.h"
+#include "Vector.h"
+
+CTrajStream::CTrajStream(PyMOLGlobals* G, ObjectMolecule* obj,
+    std::unique_ptr<CTrajFrameReader> reader, std::unique_ptr<int[]> xref,
+    int n_file_atom, int n_index, int first_state, int n_frame)
+    : G(G)
+    , Obj(obj)
+    , Reader(std::move(reader))
+    , Xref(std::move(xref))
+    , NFileAtom(n_file_atom)
+    , NIndex(n_index)
+    , FirstState(first_state)
+    , NFrame(n_frame)
+{
+}
+
+CTrajStream::~CTrajStream()
+{
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Stop = true;
+  }
+  Cond.notify_all();
+  if (Thread.joinable())
+    Thread.join();
+}
+
+/**
+ * Prefetch thread: reads the queued frames into `Ready`
+ */
+static void TrajStreamPrefetchLoop(CTrajStream* I)
+{
+  std::unique_lock<std::mutex> lock(I->Mutex);
+  for (;;) {
+    I->Cond.wait(lock, [I] { return I->Stop || !I->Queue.empty(); });
+    if (I->Stop)
+      break;
+
+    int frame = I->Queue.front();
+    I->Queue.erase(I->Queue.begin());
+    lock.unlock();
+
+    std::vector<float> coords(3 * I->NFileAtom);
+    bool ok;
+    {
+      std::lock_guard<std::mutex> reader_lock(I->ReaderMutex);
+      ok = I->Reader->read(frame, coords.data());
+    }
+
+    lock.lock();
+    if (ok && I->WindowStart <= frame && frame < I->WindowStop)
+      I->Ready[frame] = std::move(coords);
+  }
+}
+
+/**
+ * Free least recently used states until the "traj_stream_cache" budget is
+ * met. At least the two most recently used states stay resident, so callers
+ * may keep using the coordinate sets of the last two states they fetched.
+ * Caller must hold StateMutex.
+ */
+static void TrajStreamEvict(CTrajStream* I)
+{
+  auto obj = I->Obj;
+  double state_size = I->NIndex * (3 * sizeof(float) + sizeof(int)) +
+                      obj->NAtom * sizeof(int);
+  double budget =
+      SettingGetGlobal_f(I->G, cSetting_traj_stream_cache) * 1024. * 1024.;
+  size_t max_resident = std::max(2., budget / state_size);
+
+  while (I->Resident.size() > max_resident) {
+    int state = I->Resident.back();
+    if (state < obj->NCSet && obj->CSet[state]) {
+      obj->CSet[state]->fFree();
+      obj->CSet[state] = nullptr;
+    }
+    I->Resident.pop_back();
+  }
+}
+
+/**
+ * Mark `state` as most recently used.
+ * Caller must hold StateMutex.
+ */
+static void TrajStreamTouch(CTrajStream* I, int state)
+{
+  if (I->Resident.empty() || I->Resident.front() != state) {
+    I->Resident.remove(state);
+    I->Resident.push_front(state);
+  }
+}
+
+/**
+ * Mark `state` as resident and most recently used
+ */
+void TrajStreamAddResident(CTrajStream* I, int state)
+{
+  std::lock_guard<std::mutex> lock(I->StateMutex);
+  TrajStreamTouch(I, state);
+  TrajStreamEvict(I);
+}
+
+/**
+ * New coordinate set for the non-resident `state`, with the coordinates
+ * from the trajectory. Caller must hold StateMutex.
+ */
+static CoordSet* TrajStreamRead(CTrajStream* I, int state)
+{
+  PyMOLGlobals* G = I->G;
+  auto obj = I->Obj;
+
+  // new states are copies of a resident one, which has up-to-date atom
+  // indices (e.g. after sorting)
+  const CoordSet* tmpl = nullptr;
+  for (int s : I->Resident) {
+    if (s < obj->NCSet && (tmpl = obj->CSet[s]))
+      break;
+  }
+
+  if (!tmpl || tmpl->NIndex != I->NIndex) {
+    I->Valid = false;
+    PRINTFB(G, FB_ObjectMolecule, FB_Warnings)
+      " ObjectMolecule-Warning: atoms of \"%s\" changed, remaining trajectory"
+      " states are no longer available.\n", obj->Name ENDFB(G);
+    return nullptr;
+  }
+
+  int frame = state - I->FirstState;
+  std::vector<float> coords;
+
+  {
+    std::lock_guard<std::mutex> lock(I->Mutex);
+    auto it = I->Ready.find(frame);
+    if (it != I->Ready.end()) {
+      coords = std::move(it->second);
+      I->Ready.erase(it);
+    } else {
+      I->Queue.erase(std::remove(I->Queue.begin(), I->Queue.end(), frame),
+          I->Queue.end());
+    }
+  }
+
+  if (coords.empty()) {
+    coords.resize(3 * I->NFileAtom);
+    std::lock_guard<std::mutex> lock(I->ReaderMutex);
+    if (!I->Reader->read(frame, coords.data())) {
+      PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+        " ObjectMolecule-Error: reading trajectory frame %d for state %d"
+        " failed.\n", frame + 1, state + 1 ENDFB(G);
+      return nullptr;
+    }
+  }
+
+  CoordSet* cs = CoordSetCopy(tmpl);
+  if (!cs)
+    return nullptr;
+
+  for (int i = 0; i < I->NFileAtom; ++i) {
+    int idx = I->Xref ? I->Xref[i] : i;
+    if (idx >= 0) {
+      copy3(coords.data() + 3 * i, cs->coordPtr(idx));
+    }
+  }
+
+  cs->invalidateRep(cRepAll, cRepInvRep);
+
+  PRINTFB(G, FB_ObjectMolecule, FB_Blather)
+    " ObjectMolecule: read set %d into state %d...\n", frame + 1, state + 1
+    ENDFB(G);
+
+  return cs;
+}
+
+/*
+ * Caller must hold StateMutex.
+ */
+static CoordSet* TrajStreamFetchLocked(CTrajStream* I, int state)
+{
+  auto obj = I->Obj;
+
+  if (state < 0 || state >= obj->NCSet)
+    return nullptr;
+
+  CoordSet* cs = obj->CSet[state];
+  if (!I->hasState(state) || !I->Valid)
+    return cs;
+
+  if (!cs) {
+    if (!(cs = TrajStreamRead(I, state)))
+      return nullptr;
+    obj->CSet[state] = cs;
+  }
+
+  TrajStreamTouch(I, state);
+  TrajStreamEvict(I);
+  return cs;
+}
+
+/**
+ * Get the coordinate set of `state`, reading it from the trajectory if it
+ * is not resident. The state stays resident until at least two other
+ * states were fetched (see TrajStreamEvict).
+ */
+CoordSet* TrajStreamFetch(CTrajStream* I, int state)
+{
+  std::lock_guard<std::mutex> lock(I->StateMutex);
+  return TrajStreamFetchLocked(I, state);
+}
+
+/**
+ * Copy of the coordinate set of `state` (owned by the caller), read from
+ * the trajectory without making it resident if needed. For copying and
+ * saving the object.
+ */
+CoordSet* TrajStreamCopyState(CTrajStream* I, int state)
+{
+  std::lock_guard<std::mutex> lock(I->StateMutex);
+  auto obj = I->Obj;
+
+  if (state < 0 || state >= obj->NCSet)
+    return nullptr;
+
+  if (obj->CSet[state] || !I->hasState(state) || !I->Valid)
+    return CoordSetCopy(obj->CSet[state]);
+
+  return TrajStreamRead(I, state);
+}
+
+/**
+ * Queue the "traj_stream_prefetch" states after `state` for reading on the
+ * prefetch thread, and drop read-ahead frames which are no longer needed.
+ */
+static void TrajStreamPrefetch(CTrajStream* I, int state)
+{
+  auto obj = I->Obj;
+  int n_ahead = SettingGetGlobal_i(I->G, cSetting_traj_stream_prefetch);
+  int start = std::max(0, state + 1 - I->FirstState);
+  int stop = std::min(start + n_ahead,
+      std::min(I->NFrame, obj->NCSet - I->FirstState));
+
+  std::lock_guard<std::mutex> lock(I->Mutex);
+
+  I->WindowStart = start;
+  I->WindowStop = stop;
+
+  for (auto it = I->Ready.begin(); it != I->Ready.end();) {
+    if (it->first < start || it->first >= stop) {
+      it = I->Ready.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  I->Queue.clear();
+  for (int frame = start; frame < stop; ++frame) {
+    if (!obj->CSet[I->FirstState + frame] && !I->Ready.count(frame))
+      I->Queue.push_back(frame);
+  }
+
+  if (I->Queue.empty())
+    return;
+
+  if (!I->Thread.joinable())
+    I->Thread = std::thread(TrajStreamPrefetchLoop, I);
+
+  I->Cond.notify_one();
+}
+
+/**
+ * Restrict the rebuild range of ObjectMolecule::update() to the current
+ * state (building all states would read the entire trajectory), make sure
+ * it is resident, and start reading ahead. With all states shown, only the
+ * resident ones get updated.
+ */
+void TrajStreamUpdateRange(CTrajStream* I, int* start, int* stop)
+{
+  int current = I->Obj->getCurrentState();
+
+  std::lock_guard<std::mutex> lock(I->StateMutex);
+
+  if (!I->Valid || current < 0) {
+    TrajStreamEvict(I);
+    return;
+  }
+
+  if (*stop - *start > 1) {
+    *start = current;
+    *stop = current + 1;
+  }
+
+  for (int state = *start; state < *stop; ++state) {
+    TrajStreamFetchLocked(I, state);
+  }
+
+  TrajStreamPrefetch(I, current);
+}
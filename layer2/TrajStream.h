@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PyMOLGlobals.h"
+
+struct CoordSet;
+struct ObjectMolecule;
+
+/**
+ * Random access source of raw trajectory frames.
+ */
+class CTrajFrameReader
+{
+public:
+  virtual ~CTrajFrameReader() = default;
+
+  /**
+   * Read frame `index` (0-based, in stream order) into `coords`, which has
+   * room for 3 floats per atom in the file. Calls are serialized by the
+   * stream, but may come from the prefetch thread.
+   */
+  virtual bool read(int index, float* coords) = 0;
+};
+
+/**
+ * States of an ObjectMolecule which are backed by a trajectory file instead
+ * of being kept in memory ("traj_stream" setting).
+ *
+ * States [FirstState, FirstState + NFrame) are only materialized (as copies
+ * of a resident state with the frame's coordinates) when asked for. The
+ * least recently used ones get freed again once the "traj_stream_cache"
+ * budget is exceeded, and "traj_stream_prefetch" frames after the current
+ * state are read ahead on a background thread.
+ *
+ * Non-resident states are NULL in ObjectMolecule::CSet, so code which loops
+ * over CSet directly only sees the resident states. Modifications of a
+ * state are lost once it gets evicted.
+ *
+ * The two most recently fetched states always stay resident, so a caller
+ * can keep the coordinate set pointers of the last two states it fetched.
+ * Code which needs more states at once should use TrajStreamCopyState.
+ * Fetching is thread safe (representation builders on the thread pool may
+ * ask for other states).
+ */
+struct CTrajStream {
+  PyMOLGlobals* G;
+  ObjectMolecule* Obj;
+  std::unique_ptr<CTrajFrameReader> Reader;
+  std::unique_ptr<int[]> Xref; // file atom -> coord set index (or NULL)
+  int NFileAtom;
+  int NIndex;                  // coord set size, streaming stops if it changes
+  int FirstState;
+  int NFrame;
+  bool Valid = true;
+
+  std::mutex StateMutex;       // serializes fetching and eviction
+  std::list<int> Resident;     // states, most recently used first
+
+  // prefetching
+  std::thread Thread;
+  std::mutex ReaderMutex;      // serializes Reader access
+  std::mutex Mutex;            // protects the members below
+  std::condition_variable Cond;
+  std::vector<int> Queue;      // frames to read ahead, in order
+  std::map<int, std::vector<float>> Ready; // frame -> coordinates
+  int WindowStart = 0, WindowStop = 0;     // frames worth keeping in Ready
+  bool Stop = false;
+
+  CTrajStream(PyMOLGlobals* G, ObjectMolecule* obj,
+      std::unique_ptr<CTrajFrameReader> reader, std::unique_ptr<int[]> xref,
+      int n_file_atom, int n_index, int first_state, int n_frame);
+  ~CTrajStream();
+
+  bool hasState(int state) const
+  {
+    return FirstState <= state && state < FirstState + NFrame;
+  }
+};
+
+void TrajStreamAddResident(CTrajStream* I, int state);
+CoordSet* TrajStreamFetch(CTrajStream* I, int state);
+CoordSet* TrajStreamCopyState(CTrajStream* I, int state);
+void TrajStreamUpdateRange(CTrajStream* I, int* start, int* stop);
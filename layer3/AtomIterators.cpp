@@ -148,7 +148,7 @@ bool SeleCoordIterator::next() {
       prev_obj = obj;
     }
 
-    if(state >= obj->NCSet || !(cs = obj->CSet[state]))
+    if(state >= obj->NCSet || !(cs = obj->getCoordSet(state)))
       continue;
 
     atm = I->Table[a].atom;
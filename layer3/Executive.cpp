@@ -66,7 +66,10 @@
 #include"Menu.h"
 #include"Map.h"
 #include"Editor.h"
-#include"RepDot.h"
+#include"Sphere.h"
+#include"SurfaceArea.h"
+#include"ThreadPool.h"
+#include"TrajStream.h"
 #include"Seq.h"
 #include"Text.h"
 #include"PyMOL.h"
@@ -80,6 +83,7 @@
 #include "Lex.h"
 #include "List.h"
 #include "AtomIterators.h"
+#include "NativeAlter.h"
 
 #include"OVContext.h"
 #include"OVLexicon.h"
@@ -3809,6 +3813,13 @@ ExecutiveLoadPrepareArgs(PyMOLGlobals * G,
       break;
     }
 
+    if (content_format == cLoadTypeCCP4Map ||
+        content_format == cLoadTypeCCP4Unspecified ||
+        content_format == cLoadTypeMRC) {
+      // memory mapped by ObjectMapLoadCCP4, no need to read it here
+      break;
+    }
+
     try {
       args.content = pymol::file_get_contents(fname);
       PRINTFB(G, FB_Executive, FB_Blather)
@@ -4040,8 +4051,13 @@ pymol::Result<> ExecutiveLoad(PyMOLGlobals* G, ExecutiveLoadArgs const& args)
   case cLoadTypeCCP4Str:
   case cLoadTypeCCP4Unspecified:
   case cLoadTypeMRC:
-    obj = (CObject *) ObjectMapLoadCCP4(G, (ObjectMap *) origObj, content,
-        state, true, size, quiet, content_format);
+    if (args.content.empty() && fname[0]) {
+      obj = (CObject *) ObjectMapLoadCCP4(G, (ObjectMap *) origObj, fname,
+          state, false, 0, quiet, content_format);
+    } else {
+      obj = (CObject *) ObjectMapLoadCCP4(G, (ObjectMap *) origObj, content,
+          state, true, size, quiet, content_format);
+    }
     break;
   case cLoadTypeCGO:
     obj = (CObject *) ObjectCGOFromFloatArray(G, (ObjectCGO *) origObj,
@@ -6526,8 +6542,18 @@ pymol::Result<> ExecutiveMapSet(PyMOLGlobals* G, const char* name,
     ms = &target->State[target_state];
     if(ms->Active) {
       int iter_id = TrackerNewIter(I_Tracker, 0, list_id);
-      int n_pnt = (ms->Field->points->size() / ms->Field->points->base_size) / 3;
-      float *pnt = (float *) ms->Field->points->data.data();
+      CField *points = ms->Field->points.get();
+      std::unique_ptr<CField> implicit_points;
+      if(!points) {
+        const int *dims = ms->Field->dimensions;
+        int dim4[4] = { dims[0], dims[1], dims[2], 3 };
+        int zero[3] = { 0, 0, 0 };
+        implicit_points.reset(CField::make<float>(G, dim4, 4));
+        IsofieldFillPoints(ms->Field.get(), implicit_points.get(), zero);
+        points = implicit_points.get();
+      }
+      int n_pnt = (points->size() / points->base_size) / 3;
+      float *pnt = (float *) points->data.data();
       float *r_value = pymol::malloc<float>(n_pnt);
       float *l_value = pymol::calloc<float>(n_pnt);
       int *present = pymol::calloc<int>(n_pnt);
@@ -8572,6 +8598,50 @@ pymol::Result<> ExecutiveSetDihe(PyMOLGlobals* G, const char* s1,
 
 
 /*========================================================================*/
+/**
+ * Per-atom surface areas of one state, indexed by atom (zero for atoms
+ * without coordinates). Uses the settings of the dots representation
+ * (dot_solvent, solvent_radius, dot_density) and the atom flags like
+ * RepDotDoNew(cs, cRepDotAreaType, state), but doesn't build any geometry.
+ *
+ * @param n_thread maximum number of threads
+ * @param[out] area_atm obj->NAtom areas
+ */
+static void ExecutiveCoordSetAtomAreas(
+    PyMOLGlobals* G, CoordSet* cs, int n_thread, float* area_atm)
+{
+  auto obj = cs->Obj;
+
+  float solv_rad = 0.f;
+  if (SettingGet<bool>(G, cs->Setting, obj->Setting, cSetting_dot_solvent)) {
+    solv_rad = SettingGet<float>(
+        G, cs->Setting, obj->Setting, cSetting_solvent_radius);
+  }
+
+  auto ds = SettingGet<int>(G, cs->Setting, obj->Setting, cSetting_dot_density);
+  SphereRec const* sp = G->Sphere->Sphere[pymol::clamp(ds, 0, 4)];
+
+  std::vector<float> radius(cs->NIndex), area(cs->NIndex);
+  std::vector<int> surface(cs->NIndex), occlude(cs->NIndex);
+
+  for (int idx = 0; idx < cs->NIndex; ++idx) {
+    auto const& ai = obj->AtomInfo[cs->IdxToAtm[idx]];
+    radius[idx] = ai.vdw + solv_rad;
+    // flag 24 excludes atoms from the surface, flag 25 also from occlusion
+    surface[idx] = !(ai.flags & (cAtomFlag_exfoliate | cAtomFlag_ignore));
+    occlude[idx] = !(ai.flags & cAtomFlag_ignore);
+  }
+
+  pymol::AtomSurfaceArea(cs->Coord.data(), radius.data(), cs->NIndex,
+      surface.data(), occlude.data(), sp, G->ThreadPool, n_thread,
+      area.data());
+
+  std::fill(area_atm, area_atm + obj->NAtom, 0.f);
+  for (int idx = 0; idx < cs->NIndex; ++idx) {
+    area_atm[cs->IdxToAtm[idx]] = area[idx];
+  }
+}
+
 pymol::Result<float> ExecutiveGetArea(
     PyMOLGlobals* G, const char* sele, int state, bool load_b)
 {
@@ -8588,9 +8658,9 @@ pymol::Result<float> ExecutiveGetArea(
   if (!cs)
     return pymol::Error("Invalid state");
 
-  auto rep = (RepDot*) RepDotDoNew(cs, cRepDotAreaType, state);
-  if (!rep)
-    return pymol::Error("Can't get dot representation.");
+  std::vector<float> area(obj0->NAtom);
+  ExecutiveCoordSetAtomAreas(G, cs,
+      std::max(1, SettingGetGlobal_i(G, cSetting_max_threads)), area.data());
 
   if (load_b) {
     /* zero out B-values within selection */
@@ -8602,29 +8672,107 @@ pymol::Result<float> ExecutiveGetArea(
     ExecutiveObjMolSeleOp(G, sele0, &op);
   }
 
-  float const* const area = rep->A;
-  int const* const ati = rep->Atom;
-
-  AtomInfoType* ai = nullptr;
-  int known_member = -1;
-  bool is_member = false;
   float result = 0.f;
 
-  for (int a = 0; a < rep->N; ++a) {
-    if (known_member != ati[a]) {
-      known_member = ati[a];
-      ai = obj0->AtomInfo + known_member;
-      is_member = SelectorIsMember(G, ai->selEntry, sele0);
+  for (int atm = 0; atm < obj0->NAtom; ++atm) {
+    auto ai = obj0->AtomInfo + atm;
+    if (area[atm] != 0.f && SelectorIsMember(G, ai->selEntry, sele0)) {
+      result += area[atm];
+      if (load_b)
+        ai->b += area[atm];
     }
+  }
 
-    if (is_member) {
-      result += area[a];
-      if (load_b)
-        ai->b += area[a];
+  return result;
+}
+
+/**
+ * Per-atom surface areas (see ExecutiveGetArea) of a selection in a single
+ * object, for one state or all states. A single state is split over the
+ * threads by atoms, all states by state.
+ *
+ * @param state object state or -1 for all states
+ * @return one array per state, with the areas of the selected atoms in atom
+ * order (zero for atoms without coordinates in that state)
+ */
+pymol::Result<std::vector<std::vector<float>>> ExecutiveGetAtomAreas(
+    PyMOLGlobals* G, const char* sele, int state)
+{
+  SETUP_SELE(sele, tmpsele0, sele0);
+
+  std::vector<std::vector<float>> result;
+
+  auto obj0 = SelectorGetSingleObjectMolecule(G, sele0);
+  if (!obj0) {
+    if (SelectorCountAtoms(G, sele0, state) > 0)
+      return pymol::Error("Selection must be within a single object");
+    return result;
+  }
+
+  std::vector<int> atoms;
+  for (int atm = 0; atm < obj0->NAtom; ++atm) {
+    if (SelectorIsMember(G, obj0->AtomInfo[atm].selEntry, sele0))
+      atoms.push_back(atm);
+  }
+
+  int n_thread = std::max(1, SettingGetGlobal_i(G, cSetting_max_threads));
+
+  auto get_areas = [&](CoordSet* cs, int n_thread, std::vector<float>& out) {
+    std::vector<float> area(obj0->NAtom);
+    ExecutiveCoordSetAtomAreas(G, cs, n_thread, area.data());
+    for (size_t k = 0; k < atoms.size(); ++k) {
+      out[k] = area[atoms[k]];
+    }
+  };
+
+  if (state != -1) {
+    if (state < -1) {
+      state = obj0->getCurrentState();
     }
+    auto cs = obj0->getCoordSet(state);
+    if (!cs)
+      return pymol::Error("Invalid state");
+    // atoms in parallel
+    result.emplace_back(atoms.size());
+    get_areas(cs, n_thread, result.back());
+    return result;
+  }
+
+  result.resize(obj0->NCSet, std::vector<float>(atoms.size()));
+
+  // One state per task, each state is computed serially (nested pool run).
+  // States are fetched here, not on the workers, in batches: streamed
+  // trajectory states are read into temporary copies, so only one batch is
+  // in memory at a time.
+  const int batch_size = n_thread * 4;
+  std::vector<CoordSet*> csets, copies;
+
+  for (int first = 0; first < obj0->NCSet; first += batch_size) {
+    int n = std::min(batch_size, obj0->NCSet - first);
+
+    csets.assign(n, nullptr);
+    for (int i = 0; i < n; ++i) {
+      int a = first + i;
+      auto traj = obj0->TrajStream;
+      if (traj && traj->hasState(a) && !obj0->CSet[a]) {
+        if ((csets[i] = TrajStreamCopyState(traj, a)))
+          copies.push_back(csets[i]);
+      } else {
+        csets[i] = obj0->CSet[a];
+      }
+    }
+
+    G->ThreadPool->run(n, n_thread, [&](size_t i) {
+      if (csets[i])
+        get_areas(csets[i], n_thread, result[first + i]);
+    });
+
+    for (auto cs : copies) {
+      cs->fFree();
+    }
+    copies.clear();
   }
 
-  rep->R.fFree((Rep*) rep); /* free the representation */
   return result;
 }
 
@@ -9963,6 +10111,8 @@ pymol::Result<int> ExecutiveIterate(PyMOLGlobals * G, const char *str1, const ch
   int sele1 = tmpsele1.getIndex();
   op1.i1 = 0;
   if(sele1 >= 0) {
+    double start = UtilGetSeconds(G);
+    bool native = false;
     op1.code = OMOP_ALTR;
     op1.i1 = 0;
     op1.i2 = read_only;
@@ -9970,12 +10120,25 @@ pymol::Result<int> ExecutiveIterate(PyMOLGlobals * G, const char *str1, const ch
 #else
     op1.s1 = expr;
     op1.py_ob1 = space;
+
+    /* simple expressions are evaluated column-wise without Python */
+    if(SettingGetGlobal_b(G, cSetting_iterate_native)) {
+      if(auto prog = pymol::NativeAlter::compile(G, expr, read_only, space)) {
+        if(!prog->run(sele1, &op1.i1, &native)) {
+          return pymol::Error();
+        }
+      }
+    }
 #endif
 
-    if (!ExecutiveObjMolSeleOp(G, sele1, &op1)) {
+    if (!native && !ExecutiveObjMolSeleOp(G, sele1, &op1)) {
       return pymol::Error();
     }
 
+    PRINTFB(G, FB_Executive, FB_Blather)
+      " %s: %s evaluation, %d atoms, %.4f sec.\n", __func__,
+      native ? "native" : "Python", op1.i1, UtilGetSeconds(G) - start ENDFB(G);
+
     if(!quiet) {
       if(!read_only) {
         PRINTFB(G, FB_Executive, FB_Actions)
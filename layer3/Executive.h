@@ -443,6 +443,8 @@ pymol::Result<char const*> ExecutiveGetType(PyMOLGlobals* G, const char* name);
 
 pymol::Result<float> ExecutiveGetArea(
     PyMOLGlobals*, const char* sele, int state, bool load_b);
+pymol::Result<std::vector<std::vector<float>>> ExecutiveGetAtomAreas(
+    PyMOLGlobals*, const char* sele, int state);
 
 void ExecutiveInvalidateSceneMembers(PyMOLGlobals * G);
 void ExecutiveInvalidateSelectionIndicators(PyMOLGlobals *G);
@@ -427,6 +427,10 @@ bool MovieSceneRecall(PyMOLGlobals * G, const char * name, float animate,
 
       MovieSceneAtom &sceneatom = it->second;
 
+      if (recall_color || recall_rep) {
+        iter.obj->atomColumnsChanged();
+      }
+
       if (recall_color) {
         if (ai->color != sceneatom.color)
           objectstoinvalidate[(CObject*) iter.obj];
@@ -0,0 +1,947 @@
+/*
+ * Native (column-wise) evaluation of simple alter/iterate expressions
+ */
+
+#ifndef _PYMOL_NOPY
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "NativeAlter.h"
+
+#include "AtomInfo.h"
+#include "Executive.h"
+#include "Lex.h"
+#include "ObjectMolecule.h"
+#include "P.h"
+#include "PyMOL.h"
+
+namespace pymol
+{
+
+namespace
+{
+
+enum class ValueType { Int, Float, Str };
+
+/**
+ * Values of an expression for all atoms, or a single value for all atoms
+ * (`scalar`)
+ */
+struct Column {
+  ValueType type = ValueType::Int;
+  bool scalar = false;
+  std::vector<long long> i;
+  std::vector<double> f;
+  std::vector<std::string> s;
+
+  size_t at(size_t k) const { return scalar ? 0 : k; }
+  long long getInt(size_t k) const { return i[at(k)]; }
+  double getFloat(size_t k) const
+  {
+    return type == ValueType::Int ? double(i[at(k)]) : f[at(k)];
+  }
+  const std::string& getStr(size_t k) const { return s[at(k)]; }
+};
+
+template <typename T, typename S> T* get_member_pointer(S* instance, size_t offset)
+{
+  return reinterpret_cast<T*>(reinterpret_cast<char*>(instance) + offset);
+}
+
+/**
+ * Type of atom property `ap` when read, false if not supported
+ */
+bool NativeAlterReadType(const AtomPropertyInfo* ap, ValueType& type)
+{
+  switch (ap->Ptype) {
+  case cPType_schar:
+  case cPType_int:
+  case cPType_uint32:
+  case cPType_index:
+  case cPType_state:
+    type = ValueType::Int;
+    return true;
+  case cPType_float:
+    type = ValueType::Float;
+    return true;
+  case cPType_string:
+  case cPType_int_as_string:
+  case cPType_char_as_type:
+  case cPType_model:
+    type = ValueType::Str;
+    return true;
+  case 0:
+    type = ValueType::Str;
+    return ap->id == ATOM_PROP_RESI;
+  }
+  return false;
+}
+
+/**
+ * True if a value of type `type` can be assigned to atom property `ap` with
+ * the same result as WrapperObjectAssignSubScript
+ */
+bool NativeAlterCanAssign(const AtomPropertyInfo* ap, ValueType type)
+{
+  switch (ap->Ptype) {
+  case cPType_schar:
+  case cPType_int:
+    return type == ValueType::Int;
+  case cPType_float:
+    return type != ValueType::Str;
+  case cPType_string:
+  case cPType_int_as_string:
+    return type != ValueType::Float; // str(float) formatting not replicated
+  case 0:
+    return ap->id == ATOM_PROP_RESI && type != ValueType::Float;
+  }
+  return false;
+}
+
+std::string NativeAlterToStr(const Column& col, size_t k)
+{
+  return col.type == ValueType::Str ? col.getStr(k)
+                                    : std::to_string(col.getInt(k));
+}
+
+} // namespace
+
+struct NativeAlter::Node {
+  enum Kind { Const, Prop, Neg, Add, Sub, Mul, Div, Tuple } kind;
+  ValueType type = ValueType::Int;
+  Column value;                         // Const
+  const AtomPropertyInfo* ap = nullptr; // Prop
+  std::vector<std::unique_ptr<Node>> args;
+};
+
+struct NativeAlter::Stmt {
+  const AtomPropertyInfo* target = nullptr; // assignment, or
+  unique_PyObject_ptr list;                 // list append
+  std::unique_ptr<Node> value;
+};
+
+NativeAlter::NativeAlter(PyMOLGlobals* G) : m_G(G) {}
+NativeAlter::~NativeAlter() = default;
+
+/*========================================================================*/
+namespace
+{
+
+using Node = NativeAlter::Node;
+
+/**
+ * Tokenizer and recursive descent parser for the supported subset of
+ * Python. Any unexpected input makes the whole expression unsupported.
+ */
+class NativeAlterParser
+{
+public:
+  enum TokenKind { End, Name, Int, Float, Str, Op };
+
+  PyMOLGlobals* G;
+  const char* p;
+  TokenKind kind = End;
+  std::string text;
+  bool ok = true;
+
+  NativeAlterParser(PyMOLGlobals* G, const char* expr) : G(G), p(expr)
+  {
+    next();
+  }
+
+  bool fail() { return ok = false; }
+
+  bool isOp(char c) const { return kind == Op && text[0] == c; }
+
+  void next()
+  {
+    text.clear();
+
+    while (*p == ' ' || *p == '\t')
+      ++p;
+
+    if (!ok || !*p) {
+      kind = End;
+      return;
+    }
+
+    // only trailing line breaks (single statement, like Py_single_input)
+    if (*p == '\n' || *p == '\r') {
+      kind = End;
+      for (; *p; ++p) {
+        if (!isspace((unsigned char) *p))
+          fail();
+      }
+      return;
+    }
+
+    const char* start = p;
+
+    if (isalpha((unsigned char) *p) || *p == '_') {
+      while (isalnum((unsigned char) *p) || *p == '_')
+        ++p;
+      kind = Name;
+    } else if (isdigit((unsigned char) *p) ||
+               (*p == '.' && isdigit((unsigned char) p[1]))) {
+      kind = Int;
+      while (isdigit((unsigned char) *p))
+        ++p;
+      if (*p == '.') {
+        kind = Float;
+        for (++p; isdigit((unsigned char) *p);)
+          ++p;
+      }
+      if (*p == 'e' || *p == 'E') {
+        kind = Float;
+        ++p;
+        if (*p == '+' || *p == '-')
+          ++p;
+        if (!isdigit((unsigned char) *p))
+          fail();
+        while (isdigit((unsigned char) *p))
+          ++p;
+      }
+      // hex, complex, digit separators, leading zeros, ...
+      if (isalnum((unsigned char) *p) || *p == '_' || *p == '.' ||
+          (kind == Int && ((start[0] == '0' && p - start > 1) ||
+                              p - start > 15))) {
+        fail();
+      }
+    } else if (*p == '\'' || *p == '"') {
+      char quote = *p++;
+      while (*p && *p != quote && *p != '\\' && *p != '\n')
+        ++p;
+      if (*p != quote) {
+        fail();
+        kind = End;
+        return;
+      }
+      ++p;
+      kind = Str;
+      text.assign(start + 1, p - 1);
+      return;
+    } else if (*p && strchr("+-*/(),.=;", *p)) {
+      ++p;
+      kind = Op;
+      // **, //, ==, augmented assignment
+      if ((*p == '=' && strchr("+-*/=", *start)) ||
+          (*p == *start && strchr("*/", *start))) {
+        fail();
+      }
+    } else {
+      fail();
+    }
+
+    text.assign(start, p);
+  }
+
+  const AtomPropertyInfo* property(const std::string& name) const
+  {
+    return PyMOL_GetAtomPropertyInfo(G->PyMOL, name.c_str());
+  }
+
+  std::unique_ptr<Node> makeNode(Node::Kind kind, ValueType type)
+  {
+    auto node = pymol::make_unique<Node>();
+    node->kind = kind;
+    node->type = type;
+    node->value.type = type;
+    return node;
+  }
+
+  std::unique_ptr<Node> binary(
+      Node::Kind kind, std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs)
+  {
+    if (!lhs || !rhs || lhs->kind == Node::Tuple || rhs->kind == Node::Tuple) {
+      fail();
+      return nullptr;
+    }
+
+    bool lstr = lhs->type == ValueType::Str;
+    bool rstr = rhs->type == ValueType::Str;
+    ValueType type = (lhs->type == ValueType::Int && rhs->type == ValueType::Int)
+                         ? ValueType::Int
+                         : ValueType::Float;
+
+    if (lstr || rstr) {
+      // only string concatenation
+      if (kind != Node::Add || !lstr || !rstr) {
+        fail();
+        return nullptr;
+      }
+      type = ValueType::Str;
+    } else if (kind == Node::Div) {
+      // no ZeroDivisionError possible
+      if (rhs->kind != Node::Const || rhs->value.getFloat(0) == 0.0) {
+        fail();
+        return nullptr;
+      }
+      type = ValueType::Float;
+    }
+
+    auto node = makeNode(kind, type);
+    node->args.push_back(std::move(lhs));
+    node->args.push_back(std::move(rhs));
+    return node;
+  }
+
+  std::unique_ptr<Node> parseAtom()
+  {
+    std::unique_ptr<Node> node;
+
+    switch (kind) {
+    case Int:
+      node = makeNode(Node::Const, ValueType::Int);
+      node->value.i.push_back(std::stoll(text));
+      break;
+    case Float:
+      node = makeNode(Node::Const, ValueType::Float);
+      node->value.f.push_back(strtod(text.c_str(), nullptr));
+      break;
+    case Str:
+      node = makeNode(Node::Const, ValueType::Str);
+      node->value.s.push_back(text);
+      break;
+    case Name: {
+      ValueType type;
+      auto ap = property(text);
+      if (!ap || !NativeAlterReadType(ap, type)) {
+        fail();
+        return nullptr;
+      }
+      node = makeNode(Node::Prop, type);
+      node->ap = ap;
+    } break;
+    case Op:
+      if (isOp('(')) {
+        next();
+        node = parseExpr();
+        if (isOp(',')) {
+          // tuple (only valid as the append argument)
+          auto tuple = makeNode(Node::Tuple, ValueType::Int);
+          tuple->args.push_back(std::move(node));
+          while (ok && isOp(',')) {
+            next();
+            if (isOp(')'))
+              break;
+            tuple->args.push_back(parseExpr());
+          }
+          node = std::move(tuple);
+        }
+        if (!isOp(')'))
+          fail();
+        break;
+      }
+    default:
+      fail();
+    }
+
+    if (node && node->kind == Node::Const)
+      node->value.scalar = true;
+
+    next();
+    if (!ok)
+      return nullptr;
+    return node;
+  }
+
+  std::unique_ptr<Node> parseUnary()
+  {
+    if (isOp('-') || isOp('+')) {
+      bool neg = isOp('-');
+      next();
+      auto node = parseUnary();
+      if (!node || node->kind == Node::Tuple || node->type == ValueType::Str) {
+        fail();
+        return nullptr;
+      }
+      if (!neg)
+        return node;
+      if (node->kind == Node::Const) {
+        if (node->type == ValueType::Int)
+          node->value.i[0] = -node->value.i[0];
+        else
+          node->value.f[0] = -node->value.f[0];
+        return node;
+      }
+      auto result = makeNode(Node::Neg, node->type);
+      result->args.push_back(std::move(node));
+      return result;
+    }
+    return parseAtom();
+  }
+
+  std::unique_ptr<Node> parseTerm()
+  {
+    auto node = parseUnary();
+    while (ok && (isOp('*') || isOp('/'))) {
+      auto op = isOp('*') ? Node::Mul : Node::Div;
+      next();
+      node = binary(op, std::move(node), parseUnary());
+    }
+    return node;
+  }
+
+  std::unique_ptr<Node> parseExpr()
+  {
+    auto node = parseTerm();
+    while (ok && (isOp('+') || isOp('-'))) {
+      auto op = isOp('+') ? Node::Add : Node::Sub;
+      next();
+      node = binary(op, std::move(node), parseTerm());
+    }
+    return node;
+  }
+
+  /**
+   * name = expr
+   * name.attr[.attr...].append(expr)
+   */
+  std::unique_ptr<NativeAlter::Stmt> parseStmt(bool read_only, PyObject* space)
+  {
+    auto stmt = pymol::make_unique<NativeAlter::Stmt>();
+
+    if (kind != Name) {
+      fail();
+      return nullptr;
+    }
+
+    std::vector<std::string> names = {text};
+    next();
+
+    if (isOp('=')) {
+      stmt->target = property(names[0]);
+      next();
+      stmt->value = parseExpr();
+      if (!ok || read_only || !stmt->target || !stmt->value ||
+          stmt->value->kind == Node::Tuple ||
+          !NativeAlterCanAssign(stmt->target, stmt->value->type)) {
+        fail();
+        return nullptr;
+      }
+      return stmt;
+    }
+
+    while (ok && isOp('.')) {
+      next();
+      if (kind != Name)
+        fail();
+      names.push_back(text);
+      next();
+    }
+
+    if (!ok || !isOp('(') || names.size() < 2 || names.back() != "append" ||
+        property(names[0])) {
+      fail();
+      return nullptr;
+    }
+
+    next();
+    stmt->value = parseExpr();
+    if (isOp(','))
+      next();
+    if (!ok || !stmt->value || !isOp(')')) {
+      fail();
+      return nullptr;
+    }
+    next();
+
+    if (stmt->value->kind == Node::Tuple) {
+      for (auto& arg : stmt->value->args) {
+        if (arg->kind == Node::Tuple) {
+          fail();
+          return nullptr;
+        }
+      }
+    }
+
+    // resolve the list, any failure leaves it to the Python path to report
+    PyObject* obj = PyDict_GetItemString(space, names[0].c_str());
+    if (!obj) {
+      fail();
+      return nullptr;
+    }
+    stmt->list.reset(PIncRef(obj));
+    for (size_t i = 1; i + 1 < names.size(); ++i) {
+      stmt->list.reset(PyObject_GetAttrString(stmt->list.get(), names[i].c_str()));
+      if (!stmt->list) {
+        PyErr_Clear();
+        fail();
+        return nullptr;
+      }
+    }
+    if (!PyList_CheckExact(stmt->list.get())) {
+      fail();
+      return nullptr;
+    }
+
+    return stmt;
+  }
+};
+
+/*========================================================================*/
+/*
+ * Integer arithmetic like Python's, which has no overflow: results which
+ * don't fit into long long set `overflow`, and then NativeAlter::run leaves
+ * the expression to the Python path
+ */
+static long long NativeAlterAdd(long long a, long long b, bool& overflow)
+{
+  using limits = std::numeric_limits<long long>;
+  if ((b > 0 && a > limits::max() - b) || (b < 0 && a < limits::min() - b)) {
+    overflow = true;
+    return 0;
+  }
+  return a + b;
+}
+
+static long long NativeAlterSub(long long a, long long b, bool& overflow)
+{
+  using limits = std::numeric_limits<long long>;
+  if ((b < 0 && a > limits::max() + b) || (b > 0 && a < limits::min() + b)) {
+    overflow = true;
+    return 0;
+  }
+  return a - b;
+}
+
+static long long NativeAlterMul(long long a, long long b, bool& overflow)
+{
+  using limits = std::numeric_limits<long long>;
+  if (a > 0 ? (b > 0 ? a > limits::max() / b : b < limits::min() / a)
+            : (b > 0 ? a < limits::min() / b : (a && b < limits::max() / a))) {
+    overflow = true;
+    return 0;
+  }
+  return a * b;
+}
+
+/*========================================================================*/
+/**
+ * Evaluate `node` for `atoms` of `obj`
+ * @param[in,out] overflow set if integer arithmetic overflowed
+ */
+Column NativeAlterEval(PyMOLGlobals* G, const Node& node, ObjectMolecule* obj,
+    const std::vector<int>& atoms, bool& overflow)
+{
+  const size_t n = atoms.size();
+
+  if (node.kind == Node::Const)
+    return node.value;
+
+  Column col;
+  col.type = node.type;
+
+  if (node.kind == Node::Prop) {
+    const auto ap = node.ap;
+    switch (col.type) {
+    case ValueType::Int:
+      col.i.resize(n);
+      break;
+    case ValueType::Float:
+      col.f.resize(n);
+      break;
+    case ValueType::Str:
+      col.s.resize(n);
+      break;
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      auto ai = obj->AtomInfo + atoms[k];
+      switch (ap->Ptype) {
+      case cPType_schar:
+        col.i[k] = *get_member_pointer<signed char>(ai, ap->offset);
+        break;
+      case cPType_int:
+        col.i[k] = *get_member_pointer<int>(ai, ap->offset);
+        break;
+      case cPType_uint32:
+        col.i[k] = *get_member_pointer<uint32_t>(ai, ap->offset);
+        break;
+      case cPType_index:
+        col.i[k] = atoms[k] + 1;
+        break;
+      case cPType_state:
+        col.i[k] = obj->DiscreteFlag ? ai->discrete_state : 0;
+        break;
+      case cPType_float:
+        col.f[k] = *get_member_pointer<float>(ai, ap->offset);
+        break;
+      case cPType_string:
+        col.s[k] = get_member_pointer<char>(ai, ap->offset);
+        break;
+      case cPType_int_as_string:
+        col.s[k] = LexStr(G, *get_member_pointer<lexborrow_t>(ai, ap->offset));
+        break;
+      case cPType_char_as_type:
+        col.s[k] = ai->hetatm ? "HETATM" : "ATOM";
+        break;
+      case cPType_model:
+        col.s[k] = obj->Name;
+        break;
+      default: { // ATOM_PROP_RESI
+        char resi[8];
+        AtomResiFromResv(resi, sizeof(resi), ai);
+        col.s[k] = resi;
+      }
+      }
+    }
+    return col;
+  }
+
+  auto lhs = NativeAlterEval(G, *node.args[0], obj, atoms, overflow);
+
+  if (node.kind == Node::Neg) {
+    col = std::move(lhs);
+    for (auto& v : col.i) {
+      v = NativeAlterSub(0, v, overflow);
+    }
+    for (auto& v : col.f) {
+      v = -v;
+    }
+    return col;
+  }
+
+  auto rhs = NativeAlterEval(G, *node.args[1], obj, atoms, overflow);
+  col.scalar = lhs.scalar && rhs.scalar;
+  const size_t m = col.scalar ? 1 : n;
+
+  switch (col.type) {
+  case ValueType::Str:
+    col.s.resize(m);
+    for (size_t k = 0; k < m; ++k)
+      col.s[k] = lhs.getStr(k) + rhs.getStr(k);
+    break;
+  case ValueType::Int:
+    col.i.resize(m);
+    for (size_t k = 0; k < m; ++k) {
+      long long a = lhs.getInt(k), b = rhs.getInt(k);
+      switch (node.kind) {
+      case Node::Add:
+        col.i[k] = NativeAlterAdd(a, b, overflow);
+        break;
+      case Node::Sub:
+        col.i[k] = NativeAlterSub(a, b, overflow);
+        break;
+      default:
+        col.i[k] = NativeAlterMul(a, b, overflow);
+      }
+    }
+    break;
+  case ValueType::Float:
+    col.f.resize(m);
+    for (size_t k = 0; k < m; ++k) {
+      double a = lhs.getFloat(k), b = rhs.getFloat(k);
+      switch (node.kind) {
+      case Node::Add:
+        col.f[k] = a + b;
+        break;
+      case Node::Sub:
+        col.f[k] = a - b;
+        break;
+      case Node::Mul:
+        col.f[k] = a * b;
+        break;
+      default:
+        col.f[k] = a / b;
+      }
+    }
+    break;
+  }
+
+  return col;
+}
+
+/**
+ * Python object for value `k` of `col`
+ */
+PyObject* NativeAlterToPython(const Column& col, size_t k)
+{
+  switch (col.type) {
+  case ValueType::Int:
+    return PyLong_FromLongLong(col.getInt(k));
+  case ValueType::Float:
+    return PyFloat_FromDouble(col.getFloat(k));
+  default:
+    return PyUnicode_FromString(col.getStr(k).c_str());
+  }
+}
+
+/**
+ * Atom properties read by `node`
+ */
+void NativeAlterReads(
+    const Node& node, std::vector<const AtomPropertyInfo*>& reads)
+{
+  if (node.kind == Node::Prop)
+    reads.push_back(node.ap);
+  for (auto& arg : node.args)
+    NativeAlterReads(*arg, reads);
+}
+
+/**
+ * True if reading `ap` may see a value changed by assigning `target`
+ */
+bool NativeAlterDependsOn(
+    const AtomPropertyInfo* ap, const AtomPropertyInfo* target)
+{
+  switch (target->id) {
+  case ATOM_PROP_ELEM: // also assigns protons, vdw, ...
+    return true;
+  case ATOM_PROP_RESI:
+  case ATOM_PROP_RESV:
+    return ap->id == ATOM_PROP_RESI || ap->id == ATOM_PROP_RESV;
+  }
+  return ap->id == target->id;
+}
+
+} // namespace
+
+/**
+ * Values of all statements for the selected atoms of one object
+ */
+struct NativeAlter::Values {
+  std::vector<Column> cols;                            // assignments
+  std::vector<std::vector<unique_PyObject_ptr>> items; // list appends
+};
+
+/*========================================================================*/
+std::unique_ptr<NativeAlter> NativeAlter::compile(
+    PyMOLGlobals* G, const char* expr, bool read_only, PyObject* space)
+{
+  if (!expr || !space || !PyDict_Check(space))
+    return nullptr;
+
+  std::unique_ptr<NativeAlter> result(new NativeAlter(G));
+  result->m_read_only = read_only;
+
+  NativeAlterParser parser(G, expr);
+
+  while (parser.ok && parser.kind != NativeAlterParser::End) {
+    auto stmt = parser.parseStmt(read_only, space);
+    if (!stmt)
+      return nullptr;
+    result->m_stmts.push_back(std::move(stmt));
+    if (parser.isOp(';')) {
+      parser.next();
+    } else if (parser.kind != NativeAlterParser::End) {
+      return nullptr;
+    }
+  }
+
+  if (!parser.ok || result->m_stmts.empty())
+    return nullptr;
+
+  // all statements are evaluated before anything gets assigned, so no
+  // statement may read what an earlier one assigns
+  std::vector<const AtomPropertyInfo*> reads;
+  for (size_t i = 1; i < result->m_stmts.size(); ++i) {
+    reads.clear();
+    NativeAlterReads(*result->m_stmts[i]->value, reads);
+    for (size_t j = 0; j < i; ++j) {
+      auto target = result->m_stmts[j]->target;
+      if (!target)
+        continue;
+      for (auto ap : reads) {
+        if (NativeAlterDependsOn(ap, target))
+          return nullptr;
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Evaluate all statements for `atoms` of `obj`, without modifying anything
+ * @param[in,out] overflow set if integer arithmetic overflowed
+ * @return false on error (with Python exception set)
+ */
+bool NativeAlter::evaluate(ObjectMolecule* obj, const std::vector<int>& atoms,
+    Values& values, bool& overflow)
+{
+  PyMOLGlobals* G = m_G;
+  const size_t n = atoms.size();
+
+  for (auto& stmt : m_stmts) {
+    if (!stmt->list) {
+      values.cols.push_back(
+          NativeAlterEval(G, *stmt->value, obj, atoms, overflow));
+      if (overflow)
+        return true;
+      continue;
+    }
+
+    std::vector<Column> cols;
+    bool tuple = stmt->value->kind == Node::Tuple;
+    if (tuple) {
+      for (auto& arg : stmt->value->args)
+        cols.push_back(NativeAlterEval(G, *arg, obj, atoms, overflow));
+    } else {
+      cols.push_back(NativeAlterEval(G, *stmt->value, obj, atoms, overflow));
+    }
+
+    if (overflow)
+      return true;
+
+    std::vector<unique_PyObject_ptr> items(n);
+    for (size_t k = 0; k < n; ++k) {
+      if (tuple) {
+        items[k].reset(PyTuple_New(cols.size()));
+        for (size_t j = 0; items[k] && j < cols.size(); ++j) {
+          auto item = NativeAlterToPython(cols[j], k);
+          if (!item)
+            return false;
+          PyTuple_SET_ITEM(items[k].get(), j, item);
+        }
+      } else {
+        items[k].reset(NativeAlterToPython(cols[0], k));
+      }
+      if (!items[k])
+        return false;
+    }
+    values.items.push_back(std::move(items));
+  }
+
+  return true;
+}
+
+/**
+ * Assign the evaluated `values` to `atoms` of `obj` and append the list
+ * items. List items are appended in atom order, as with per-atom evaluation.
+ * @return false on error (with Python exception set)
+ */
+bool NativeAlter::write(
+    ObjectMolecule* obj, const std::vector<int>& atoms, Values& values)
+{
+  PyMOLGlobals* G = m_G;
+  const size_t n = atoms.size();
+  auto col_it = values.cols.begin();
+
+  for (auto& stmt : m_stmts) {
+    if (stmt->list)
+      continue;
+
+    const Column& col = *col_it++;
+    auto ap = stmt->target;
+
+    // one lexicon lookup for all atoms
+    lexidx_t lex_scalar = 0;
+    if (ap->Ptype == cPType_int_as_string && col.scalar)
+      lex_scalar = LexIdx(G, NativeAlterToStr(col, 0).c_str());
+
+    for (size_t k = 0; k < n; ++k) {
+      auto ai = obj->AtomInfo + atoms[k];
+
+      switch (ap->Ptype) {
+      case cPType_schar:
+        *get_member_pointer<signed char>(ai, ap->offset) = int(col.getInt(k));
+        break;
+      case cPType_int:
+        *get_member_pointer<int>(ai, ap->offset) = int(col.getInt(k));
+        break;
+      case cPType_float:
+        *get_member_pointer<float>(ai, ap->offset) =
+            col.type == ValueType::Int ? float(col.getInt(k))
+                                       : float(col.getFloat(k));
+        break;
+      case cPType_string: {
+        auto valstr = NativeAlterToStr(col, k);
+        char* dest = get_member_pointer<char>(ai, ap->offset);
+        if (valstr.size() > size_t(ap->maxlen)) {
+          strncpy(dest, valstr.c_str(), ap->maxlen);
+        } else {
+          strcpy(dest, valstr.c_str());
+        }
+      } break;
+      case cPType_int_as_string:
+        if (col.scalar) {
+          LexAssign(G, *get_member_pointer<lexidx_t>(ai, ap->offset),
+              lex_scalar);
+        } else {
+          LexAssign(G, *get_member_pointer<lexidx_t>(ai, ap->offset),
+              NativeAlterToStr(col, k).c_str());
+        }
+        break;
+      default: // ATOM_PROP_RESI
+        if (col.type == ValueType::Int) {
+          ai->resv = int(col.getInt(k));
+          ai->inscode = '\0';
+        } else {
+          ai->setResi(col.getStr(k).c_str());
+        }
+      }
+
+      PAtomPropertyChanged(G, ai, ap->id);
+    }
+
+    LexDec(G, lex_scalar);
+  }
+
+  for (size_t k = 0; k < n; ++k) {
+    for (size_t i = 0, j = 0; i < m_stmts.size(); ++i) {
+      if (!m_stmts[i]->list)
+        continue;
+      if (PyList_Append(m_stmts[i]->list.get(), values.items[j++][k].get()) < 0)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+bool NativeAlter::run(SelectorID_t sele, int* count, bool* handled)
+{
+  PyMOLGlobals* G = m_G;
+  ObjectMolecule* obj = nullptr;
+  void* iterator = nullptr;
+  std::vector<std::pair<ObjectMolecule*, std::vector<int>>> objs;
+
+  while (ExecutiveIterateObjectMolecule(G, &obj, &iterator)) {
+    std::vector<int> atoms;
+    for (int a = 0; a < obj->NAtom; ++a) {
+      if (SelectorIsMember(G, obj->AtomInfo[a].selEntry, sele))
+        atoms.push_back(a);
+    }
+
+    if (!atoms.empty())
+      objs.emplace_back(obj, std::move(atoms));
+  }
+
+  // evaluate everything first, so an overflow in any object leaves all
+  // atoms untouched for the Python path
+  std::vector<Values> values(objs.size());
+  bool overflow = false;
+
+  for (size_t i = 0; i < objs.size(); ++i) {
+    if (!evaluate(objs[i].first, objs[i].second, values[i], overflow))
+      return false;
+    if (overflow) {
+      *handled = false;
+      return true;
+    }
+  }
+
+  *handled = true;
+
+  for (size_t i = 0; i < objs.size(); ++i) {
+    obj = objs[i].first;
+
+    if (!write(obj, objs[i].second, values[i]))
+      return false;
+
+    *count += objs[i].second.size();
+
+    if (!m_read_only)
+      obj->atomPropertiesChanged();
+  }
+
+  return true;
+}
+
+} // namespace pymol
+
+#endif
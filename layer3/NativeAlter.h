@@ -0,0 +1,79 @@
+/*
+ * Native (column-wise) evaluation of simple alter/iterate expressions
+ */
+
+#pragma once
+
+#ifndef _PYMOL_NOPY
+
+#include <memory>
+#include <vector>
+
+#include "os_python.h"
+#include "PyMOLGlobals.h"
+#include "Selector.h"
+
+struct ObjectMolecule;
+
+namespace pymol
+{
+
+/**
+ * Compiled form of an alter/iterate expression which consists only of
+ * semicolon separated
+ *
+ * - assignments of atom properties: `b = 0`, `chain = "B"`, `q = b * 0.5 + 1`
+ * - list appends: `stored.names.append(name)`, `stored.l.append((resi, b))`
+ *
+ * with constants, atom properties, parentheses and + - * / (division only by
+ * non-zero constants). Each statement is evaluated for all selected atoms of
+ * an object at once, without running Python code per atom.
+ *
+ * Anything else (local variables, function calls, comparisons, ...) is
+ * rejected at compile time and has to take the Python path. So are
+ * statements which read a property assigned by an earlier statement, since
+ * all statements get evaluated before anything is assigned.
+ */
+class NativeAlter
+{
+public:
+  struct Node;
+  struct Stmt;
+
+  ~NativeAlter();
+
+  /**
+   * @param expr alter/iterate expression
+   * @param read_only true for iterate
+   * @param space namespace dict for list lookups
+   * @return NULL if `expr` is not supported
+   */
+  static std::unique_ptr<NativeAlter> compile(
+      PyMOLGlobals* G, const char* expr, bool read_only, PyObject* space);
+
+  /**
+   * Evaluate for all atoms in `sele`
+   * @param[out] count number of atoms
+   * @param[out] handled false if the expression has to take the Python path
+   * after all (integer overflow), nothing was modified then
+   * @return false on error (with Python exception set)
+   */
+  bool run(SelectorID_t sele, int* count, bool* handled);
+
+private:
+  struct Values;
+
+  PyMOLGlobals* m_G = nullptr;
+  bool m_read_only = true;
+  std::vector<std::unique_ptr<Stmt>> m_stmts;
+
+  explicit NativeAlter(PyMOLGlobals* G);
+  bool evaluate(ObjectMolecule* obj, const std::vector<int>& atoms,
+      Values& values, bool& overflow);
+  bool write(ObjectMolecule* obj, const std::vector<int>& atoms,
+      Values& values);
+};
+
+} // namespace pymol
+
+#endif
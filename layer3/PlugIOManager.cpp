@@ -15,6 +15,7 @@ I* Additional authors of this source file include:
 Z* -------------------------------------------------------------------
 */
 
+#include <string>
 #include <vector>
 
 #include"os_python.h"
@@ -32,6 +33,7 @@ Z* -------------------------------------------------------------------
 #include "CGO.h"
 #include "ObjectCGO.h"
 #include "Util.h"
+#include "TrajStream.h"
 
 #ifndef _PYMOL_VMD_PLUGINS
 int PlugIOManagerInit(PyMOLGlobals * G)
@@ -152,6 +154,73 @@ static molfile_plugin_t * find_plugin(CPlugIOManager * I, const char * plugin_ty
   return NULL;
 }
 
+/**
+ * Random access to the frames of a molfile trajectory ("traj_stream").
+ * Plugins can only read forward, so seeking backwards reopens the file.
+ */
+class MolfileFrameReader : public CTrajFrameReader
+{
+  molfile_plugin_t* m_plugin;
+  std::string m_fname;
+  std::string m_type;
+  int m_natoms;
+  void* m_handle = nullptr;
+  int m_pos = 0;                // file frame which will be read next
+
+public:
+  std::vector<int> file_frames; // stream frame -> file frame
+
+  MolfileFrameReader(molfile_plugin_t* plugin, const char* fname,
+      const char* plugin_type, int natoms)
+      : m_plugin(plugin)
+      , m_fname(fname)
+      , m_type(plugin_type)
+      , m_natoms(natoms)
+  {
+  }
+
+  ~MolfileFrameReader() { close(); }
+
+  void close()
+  {
+    if (m_handle) {
+      m_plugin->close_file_read(m_handle);
+      m_handle = nullptr;
+    }
+  }
+
+  bool read(int index, float* coords) override
+  {
+    int target = file_frames[index];
+
+    if (m_handle && target < m_pos) {
+      close();
+    }
+
+    if (!m_handle) {
+      int natoms = m_natoms;
+      m_handle = m_plugin->open_file_read(m_fname.c_str(), m_type.c_str(), &natoms);
+      m_pos = 0;
+      if (!m_handle)
+        return false;
+    }
+
+    // a NULL timestep skips the frame
+    for (; m_pos < target; ++m_pos) {
+      if (m_plugin->read_next_timestep(m_handle, m_natoms, nullptr))
+        return false;
+    }
+
+    molfile_timestep_t timestep{};
+    timestep.coords = coords;
+    if (m_plugin->read_next_timestep(m_handle, m_natoms, &timestep))
+      return false;
+
+    ++m_pos;
+    return true;
+  }
+};
+
 int PlugIOManagerLoadTraj(PyMOLGlobals * G, ObjectMolecule * obj,
                           const char *fname, int frame,
                           int interval, int average, int start,
@@ -230,7 +299,64 @@ int PlugIOManagerLoadTraj(PyMOLGlobals * G, ObjectMolecule * obj,
       auto coordbuf = std::vector<float>(natoms * 3);
       timestep.coords = coordbuf.data();
 
-      {
+      if (SettingGetGlobal_b(G, cSetting_traj_stream) && average < 2 &&
+          !obj->TrajStream) {
+        auto reader = pymol::make_unique<MolfileFrameReader>(
+            plugin, fname, plugin_type, natoms);
+
+        /* index the frames which would be loaded, without reading them */
+        while(!plugin->read_next_timestep(file_handle, natoms, NULL)) {
+          cnt++;
+          if(cnt >= start) {
+            icnt--;
+            if(icnt <= 0) {
+              icnt = interval;
+              reader->file_frames.push_back(cnt - 1);
+              ncnt++;
+              if((stop > 0 && cnt >= stop) || (max > 0 && ncnt >= max))
+                break;
+            }
+          }
+        }
+        plugin->close_file_read(file_handle);
+
+        if(ncnt) {
+          if(frame < 0) frame = obj->NCSet;
+          if(!obj->NCSet) zoom_flag = true;
+
+          /* only the first state is read now, it serves as the template
+           * for all others */
+          ok_assert(1, reader->read(0, timestep.coords));
+          for (int i = 0; i < natoms; ++i) {
+            int idx = xref ? xref[i] : i;
+            if (idx >= 0) {
+              copy3(timestep.coords + 3 * i, cs->coordPtr(idx));
+            }
+          }
+          cs->invalidateRep(cRepAll, cRepInvRep);
+
+          VLACheck(obj->CSet, CoordSet*, frame + ncnt - 1);
+          if(obj->NCSet < frame + ncnt) obj->NCSet = frame + ncnt;
+          for(int state = frame; state < frame + ncnt; ++state) {
+            if(obj->CSet[state]) {
+              obj->CSet[state]->fFree();
+              obj->CSet[state] = NULL;
+            }
+          }
+          obj->CSet[frame] = cs;
+
+          int n_index = cs->NIndex;
+          cs = NULL;
+
+          obj->TrajStream = new CTrajStream(G, obj, std::move(reader),
+              std::move(xref), natoms, n_index, frame, ncnt);
+          TrajStreamAddResident(obj->TrajStream, frame);
+
+          PRINTFB(G, FB_ObjectMolecule, FB_Details)
+            " ObjectMolecule: streaming %d sets into states %d-%d...\n", ncnt,
+            frame + 1, frame + ncnt ENDFB(G);
+        }
+      } else {
 	  /* read_next_timestep fills in &timestep for each iteration; we need
 	   * to copy that out to a new CoordSet, each time. */
           while(!plugin->read_next_timestep(file_handle, natoms, &timestep)) {
@@ -314,8 +440,8 @@ int PlugIOManagerLoadTraj(PyMOLGlobals * G, ObjectMolecule * obj,
                 " ObjectMolecule: skipping set %d...\n", cnt ENDFB(G);
             }
           } /* end while */
-        }
         plugin->close_file_read(file_handle);
+      }
         if(cs)
           cs->fFree();
         SceneChanged(G);
@@ -507,7 +633,7 @@ ObjectMap *PlugIOManagerLoadVol(PyMOLGlobals * G, ObjectMap * obj,
             }
 
             // field
-            ms->Field.reset(new Isofield(G, ms->FDim));
+            ms->Field.reset(new Isofield(G, ms->FDim, true));
             ms->MapSource = cMapSourceVMDPlugin;
             ms->Field->save_points = false;     /* save points in RAM only, not session file */
             ms->Active = true;
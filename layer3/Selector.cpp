@@ -17,7 +17,10 @@ Z* -------------------------------------------------------------------
 #include <algorithm>
 #include <cctype>
 #include <functional>
+#include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include"os_python.h"
@@ -26,6 +29,7 @@ Z* -------------------------------------------------------------------
 
 #include"Base.h"
 #include"Map.h"
+#include"SpatialHash.h"
 #include"Vector.h"
 #include"Err.h"
 #include"Word.h"
@@ -49,6 +53,7 @@ Z* -------------------------------------------------------------------
 #include"Seeker.h"
 #include "Lex.h"
 #include "Mol2Typing.h"
+#include "PyMOL.h"
 
 #include"OVContext.h"
 #include"OVLexicon.h"
@@ -139,6 +144,18 @@ struct EvalElem {
 
   /// read-only access to text
   const char* text() const { return m_text.c_str(); }
+
+  /// Copy without the selection
+  EvalElem copyNoSele() const
+  {
+    EvalElem e;
+    e.level = level;
+    e.imp_op_level = imp_op_level;
+    e.type = type;
+    e.code = code;
+    e.m_text = m_text;
+    return e;
+  }
 };
 
 typedef struct {
@@ -150,6 +167,97 @@ typedef struct {
   int frag;
 } WalkDepthRec;
 
+/**
+ * Compiled selection expression. The reduction order of the operand and
+ * operator stack only depends on the tokens, so it is worked out once by
+ * SelectorCompile and replayed by SelectorExecute.
+ */
+struct SelectorPlan {
+  enum StepType {
+    Select0,
+    Select1,
+    Logic1,
+    ImplicitOr,
+    Logic2,
+    Modulate1,
+    Select2,
+    Select3,
+    Operator22,
+  };
+
+  struct Step {
+    StepType type;
+    int depth; //!< stack position at which the reduction happens
+  };
+
+  std::vector<std::string> tokens; //!< for error messages
+  std::vector<EvalElem> stack;     //!< operands and operators (no results)
+  std::vector<Step> steps;         //!< reductions, in evaluation order
+  bool cacheable = true;           //!< false if tokens resolved by name
+};
+
+/**
+ * Least recently used cache with string keys
+ */
+template <typename T> class SelectorLRUCache
+{
+  using list_type = std::list<std::pair<std::string, T>>;
+  list_type m_items;
+  std::unordered_map<std::string, typename list_type::iterator> m_index;
+  size_t m_capacity;
+
+public:
+  explicit SelectorLRUCache(size_t capacity)
+      : m_capacity(capacity)
+  {
+  }
+
+  T* get(const std::string& key)
+  {
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+      return nullptr;
+    m_items.splice(m_items.begin(), m_items, it->second);
+    return &it->second->second;
+  }
+
+  void put(const std::string& key, T value)
+  {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      m_items.erase(it->second);
+      m_index.erase(it);
+    }
+    m_items.emplace_front(key, std::move(value));
+    m_index[key] = m_items.begin();
+    if (m_items.size() > m_capacity) {
+      m_index.erase(m_items.back().first);
+      m_items.pop_back();
+    }
+  }
+
+  void clear()
+  {
+    m_items.clear();
+    m_index.clear();
+  }
+};
+
+/**
+ * Selection evaluation caches. Compiled expressions are independent of the
+ * atoms. Results of atom property predicates (see SelectorSelect1Cached)
+ * are only valid for the table they were evaluated on.
+ */
+struct SelectorEvalCache {
+  SelectorLRUCache<std::shared_ptr<const SelectorPlan>> Plans{64};
+  SelectorLRUCache<std::vector<uint64_t>> Results{64}; // table bitsets
+
+  // table which `Results` refer to: objects and their atom generations
+  std::vector<std::pair<const ObjectMolecule*, unsigned>> TableKey;
+  size_t TableSize = 0;
+  bool ResultsValid = false;
+};
+
 static pymol::Result<sele_array_t> SelectorSelect(
     PyMOLGlobals* G, const char* sele, int state, SelectorID_t domain, int quiet);
 static std::vector<int> SelectorGetInterstateVLA(PyMOLGlobals* G, int sele1,
@@ -161,8 +269,10 @@ static int SelectorSelect2(PyMOLGlobals * G, EvalElem * base, int state);
 static int SelectorLogic1(PyMOLGlobals * G, EvalElem * base, int state);
 static int SelectorLogic2(PyMOLGlobals * G, EvalElem * base);
 static int SelectorOperator22(PyMOLGlobals * G, EvalElem * base, int state);
-static pymol::Result<sele_array_t> SelectorEvaluate(
-    PyMOLGlobals* G, std::vector<std::string>& word, int state, int quiet);
+static pymol::Result<std::shared_ptr<const SelectorPlan>> SelectorCompile(
+    PyMOLGlobals* G, std::vector<std::string>& word);
+static pymol::Result<sele_array_t> SelectorExecute(
+    PyMOLGlobals* G, const SelectorPlan& plan, int state, int quiet);
 static std::vector<std::string> SelectorParse(PyMOLGlobals * G, const char *s);
 static void SelectorPurgeMembers(PyMOLGlobals * G, SelectorID_t sele);
 static int SelectorEmbedSelection(PyMOLGlobals * G, const int *atom, pymol::zstring_view name,
@@ -338,6 +448,60 @@ static int SelectorGetObjAtmOffset(CSelector * I, ObjectMolecule * obj, int offs
   return -1;
 }
 
+/*========================================================================*/
+namespace {
+struct SelectorCoordSetIndex {
+  ObjectMolecule* obj;
+  const CoordSet* cs;
+  const pymol::SpatialHash* hash; // NULL for small coordinate sets
+};
+} // namespace
+
+/**
+ * Get the persistent spatial indices (see CoordSetUpdateCoord2IdxMap) of
+ * all coordinate sets in `state`, for neighbor queries up to `dist`.
+ *
+ * @param first_model use cNDummyModels to exclude the dummy objects
+ */
+static std::vector<SelectorCoordSetIndex> SelectorGetCoordSetIndices(
+    CSelector* I, int state, float dist, int first_model = 0)
+{
+  std::vector<SelectorCoordSetIndex> result;
+  for (int m = first_model; m < I->Obj.size(); ++m) {
+    auto obj = I->Obj[m];
+    if (!obj || state >= obj->NCSet || !obj->CSet[state])
+      continue;
+    auto cs = obj->CSet[state];
+    result.push_back({obj, cs, CoordSetUpdateCoord2IdxMap(cs, dist)});
+  }
+  return result;
+}
+
+/**
+ * Calls `fn(a)` with the table offset of every atom within `dist` of `v`
+ */
+template <typename Fn>
+static void SelectorForEachWithin(CSelector* I,
+    const std::vector<SelectorCoordSetIndex>& indices, const float* v,
+    float dist, Fn&& fn)
+{
+  for (auto& rec : indices) {
+    auto emit = [&](int idx) {
+      int a = SelectorGetObjAtmOffset(I, rec.obj, rec.cs->IdxToAtm[idx]);
+      if (a >= 0)
+        fn(a);
+    };
+    if (rec.hash) {
+      rec.hash->forEachWithin(v, dist, emit);
+    } else {
+      for (int idx = 0; idx < rec.cs->NIndex; ++idx) {
+        if (within3f(rec.cs->coordPtr(idx), v, dist))
+          emit(idx);
+      }
+    }
+  }
+}
+
 #define STYP_VALU 0
 #define STYP_OPR1 1
 #define STYP_OPR2 2
@@ -1384,6 +1548,7 @@ int SelectorClassifyAtoms(PyMOLGlobals * G, int sele, int preserve,
       /* mark which atoms we can write to */
 
       ai0 = obj->AtomInfo + I->Table[a0].atom;
+      obj->atomColumnsChanged();
       if(preserve) {
         printf("NOT IMPLEMENTED\n");
       } else {
@@ -4938,6 +5103,31 @@ std::vector<int> SelectorGetInterstateVLA(
     return {};
   }
 
+  std::vector<int> out;
+
+  if (state1 >= 0) {
+    // one coordinate set per object, reuse their persistent indices
+    CSelector* I = G->Selector;
+    std::vector<SelectorCoordSetIndex> indices;
+    for (SeleCoordIterator iter(G, sele1, state1, false); iter.next();) {
+      if (indices.empty() || indices.back().cs != iter.cs) {
+        indices.push_back(
+            {iter.obj, iter.cs, CoordSetUpdateCoord2IdxMap(iter.cs, cutoff)});
+      }
+    }
+
+    for (SeleCoordIterator iter(G, sele2, state2, false); iter.next();) {
+      SelectorForEachWithin(I, indices, iter.getCoord(), cutoff, [&](int a1) {
+        if (flags[a1]) {
+          out.push_back(a1);
+          out.push_back(iter.a);
+        }
+      });
+    }
+
+    return out;
+  }
+
   std::unique_ptr<MapType> map(MapNewFlagged(
       G, -cutoff, pymol::flatten(coords), table_size, nullptr, flags.data()));
 
@@ -4947,8 +5137,6 @@ std::vector<int> SelectorGetInterstateVLA(
     return {};
   }
 
-  std::vector<int> out;
-
   for (SeleCoordIterator iter(G, sele2, state2, false); iter.next();) {
     const float* v2 = iter.getCoord();
     for (const auto a1 : MapEIter(*map, v2)) {
@@ -4968,7 +5156,7 @@ int SelectorMapMaskVDW(PyMOLGlobals * G, int sele1, ObjectMapState * oMap, float
                        int state)
 {
   CSelector *I = G->Selector;
-  float *v2;
+  float v2[3];
   int n1;
   int a, b, c;
   int at;
@@ -5026,7 +5214,7 @@ int SelectorMapMaskVDW(PyMOLGlobals * G, int sele1, ObjectMapState * oMap, float
           for(c = oMap->Min[2]; c <= oMap->Max[2]; c++) {
             F3(oMap->Field->data, a, b, c) = 0.0;
 
-            v2 = F4Ptr(oMap->Field->points, a, b, c, 0);
+            oMap->Field->getPoint(a, b, c, v2);
 
             for (const auto j : MapEIter(*map, v2)) {
               const auto* ai =
@@ -5079,7 +5267,7 @@ int SelectorMapGaussian(PyMOLGlobals * G, int sele1, ObjectMapState * oMap,
                         float resolution)
 {
   CSelector *I = G->Selector;
-  float *v2;
+  float v2[3];
   int n1, n2;
   int a, b, c;
   int at;
@@ -5470,7 +5658,7 @@ int SelectorMapGaussian(PyMOLGlobals * G, int sele1, ObjectMapState * oMap,
         for(b = oMap->Min[1]; b <= oMap->Max[1]; b++) {
           for(c = oMap->Min[2]; c <= oMap->Max[2]; c++) {
             e_val = 0.0;
-            v2 = F4Ptr(oMap->Field->points, a, b, c, 0);
+            oMap->Field->getPoint(a, b, c, v2);
                 if(use_max) {
                   float e_partial;
                   for (const auto j : MapEIter(*map, v2)) {
@@ -5562,7 +5750,7 @@ int SelectorMapCoulomb(PyMOLGlobals * G, int sele1, ObjectMapState * oMap,
                        float cutoff, int state, int neutral, int shift, float shift_power)
 {
   CSelector *I = G->Selector;
-  float *v2;
+  float v2[3];
   int a, b, c, j;
   int at;
   int s, idx;
@@ -5689,7 +5877,6 @@ int SelectorMapCoulomb(PyMOLGlobals * G, int sele1, ObjectMapState * oMap,
     int *min = oMap->Min;
     int *max = oMap->Max;
     CField *data = oMap->Field->data.get();
-    CField *points = oMap->Field->points.get();
     float dist;
 
     if(cutoff > 0.0F) {         /* we are using a cutoff */
@@ -5715,7 +5902,7 @@ int SelectorMapCoulomb(PyMOLGlobals * G, int sele1, ObjectMapState * oMap,
           for(b = min[1]; b <= max[1]; b++) {
             for(c = min[2]; c <= max[2]; c++) {
               F3(data, a, b, c) = 0.0F;
-              v2 = F4Ptr(points, a, b, c, 0);
+              oMap->Field->getPoint(a, b, c, v2);
               {
                 {
                   for (const auto j : MapEIter(*map, v2)) {
@@ -5777,7 +5964,7 @@ int SelectorMapCoulomb(PyMOLGlobals * G, int sele1, ObjectMapState * oMap,
           for(c = min[2]; c <= max[2]; c++) {
             F3(data, a, b, c) = 0.0F;
             v1 = point;
-            v2 = F4Ptr(points, a, b, c, 0);
+            oMap->Field->getPoint(a, b, c, v2);
             for(j = 0; j < n_point; j++) {
               dist = (float) diff3f(v1, v2);
               v1 += 3;
@@ -6027,8 +6214,8 @@ pymol::Result<> SelectorLoadCoords(PyMOLGlobals * G, PyObject * coords, int sele
       matrix_ptr = ObjectGetTotalMatrix(iter.obj, state, false, matrix) ? matrix : NULL;
       mat_cs = iter.cs;
 
-      // invalidate reps
-      iter.cs->invalidateRep(cRepAll, cRepInvRep);
+      // invalidate reps and the spatial index (Coord2Idx)
+      iter.cs->invalidateRep(cRepAll, cRepInvCoord);
     }
 
     // handle matrix
@@ -6044,6 +6231,323 @@ pymol::Result<> SelectorLoadCoords(PyMOLGlobals * G, PyObject * coords, int sele
   return {};
 }
 
+/*========================================================================*/
+#ifdef _PYMOL_NUMPY
+/*
+ * Numpy type of atom property `ap`. String properties are represented as
+ * int32 codes into a table of unique values (`is_string`). Returns
+ * NPY_NOTYPE for unsupported properties.
+ */
+static int SelectorAtomColumnType(const AtomPropertyInfo * ap, bool * is_string)
+{
+  *is_string = false;
+  switch (ap->Ptype) {
+    case cPType_float:
+      return NPY_FLOAT32;
+    case cPType_schar:
+      return NPY_INT8;
+    case cPType_int:
+    case cPType_index:
+      return NPY_INT32;
+    case cPType_uint32:
+      return NPY_UINT32;
+    case cPType_string:
+    case cPType_int_as_string:
+    case cPType_model:
+      *is_string = true;
+      return NPY_INT32;
+    case 0:
+      if(ap->id == ATOM_PROP_RESI) {
+        *is_string = true;
+        return NPY_INT32;
+      }
+  }
+  return NPY_NOTYPE;
+}
+
+template <typename T>
+static T * SelectorAtomMember(AtomInfoType * ai, const AtomPropertyInfo * ap)
+{
+  return reinterpret_cast<T *>(reinterpret_cast<char *>(ai) + ap->offset);
+}
+#endif
+
+/*========================================================================*/
+/*
+ * Get atom property `name` of all atoms in the selection as a 1-D numpy
+ * array. Equivalent to
+ *
+ * PyMOL> values = []
+ * PyMOL> cmd.iterate(sele, 'values.append(b)')
+ * PyMOL> values = numpy.array(values)
+ *
+ * String properties (name, resn, chain, ss, ...) are returned as a
+ * (codes, table) tuple, with an int32 array of indices into a list of the
+ * unique values.
+ */
+pymol::Result<PyObject*> SelectorGetAtomColumnAsNumPy(PyMOLGlobals * G, int sele, const char * name)
+{
+#ifndef _PYMOL_NUMPY
+  return pymol::Error("No numpy support");
+#else
+  auto ap = PyMOL_GetAtomPropertyInfo(G->PyMOL, name);
+  if(!ap) {
+    return pymol::make_error("Unknown atom property '", name, "'");
+  }
+
+  bool is_string;
+  int typenum = SelectorAtomColumnType(ap, &is_string);
+  if(typenum == NPY_NOTYPE) {
+    return pymol::make_error("Atom property '", name, "' not supported");
+  }
+
+  SelectorUpdateTable(G, cSelectorUpdateTableAllStates, -1);
+
+  SeleAtomIterator iter(G, sele);
+  npy_intp nAtom = 0;
+  while(iter.next())
+    nAtom++;
+
+  import_array1(pymol::Error("numpy import failed"));
+
+  unique_PyObject_ptr array(PyArray_SimpleNew(1, &nAtom, typenum));
+  if(!array) {
+    return pymol::Error("array allocation failed");
+  }
+
+  void * data = PyArray_DATA((PyArrayObject *) array.get());
+  npy_intp i = 0;
+
+  if(!is_string) {
+    for(iter.reset(); iter.next(); ++i) {
+      auto ai = iter.getAtomInfo();
+      switch(ap->Ptype) {
+        case cPType_float:
+          ((float *) data)[i] = *SelectorAtomMember<float>(ai, ap);
+          break;
+        case cPType_schar:
+          ((signed char *) data)[i] = *SelectorAtomMember<signed char>(ai, ap);
+          break;
+        case cPType_int:
+          ((int *) data)[i] = *SelectorAtomMember<int>(ai, ap);
+          break;
+        case cPType_uint32:
+          ((uint32_t *) data)[i] = *SelectorAtomMember<uint32_t>(ai, ap);
+          break;
+        case cPType_index:
+          ((int *) data)[i] = iter.getAtm() + 1;
+          break;
+      }
+    }
+    return array.release();
+  }
+
+  // strings: number the unique values in order of appearance
+  auto codes = (int *) data;
+  std::vector<std::string> table;
+  std::unordered_map<lexidx_t, int> lex_codes;
+  std::unordered_map<std::string, int> str_codes;
+
+  auto str_code = [&](const char * s) {
+    auto it = str_codes.emplace(s, int(table.size()));
+    if(it.second)
+      table.push_back(s);
+    return it.first->second;
+  };
+
+  for(iter.reset(); iter.next(); ++i) {
+    auto ai = iter.getAtomInfo();
+    switch(ap->Ptype) {
+      case cPType_int_as_string: {
+        lexidx_t lex = *SelectorAtomMember<lexidx_t>(ai, ap);
+        auto it = lex_codes.find(lex);
+        if(it == lex_codes.end()) {
+          it = lex_codes.emplace(lex, str_code(LexStr(G, lex))).first;
+        }
+        codes[i] = it->second;
+      } break;
+      case cPType_string:
+        codes[i] = str_code(SelectorAtomMember<char>(ai, ap));
+        break;
+      case cPType_model:
+        codes[i] = str_code(iter.obj->Name);
+        break;
+      default: { // ATOM_PROP_RESI
+        char resi[8];
+        AtomResiFromResv(resi, sizeof(resi), ai);
+        codes[i] = str_code(resi);
+      }
+    }
+  }
+
+  return Py_BuildValue("NN", array.release(), PConvToPyObject(table));
+#endif
+}
+
+/*========================================================================*/
+/*
+ * Set atom property `name` of all atoms in the selection from a 1-D
+ * sequence (most efficient with numpy arrays). Equivalent to
+ *
+ * PyMOL> values = iter(values)
+ * PyMOL> cmd.alter(sele, 'b = next(values)')
+ *
+ * For string properties, `values` are either strings, or (if `table` is not
+ * None) integer indices into `table`, as returned by
+ * SelectorGetAtomColumnAsNumPy.
+ */
+pymol::Result<> SelectorLoadAtomColumn(PyMOLGlobals * G, PyObject * values,
+    PyObject * table, int sele, const char * name)
+{
+#ifndef _PYMOL_NUMPY
+  return pymol::Error("No numpy support");
+#else
+  auto ap = PyMOL_GetAtomPropertyInfo(G->PyMOL, name);
+  if(!ap) {
+    return pymol::make_error("Unknown atom property '", name, "'");
+  }
+
+  bool is_string;
+  int typenum = SelectorAtomColumnType(ap, &is_string);
+  if(typenum == NPY_NOTYPE || ap->Ptype == cPType_index ||
+      ap->Ptype == cPType_model) {
+    return pymol::make_error("Atom property '", name, "' is read-only");
+  }
+
+  if(table == Py_None) {
+    table = nullptr;
+  } else if(table && !is_string) {
+    return pymol::Error("table only supported for string properties");
+  }
+
+  SelectorUpdateTable(G, cSelectorUpdateTableAllStates, -1);
+
+  SeleAtomIterator iter(G, sele);
+  npy_intp nAtom = 0;
+  while(iter.next())
+    nAtom++;
+
+  import_array1(pymol::Error("numpy import failed"));
+
+  std::vector<std::string> strings;
+  unique_PyObject_ptr array;
+
+  if(is_string && !table) {
+    // sequence of strings -> codes into a table of unique values
+    unique_PyObject_ptr seq(PySequence_Fast(values, "values must be a sequence"));
+    if(!seq) {
+      return pymol::Error();
+    }
+    if(PySequence_Fast_GET_SIZE(seq.get()) != nAtom) {
+      return pymol::Error("Atom count mismatch");
+    }
+    std::unordered_map<std::string, int> str_codes;
+    array.reset(PyArray_SimpleNew(1, &nAtom, NPY_INT32));
+    if(!array) {
+      return pymol::Error();
+    }
+    auto codes = (int *) PyArray_DATA((PyArrayObject *) array.get());
+    for(npy_intp i = 0; i < nAtom; ++i) {
+      unique_PyObject_ptr valobj(
+          PyObject_Str(PySequence_Fast_GET_ITEM(seq.get(), i)));
+      if(!valobj) {
+        return pymol::Error();
+      }
+      auto it = str_codes.emplace(PyString_AsString(valobj.get()),
+          int(strings.size()));
+      if(it.second)
+        strings.push_back(it.first->first);
+      codes[i] = it.first->second;
+    }
+  } else {
+    array.reset(PyArray_FROMANY(values, typenum, 1, 1,
+          NPY_ARRAY_CARRAY | NPY_ARRAY_FORCECAST));
+    if(!array) {
+      return pymol::Error();
+    }
+    if(PyArray_DIM((PyArrayObject *) array.get(), 0) != nAtom) {
+      return pymol::Error("Atom count mismatch");
+    }
+    if(table && !PConvFromPyObject(G, table, strings)) {
+      return pymol::Error("table must be a list of strings");
+    }
+  }
+
+  const void * data = PyArray_DATA((PyArrayObject *) array.get());
+
+  if(is_string) {
+    auto codes = (const int *) data;
+    for(npy_intp i = 0; i < nAtom; ++i) {
+      if(codes[i] < 0 || codes[i] >= int(strings.size())) {
+        return pymol::Error("code out of table range");
+      }
+    }
+  }
+
+  // resolve lexicon references once per unique value
+  std::vector<lexidx_t> lex;
+  if(ap->Ptype == cPType_int_as_string) {
+    for(auto& s : strings) {
+      lex.push_back(LexIdx(G, s.c_str()));
+    }
+  }
+
+  ObjectMolecule * prev_obj = nullptr;
+  npy_intp i = 0;
+
+  for(iter.reset(); iter.next(); ++i) {
+    auto ai = iter.getAtomInfo();
+    switch(ap->Ptype) {
+      case cPType_float:
+        *SelectorAtomMember<float>(ai, ap) = ((const float *) data)[i];
+        break;
+      case cPType_schar:
+        *SelectorAtomMember<signed char>(ai, ap) = ((const signed char *) data)[i];
+        break;
+      case cPType_int:
+        *SelectorAtomMember<int>(ai, ap) = ((const int *) data)[i];
+        break;
+      case cPType_uint32:
+        *SelectorAtomMember<uint32_t>(ai, ap) = ((const uint32_t *) data)[i];
+        break;
+      case cPType_int_as_string:
+        LexAssign(G, *SelectorAtomMember<lexidx_t>(ai, ap),
+            lex[((const int *) data)[i]]);
+        break;
+      case cPType_string: {
+        auto& s = strings[((const int *) data)[i]];
+        auto dest = SelectorAtomMember<char>(ai, ap);
+        strncpy(dest, s.c_str(), ap->maxlen);
+        dest[std::min<size_t>(s.size(), ap->maxlen)] = '\0';
+      } break;
+      default: // ATOM_PROP_RESI
+        ai->setResi(strings[((const int *) data)[i]].c_str());
+    }
+
+    PAtomPropertyChanged(G, ai, ap->id);
+
+    if(prev_obj != iter.obj) {
+      if(prev_obj)
+        prev_obj->atomPropertiesChanged();
+      prev_obj = iter.obj;
+    }
+  }
+
+  if(prev_obj)
+    prev_obj->atomPropertiesChanged();
+
+  for(auto idx : lex) {
+    LexDec(G, idx);
+  }
+
+  if(nAtom) {
+    SeqChanged(G);
+  }
+
+  return {};
+#endif
+}
+
 /*========================================================================*/
 pymol::Result<> SelectorUpdateCmd(PyMOLGlobals* G, //
     SelectorID_t sele0,                            //
@@ -7159,13 +7663,30 @@ CSelector::~CSelector()
   ExecutiveInvalidateSelectionIndicatorsCGO(G);
 }
 
-static void SelectorClean(PyMOLGlobals* G)
+/**
+ * Move the table of all atoms out of the way before Table/Obj get replaced
+ */
+static void SelectorStashFullTable(CSelector* I)
 {
-  auto I = G->Selector;
+  if (I->TableIsFull) {
+    std::swap(I->Table, I->FullTable);
+    std::swap(I->Obj, I->FullObj);
+    I->TableIsFull = false;
+  }
+}
+
+static void SelectorCleanImpl(PyMOLGlobals* G, CSelector* I)
+{
+  SelectorStashFullTable(I);
   I->Table.clear();
   I->Obj.clear();
 }
 
+static void SelectorClean(PyMOLGlobals* G)
+{
+  SelectorCleanImpl(G, G->Selector);
+}
+
 /*========================================================================*/
 static sele_array_t SelectorUpdateTableSingleObject(PyMOLGlobals * G, ObjectMolecule * obj,
                                             int req_state,
@@ -7301,6 +7822,73 @@ int SelectorUpdateTable(PyMOLGlobals * G, int req_state, SelectorID_t domain)
   return (SelectorUpdateTableImpl(G, G->Selector, req_state, domain));
 }
 
+/**
+ * Update the table of all atoms in all states. Objects are contiguous
+ * segments in the table, so only the segments from the first added,
+ * removed or resized object onwards need to be rewritten, and nothing if
+ * no object changed.
+ */
+static void SelectorUpdateFullTable(PyMOLGlobals* G, CSelector* I)
+{
+  void* iterator = nullptr;
+  ObjectMolecule* obj = nullptr;
+
+  if (!I->TableIsFull) {
+    std::swap(I->Table, I->FullTable);
+    std::swap(I->Obj, I->FullObj);
+    I->FullTable.clear();
+    I->FullObj.clear();
+    I->TableIsFull = true;
+  }
+
+  std::vector<ObjectMolecule*> objs = {I->Origin.get(), I->Center.get()};
+  I->NCSet = 0;
+  while (ExecutiveIterateObjectMolecule(G, &obj, &iterator)) {
+    if (I->NCSet < obj->NCSet)
+      I->NCSet = obj->NCSet;
+    if (obj->NAtom) {
+      objs.push_back(obj);
+    } else {
+      obj->SeleBase = 0;
+    }
+  }
+
+  // keep the unchanged leading segments
+  size_t m = 0;
+  size_t c = 0;
+  for (; m < objs.size() && m < I->Obj.size(); ++m) {
+    if (I->Obj[m] != objs[m] || I->FullNAtom[m] != objs[m]->NAtom)
+      break;
+    objs[m]->SeleBase = c;
+    c += objs[m]->NAtom;
+  }
+
+  if (m == objs.size() && m == I->Obj.size())
+    return;
+
+  PRINTFD(G, FB_Selector)
+    " %s: rebuilding %zu of %zu models\n", __func__, objs.size() - m,
+    objs.size() ENDFD;
+
+  size_t n_atom = c;
+  for (size_t i = m; i < objs.size(); ++i)
+    n_atom += objs[i]->NAtom;
+
+  I->Obj.resize(m);
+  I->FullNAtom.resize(m);
+  I->Table.resize(n_atom);
+
+  for (; m < objs.size(); ++m) {
+    obj = objs[m];
+    obj->SeleBase = c;
+    for (int a = 0; a < obj->NAtom; ++a) {
+      I->Table[c++] = {int(m), a};
+    }
+    I->Obj.push_back(obj);
+    I->FullNAtom.push_back(obj->NAtom);
+  }
+}
+
 int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, SelectorID_t domain)
 {
   int a = 0;
@@ -7317,7 +7905,13 @@ int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, Selec
   if(!I->Center)
     I->Center.reset(ObjectMoleculeDummyNew(G, cObjectMoleculeDummyCenter));
 
-  SelectorClean(G);
+  if(req_state == cSelectorUpdateTableAllStates && domain < 0) {
+    I->SeleBaseOffsetsValid = true;     /* all states -> all atoms -> offsets valid */
+    SelectorUpdateFullTable(G, I);
+    return (true);
+  }
+
+  SelectorCleanImpl(G, I);
   I->NCSet = 0;
 
   /* take a summary of PyMOL's current state; foreach molecular object
@@ -7392,7 +7986,7 @@ int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, Selec
     } else {
       if(state >= obj->NCSet)
         skip_flag = true;
-      else if(!obj->CSet[state])
+      else if(!obj->getCoordSet(state))
         skip_flag = true;
     }
 
@@ -7488,15 +8082,69 @@ int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, Selec
 
 
 /*========================================================================*/
+/**
+ * Check if results in the evaluation cache were computed on the current
+ * table, otherwise discard them. Results are only kept for tables with all
+ * atoms of all objects (table layout given by the objects).
+ */
+static void SelectorEvalCacheCheckTable(CSelector* I)
+{
+  auto cache = I->EvalCache.get();
+
+  if (!I->SeleBaseOffsetsValid) {
+    cache->ResultsValid = false;
+    return;
+  }
+
+  bool same = cache->ResultsValid && cache->TableSize == I->Table.size() &&
+              cache->TableKey.size() == I->Obj.size();
+  for (size_t m = 0; same && m < I->Obj.size(); ++m) {
+    same = cache->TableKey[m].first == I->Obj[m] &&
+           cache->TableKey[m].second == I->Obj[m]->AtomGeneration;
+  }
+
+  if (!same) {
+    cache->Results.clear();
+    cache->TableSize = I->Table.size();
+    cache->TableKey.resize(I->Obj.size());
+    for (size_t m = 0; m < I->Obj.size(); ++m) {
+      cache->TableKey[m] = {I->Obj[m], I->Obj[m]->AtomGeneration};
+    }
+  }
+
+  cache->ResultsValid = true;
+}
+
 static pymol::Result<sele_array_t> SelectorSelect(
     PyMOLGlobals* G, const char* sele, int state, SelectorID_t domain, int quiet)
 {
+  CSelector* I = G->Selector;
   SelectorUpdateTable(G, state, domain);
-  auto parsed = SelectorParse(G, sele);
-  if (!parsed.empty()) {
-    return SelectorEvaluate(G, parsed, state, quiet);
+  SelectorEvalCacheCheckTable(I);
+
+  // compiled expressions depend on the "ignore_case" setting
+  std::string key(sele);
+  key += SettingGetGlobal_b(G, cSetting_ignore_case) ? '\1' : '\0';
+
+  std::shared_ptr<const SelectorPlan> plan;
+  if (auto cached = I->EvalCache->Plans.get(key)) {
+    plan = *cached;
+  } else {
+    auto parsed = SelectorParse(G, sele);
+    if (parsed.empty()) {
+      return {};
+    }
+    auto compiled = SelectorCompile(G, parsed);
+    if (!compiled) {
+      return compiled.error();
+    }
+    plan = std::move(compiled.result());
+    if (plan->cacheable) {
+      I->EvalCache->Plans.put(key, plan);
+    }
   }
-  return {};
+
+  return SelectorExecute(G, *plan, state, quiet);
 }
 
 
@@ -7537,32 +8185,10 @@ static int SelectorModulate1(PyMOLGlobals * G, EvalElem * base, int state)
     if(ok) {
       for(d = 0; d < I->NCSet; d++) {
         if((state < 0) || (d == state)) {
-          n1 = 0;
-
-          const size_t table_size = I->Table.size();
-          auto coords_flat = std::vector<float>(table_size * 3);
-          auto* coords = pymol::reshape<3>(coords_flat.data());
-          auto Flag1 = std::vector<MapFlag_t>(table_size, 0);
-
           // Potential atoms to be selected (exclude dummies)
-          for (a = cNDummyAtoms; a < I->Table.size(); a++) {
-            at = I->Table[a].atom;
-            obj = I->Obj[I->Table[a].model];
-            if(d < obj->NCSet)
-              cs = obj->CSet[d];
-            else
-              cs = NULL;
-            if(cs) {
-              if (CoordSetGetAtomVertex(cs, at, coords[a])) {
-                Flag1[a] = true;
-                n1++;
-              }
-            }
-          }
-          if(n1) {
-            std::unique_ptr<MapType> map(MapNewFlagged(G, -dist,
-                pymol::flatten(coords), table_size, nullptr, Flag1.data()));
-	    CHECKOK(ok, map);
+          auto indices =
+              SelectorGetCoordSetIndices(I, d, dist, cNDummyModels);
+          if(!indices.empty()) {
             if(ok) {
               nCSet = SelectorGetArrayNCSet(G, base[1].sele, false);
               for(e = 0; ok && e < nCSet; e++) {
@@ -7580,15 +8206,14 @@ static int SelectorModulate1(PyMOLGlobals * G, EvalElem * base, int state)
                         idx = cs->atmToIdx(at);
                         if(idx >= 0) {
                           v2 = cs->coordPtr(idx);
-                          for (const auto j : MapEIter(*map, v2, false)) {
+                          SelectorForEachWithin(I, indices, v2, dist, [&](int j) {
                             if (!base[0].sele[j] &&
                                 (!base[1].sele[j] ||
                                     base[1].code == SELE_EXP_)) {
                               /*exclude current selection */
-                              if (within3f(coords[j], v2, dist))
-                                base[0].sele[j] = true;
+                              base[0].sele[j] = true;
                             }
-                          }
+                          });
                         }
                       }
                     }
@@ -7728,6 +8353,41 @@ static int SelectorModulate1(PyMOLGlobals * G, EvalElem * base, int state)
 }
 
 
+/*========================================================================*/
+/*
+ * Set sele[a] = pred(columns, atm) for all table atoms, testing the dense
+ * copies of hot atom fields (see ObjectMolecule::getAtomColumns) instead
+ * of the atom records. Returns the number of selected atoms.
+ */
+template <typename Pred>
+static int SelectorSelectByColumns(CSelector * I, int * sele, Pred pred)
+{
+  ObjectMolecule *obj = NULL;
+  const AtomInfoColumns *columns = NULL;
+  int c = 0;
+  for(size_t a = cNDummyAtoms; a < I->Table.size(); a++) {
+    const auto& table_a = I->Table[a];
+    if(I->Obj[table_a.model] != obj) {
+      obj = I->Obj[table_a.model];
+      columns = &obj->getAtomColumns();
+    }
+    if((sele[a] = pred(*columns, table_a.atom)))
+      c++;
+  }
+  return c;
+}
+
+/*
+ * Select all atoms with any of the atom flags in `mask`
+ */
+static void SelectorSelectByFlags(CSelector * I, int * sele, unsigned int mask)
+{
+  SelectorSelectByColumns(I, sele,
+      [mask](const AtomInfoColumns& columns, int atm) {
+        return (columns.flags[atm] & mask) != 0;
+      });
+}
+
 /*========================================================================*/
 static int SelectorSelect0(PyMOLGlobals * G, EvalElem * passed_base)
 {
@@ -7787,8 +8447,10 @@ static int SelectorSelect0(PyMOLGlobals * G, EvalElem * passed_base)
       base[0].sele[a] = I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].hetatm;
     break;
   case SELE_HYDz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] = I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].isHydrogen();
+    SelectorSelectByColumns(I, base[0].sele.get(),
+        [](const AtomInfoColumns& columns, int atm) {
+          return columns.isHydrogen(atm);
+        });
     break;
   case SELE_METz:
     for(a = cNDummyAtoms; a < I->Table.size(); a++) {
@@ -7817,34 +8479,22 @@ static int SelectorSelect0(PyMOLGlobals * G, EvalElem * passed_base)
     }
     break;
   case SELE_FXDz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_fix;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_fix);
     break;
   case SELE_RSTz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_restrain;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_restrain);
     break;
   case SELE_POLz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_polymer;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_polymer);
     break;
   case SELE_PROz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_protein;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_protein);
     break;
   case SELE_NUCz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_nucleic;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_nucleic);
     break;
   case SELE_SOLz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_solvent;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_solvent);
     break;
   case SELE_PTDz:
     for(a = cNDummyAtoms; a < I->Table.size(); a++)
@@ -7855,19 +8505,13 @@ static int SelectorSelect0(PyMOLGlobals * G, EvalElem * passed_base)
       base[0].sele[a] = I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].masked;
     break;
   case SELE_ORGz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_organic;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_organic);
     break;
   case SELE_INOz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_inorganic;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_inorganic);
     break;
   case SELE_GIDz:
-    for(a = cNDummyAtoms; a < I->Table.size(); a++)
-      base[0].sele[a] =
-        I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & cAtomFlag_guide;
+    SelectorSelectByFlags(I, base[0].sele.get(), cAtomFlag_guide);
     break;
 
   case SELE_PREz:
@@ -8237,24 +8881,17 @@ static pymol::Result<> SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int qu
       if(WordMatchComma(G, base[1].text(), rep_names[a].word, ignore_case) < 0)
         rep_mask |= rep_names[a].value;
     }
-    for(SelectorAtomIterator iter(I); iter.next();) {
-      if(iter.getAtomInfo()->visRep & rep_mask) {
-        base[0].sele[iter.a] = true;
-        c++;
-      } else {
-        base[0].sele[iter.a] = false;
-      }
-    }
+    c = SelectorSelectByColumns(I, base[0].sele.get(),
+        [rep_mask](const AtomInfoColumns& columns, int atm) {
+          return (columns.visRep[atm] & rep_mask) != 0;
+        });
     break;
   case SELE_COLs:
     col_idx = ColorGetIndex(G, base[1].text());
-    for(a = cNDummyAtoms; a < I_NAtom; a++) {
-      base[0].sele[a] = false;
-      if(I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].color == col_idx) {
-        base[0].sele[a] = true;
-        c++;
-      }
-    }
+    c = SelectorSelectByColumns(I, base[0].sele.get(),
+        [col_idx](const AtomInfoColumns& columns, int atm) {
+          return columns.color[atm] == col_idx;
+        });
     break;
   case SELE_CCLs:
   case SELE_RCLs:
@@ -8396,13 +9033,10 @@ static pymol::Result<> SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int qu
   case SELE_FLGs:
     sscanf(base[1].text(), "%d", &flag);
     flag = (1 << flag);
-    for(a = cNDummyAtoms; a < I_NAtom; a++) {
-      if(I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom].flags & flag) {
-        base[0].sele[a] = true;
-        c++;
-      } else
-        base[0].sele[a] = false;
-    }
+    c = SelectorSelectByColumns(I, base[0].sele.get(),
+        [flag](const AtomInfoColumns& columns, int atm) {
+          return (columns.flags[atm] & flag) != 0;
+        });
     break;
   case SELE_NTYs:
     {
@@ -8691,6 +9325,87 @@ static pymol::Result<> SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int qu
 }
 
 
+/*========================================================================*/
+/**
+ * True for atom property predicates which only depend on atom identifiers
+ * and atom order, i.e. on nothing which can change without renewing
+ * ObjectMolecule::AtomGeneration.
+ */
+static bool SelectorIsPureProperty(unsigned code)
+{
+  switch (code) {
+  case SELE_PEPs:
+  case SELE_IDXs:
+  case SELE_ID_s:
+  case SELE_RNKs:
+  case SELE_NAMs:
+  case SELE_ELEs:
+  case SELE_CHNs:
+  case SELE_SEGs:
+  case SELE_ALTs:
+  case SELE_RSIs:
+  case SELE_RSNs:
+    return true;
+  }
+  return false;
+}
+
+/**
+ * SelectorSelect1 with results of pure property predicates memoized (as
+ * bitsets) while the table doesn't change.
+ */
+static pymol::Result<> SelectorSelect1Cached(
+    PyMOLGlobals* G, EvalElem* base, int quiet)
+{
+  CSelector* I = G->Selector;
+  auto cache = I->EvalCache.get();
+
+  if (!cache->ResultsValid || !SelectorIsPureProperty(base->code)) {
+    return SelectorSelect1(G, base, quiet);
+  }
+
+  const size_t n_atom = I->Table.size();
+
+  std::string key = std::to_string(base->code);
+  key += SettingGetGlobal_b(G, cSetting_ignore_case) ? 'I' : 'i';
+  key += SettingGetGlobal_b(G, cSetting_ignore_case_chain) ? 'C' : 'c';
+  key += SettingGetGlobal_s(G, cSetting_wildcard);
+  if (base->code == SELE_NAMs) {
+    // global and per-object "atom_name_wildcard", see SelectorSelect1
+    key += '\0';
+    key += SettingGetGlobal_s(G, cSetting_atom_name_wildcard);
+    for (auto obj : I->Obj) {
+      key += '\0';
+      if (obj)
+        key += SettingGet_s(G, obj->Setting, NULL, cSetting_atom_name_wildcard);
+    }
+  }
+  key += '\0';
+  key += base[1].m_text;
+
+  if (auto bits = cache->Results.get(key)) {
+    base->type = STYP_LIST;
+    base->sele_calloc(n_atom);
+    auto sele = base->sele_data();
+    for (size_t a = 0; a < n_atom; ++a) {
+      sele[a] = ((*bits)[a / 64] >> (a % 64)) & 1;
+    }
+    return {};
+  }
+
+  auto res = SelectorSelect1(G, base, quiet);
+  if (res) {
+    std::vector<uint64_t> bits((n_atom + 63) / 64);
+    auto sele = base->sele_data();
+    for (size_t a = 0; a < n_atom; ++a) {
+      if (sele[a])
+        bits[a / 64] |= uint64_t(1) << (a % 64);
+    }
+    cache->Results.put(key, std::move(bits));
+  }
+  return res;
+}
+
 /*========================================================================*/
 static int SelectorSelect2(PyMOLGlobals * G, EvalElem * base, int state)
 {
@@ -9671,7 +10386,7 @@ int SelectorOperator22(PyMOLGlobals * G, EvalElem * base, int state)
   CoordSet *cs;
   int ok = true;
   int nCSet;
-  int n1, at, idx;
+  int at, idx;
   int code = base[1].code;
 
   if(state < 0) {
@@ -9693,36 +10408,14 @@ int SelectorOperator22(PyMOLGlobals * G, EvalElem * base, int state)
       if(dist < 0.0)
         dist = 0.0;
 
-      const size_t table_size = I->Table.size();
-      auto coords_flat = std::vector<float>(table_size * 3);
-      auto* coords = pymol::reshape<3>(coords_flat.data());
-
       /* copy starting mask */
       const auto Flag2 = std::move(base[0].sele);
-      base[0].sele_calloc(table_size);
+      base[0].sele_calloc(I->Table.size());
 
       for(d = 0; d < I->NCSet; d++) {
         if((state < 0) || (d == state)) {
-          n1 = 0;
-          auto Flag1 = std::vector<MapFlag_t>(table_size);
-          for(a = 0; a < table_size; a++) {
-            at = I->Table[a].atom;
-            obj = I->Obj[I->Table[a].model];
-            if(d < obj->NCSet)
-              cs = obj->CSet[d];
-            else
-              cs = NULL;
-            if(cs) {
-              if(CoordSetGetAtomVertex(cs, at, coords[a])) {
-                Flag1[a] = true;
-                n1++;
-              }
-            }
-          }
-          if(n1) {
-            std::unique_ptr<MapType> map(MapNewFlagged(G, -dist,
-                pymol::flatten(coords), table_size, nullptr, Flag1.data()));
-	    CHECKOK(ok, map);
+          auto indices = SelectorGetCoordSetIndices(I, d, dist);
+          if(!indices.empty()) {
             if(ok) {
               nCSet = SelectorGetArrayNCSet(G, base[4].sele, false);
               for(e = 0; ok && e < nCSet; e++) {
@@ -9739,13 +10432,12 @@ int SelectorOperator22(PyMOLGlobals * G, EvalElem * base, int state)
                         idx = cs->atmToIdx(at);
                         if(idx >= 0) {
                           const float* v2 = cs->coordPtr(idx);
-                          for (const auto j : MapEIter(*map, v2, false)) {
+                          SelectorForEachWithin(I, indices, v2, dist, [&](int j) {
                             if (!base[0].sele[j] && Flag2[j] &&
-                                within3f(coords[j], v2, dist) &&
                                 (code != SELE_NTO_ || !base[4].sele[j])) {
                               base[0].sele[j] = true;
                             }
-                          }
+                          });
                         }
                       }
                     }
@@ -9881,18 +10573,12 @@ static std::string indicate_last_token(
 #define return_error_with_tokens(msg)                                          \
   return pymol::make_error(msg, "\n", indicate_last_token(word, c))
 
-#define return_on_error_with_tokens(expr)                                      \
-  {                                                                            \
-    auto _temp_result = (expr);                                                \
-    if (!_temp_result) {                                                       \
-      return_error_with_tokens(_temp_result.error().what());                   \
-    }                                                                          \
-  }
-
 /*========================================================================*/
-pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
-    std::vector<std::string>& word,
-    int state, int quiet)
+/**
+ * Compile a tokenized selection expression (see SelectorParse)
+ */
+pymol::Result<std::shared_ptr<const SelectorPlan>> SelectorCompile(
+    PyMOLGlobals* G, std::vector<std::string>& word)
 {
   int level = 0, imp_op_level = 0;
   int depth = 0;
@@ -9903,6 +10589,7 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
   int opFlag, maxLevel;
   int totDepth = 0;
   int exact = 0;
+  auto plan = std::make_shared<SelectorPlan>();
 
   int ignore_case = SettingGetGlobal_b(G, cSetting_ignore_case);
   /* CFGs can efficiently be parsed by stacks; use a clean stack w/space
@@ -9974,9 +10661,11 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
         }
         PRINTFD(G, FB_Selector)
           " Selector: code %x\n", code ENDFD;
-        if((code > 0) && (!exact))
+        if((code > 0) && (!exact)) {
+          plan->cacheable = false;
           if(SelectorIndexByName(G, word[c].c_str()) >= 0)
             code = 0;           /* favor selections over partial keyword matches */
+        }
         if(code) {
           /* this is a known operation */
           STACK_PUSH_OPERATION(code);
@@ -10099,6 +10788,12 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
   if(level > 0){
     return_error_with_tokens("Malformed selection.");
   }
+
+  /* unevaluated stack, for SelectorExecute */
+  std::vector<EvalElem> plan_stack;
+  for(a = 0; a <= depth; a++)
+    plan_stack.push_back(Stack[a].copyNoSele());
+
   if(ok) {                      /* this is the main operation loop */
     totDepth = depth;
     opFlag = true;
@@ -10129,7 +10824,8 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
             if(depth > 0)
               if((!opFlag) && (Stack[depth].type == STYP_SEL0)) {
                 opFlag = true;
-                ok = SelectorSelect0(G, &Stack[depth]);
+                plan->steps.push_back({SelectorPlan::Select0, depth});
+                Stack[depth].type = STYP_LIST;
               }
           if(ok)
             if(depth > 1)
@@ -10138,8 +10834,8 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                    && (Stack[depth].type == STYP_VALU)) {
                   /* 1 argument selection operator */
                   opFlag = true;
-                  return_on_error_with_tokens(
-                      SelectorSelect1(G, &Stack[depth - 1], quiet));
+                  plan->steps.push_back({SelectorPlan::Select1, depth});
+                  Stack[depth - 1].type = STYP_LIST;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 1] = std::move(Stack[a]);
                   totDepth--;
@@ -10147,7 +10843,8 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                           && (Stack[depth].type == STYP_LIST)) {
                   /* 1 argument logical operator */
                   opFlag = true;
-                  ok = SelectorLogic1(G, &Stack[depth - 1], state);
+                  plan->steps.push_back({SelectorPlan::Logic1, depth});
+                  Stack[depth - 1].type = STYP_LIST;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 1] = std::move(Stack[a]);
                   totDepth--;
@@ -10158,6 +10855,7 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                   /* two adjacent lists at zeroth priority level
                      for the scope (lowest nibble of level is
                      zero) is an implicit OR action */
+                  plan->steps.push_back({SelectorPlan::ImplicitOr, depth});
                   VecCheck(Stack, totDepth + 1);
                   for(a = totDepth; a >= depth; a--)
                     Stack[a + 1] = std::move(Stack[a]);
@@ -10180,7 +10878,7 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                    && (Stack[depth].type == STYP_LIST)
                    && (Stack[depth - 2].type == STYP_LIST)) {
                   /* 2 argument logical operator */
-                  ok = SelectorLogic2(G, &Stack[depth - 2]);
+                  plan->steps.push_back({SelectorPlan::Logic2, depth});
                   opFlag = true;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 2] = std::move(Stack[a]);
@@ -10189,7 +10887,7 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                           && (Stack[depth].type == STYP_PVAL)
                           && (Stack[depth - 2].type == STYP_LIST)) {
                   /* 2 argument logical operator */
-                  ok = SelectorModulate1(G, &Stack[depth - 2], state);
+                  plan->steps.push_back({SelectorPlan::Modulate1, depth});
                   opFlag = true;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 2] = std::move(Stack[a]);
@@ -10205,7 +10903,8 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                    && (Stack[depth - 1].type == STYP_VALU)
                    && (Stack[depth].type == STYP_VALU)) {
                   /* 2 argument value operator */
-                  ok = SelectorSelect2(G, &Stack[depth - 2], state);
+                  plan->steps.push_back({SelectorPlan::Select2, depth});
+                  Stack[depth - 2].type = STYP_LIST;
                   opFlag = true;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 2] = std::move(Stack[a]);
@@ -10223,7 +10922,8 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                    && (Stack[depth - 1].type == STYP_VALU)
                    && (Stack[depth - 2].type == STYP_VALU)) {
                   /* 2 argument logical operator */
-                  ok = SelectorSelect3(G, &Stack[depth-3], state);
+                  plan->steps.push_back({SelectorPlan::Select3, depth});
+                  Stack[depth - 3].type = STYP_LIST;
                   opFlag = true;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 3] = std::move(Stack[a]);
@@ -10243,7 +10943,7 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
                    && (Stack[depth].type == STYP_LIST)
                    && (Stack[depth - 4].type == STYP_LIST)) {
 
-                  ok = SelectorOperator22(G, &Stack[depth - 4], state);
+                  plan->steps.push_back({SelectorPlan::Operator22, depth});
                   opFlag = true;
                   for(a = depth + 1; a <= totDepth; a++)
                     Stack[a - 4] = std::move(Stack[a]);
@@ -10280,7 +10980,92 @@ pymol::Result<sele_array_t> SelectorEvaluate(PyMOLGlobals* G,
     return pymol::Error("Invalid selection.");
   }
 
-  return std::move(Stack[totDepth].sele); /* return the selection list */
+  plan->tokens = std::move(word);
+  plan->stack = std::move(plan_stack);
+  return std::shared_ptr<const SelectorPlan>(std::move(plan));
+}
+
+/**
+ * Evaluate a compiled selection expression on the current table
+ */
+static pymol::Result<sele_array_t> SelectorExecute(
+    PyMOLGlobals* G, const SelectorPlan& plan, int state, int quiet)
+{
+  std::vector<EvalElem> Stack;
+  for (auto& e : plan.stack)
+    Stack.push_back(e.copyNoSele());
+
+  int totDepth = Stack.size() - 1;
+  int ok = true;
+  int a;
+
+  auto error_with_tokens = [&plan](const std::string& msg) {
+    return pymol::make_error(
+        msg, "\n", indicate_last_token(plan.tokens, plan.tokens.size()));
+  };
+
+  // remove `n` elements left of `depth` + 1
+  auto collapse = [&](int depth, int n) {
+    for(a = depth + 1; a <= totDepth; a++)
+      Stack[a - n] = std::move(Stack[a]);
+    totDepth -= n;
+  };
+
+  for (auto& step : plan.steps) {
+    int depth = step.depth;
+    switch (step.type) {
+    case SelectorPlan::Select0:
+      ok = SelectorSelect0(G, &Stack[depth]);
+      break;
+    case SelectorPlan::Select1:
+      {
+        auto res = SelectorSelect1Cached(G, &Stack[depth - 1], quiet);
+        if (!res)
+          return error_with_tokens(res.error().what());
+      }
+      collapse(depth, 1);
+      break;
+    case SelectorPlan::Logic1:
+      ok = SelectorLogic1(G, &Stack[depth - 1], state);
+      collapse(depth, 1);
+      break;
+    case SelectorPlan::ImplicitOr:
+      VecCheck(Stack, totDepth + 1);
+      for(a = totDepth; a >= depth; a--)
+        Stack[a + 1] = std::move(Stack[a]);
+      totDepth++;
+      Stack[depth].type = STYP_OPR2;
+      Stack[depth].code = SELE_IOR2;
+      Stack[depth].m_text.clear();
+      break;
+    case SelectorPlan::Logic2:
+      ok = SelectorLogic2(G, &Stack[depth - 2]);
+      collapse(depth, 2);
+      break;
+    case SelectorPlan::Modulate1:
+      ok = SelectorModulate1(G, &Stack[depth - 2], state);
+      collapse(depth, 2);
+      break;
+    case SelectorPlan::Select2:
+      ok = SelectorSelect2(G, &Stack[depth - 2], state);
+      collapse(depth, 2);
+      break;
+    case SelectorPlan::Select3:
+      ok = SelectorSelect3(G, &Stack[depth - 3], state);
+      collapse(depth, 3);
+      break;
+    case SelectorPlan::Operator22:
+      ok = SelectorOperator22(G, &Stack[depth - 4], state);
+      collapse(depth, 4);
+      break;
+    }
+    if (!ok) {
+      return pymol::Error(
+          indicate_last_token(plan.tokens, plan.tokens.size()));
+    }
+  }
+
+  return std::move(Stack[1].sele); /* return the selection list */
 }
 
 
@@ -10425,6 +11210,7 @@ void SelectorReinit(PyMOLGlobals * G)
 CSelector::CSelector(PyMOLGlobals* G, CSelectorManager* mgr)
     : G(G)
     , mgr(mgr)
+    , EvalCache(pymol::make_unique<SelectorEvalCache>())
 {
 }
 
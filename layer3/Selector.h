@@ -83,6 +83,9 @@ pymol::Result<int> SelectorGetTmpResult(PyMOLGlobals * G, const char *input, cha
 
 pymol::Result<> SelectorLoadCoords(PyMOLGlobals * G, PyObject * coords, int sele, int state);
 PyObject *SelectorGetCoordsAsNumPy(PyMOLGlobals * G, int sele, int state);
+pymol::Result<PyObject*> SelectorGetAtomColumnAsNumPy(PyMOLGlobals * G, int sele, const char * name);
+pymol::Result<> SelectorLoadAtomColumn(PyMOLGlobals * G, PyObject * values,
+    PyObject * table, int sele, const char * name);
 float SelectorSumVDWOverlap(PyMOLGlobals * G, int sele1, int state1,
                             int sele2, int state2, float adjust);
 int SelectorVdwFit(PyMOLGlobals * G, int sele1, int state1, int sele2, int state2,
@@ -54,6 +54,8 @@ struct CSelectorManager
   CSelectorManager();
 };
 
+struct SelectorEvalCache;
+
 struct CSelector {
   PyMOLGlobals* G = nullptr;
   CSelectorManager* mgr = nullptr;
@@ -63,6 +65,14 @@ struct CSelector {
   pymol::copyable_ptr<ObjectMolecule> Center;
   int NCSet = 0; // Seems to hold the largest NCSet in Obj
   bool SeleBaseOffsetsValid = false;
+  std::unique_ptr<SelectorEvalCache> EvalCache; // compiled expressions etc.
+
+  /* The table of all atoms in all states is maintained incrementally. While
+   * Table/Obj hold a different table, it is stashed in FullTable/FullObj. */
+  bool TableIsFull = false;
+  std::vector<TableRec> FullTable;
+  std::vector<ObjectMolecule*> FullObj;
+  std::vector<int> FullNAtom; // per model, atom count when its segment was built
   CSelector(PyMOLGlobals* G, CSelectorManager* mgr);
   CSelector(CSelector&&) = default;
   CSelector& operator=(CSelector&&) = default;
@@ -44,6 +44,7 @@ Z* -------------------------------------------------------------------
 #ifndef _PYMOL_NOPY
 #define PY_SSIZE_T_CLEAN
 #include"os_python.h"
+#include"os_numpy.h"
 #include"PyMOLGlobals.h"
 #include"PyMOLOptions.h"
 #include"os_predef.h"
@@ -454,91 +455,6 @@ static PyObject *CmdFixChemistry(PyObject * self, PyObject * args)
   return APIResult(G, result);
 }
 
-static PyObject *CmdRayAntiThread(PyObject * self, PyObject * args)
-{
-  PyMOLGlobals *G = NULL;
-  PyObject *py_thread_info;
-  API_SETUP_ARGS(G, self, args, "OO", &self, &py_thread_info);
-
-  auto thread_info = reinterpret_cast<CRayAntiThreadInfo*>(
-      PyCapsule_GetPointer(py_thread_info, nullptr));
-  API_ASSERT(thread_info);
-
-  PUnblock(G);
-  RayAntiThread(thread_info);
-  PBlock(G);
-
-  return APISuccess();
-}
-
-static PyObject *CmdRayHashThread(PyObject * self, PyObject * args)
-{
-  PyMOLGlobals *G = NULL;
-  PyObject *py_thread_info;
-  API_SETUP_ARGS(G, self, args, "OO", &self, &py_thread_info);
-
-  auto thread_info = reinterpret_cast<CRayHashThreadInfo*>(
-      PyCapsule_GetPointer(py_thread_info, nullptr));
-  API_ASSERT(thread_info);
-
-  PUnblock(G);
-  RayHashThread(thread_info);
-  PBlock(G);
-
-  return APISuccess();
-}
-
-static PyObject *CmdRayTraceThread(PyObject * self, PyObject * args)
-{
-  PyMOLGlobals *G = NULL;
-  PyObject *py_thread_info;
-  API_SETUP_ARGS(G, self, args, "OO", &self, &py_thread_info);
-
-  auto thread_info = reinterpret_cast<CRayThreadInfo*>(
-      PyCapsule_GetPointer(py_thread_info, nullptr));
-  API_ASSERT(thread_info);
-
-  PUnblock(G);
-  RayTraceThread(thread_info);
-  PBlock(G);
-
-  return APISuccess();
-}
-
-static PyObject *CmdCoordSetUpdateThread(PyObject * self, PyObject * args)
-{
-  PyMOLGlobals *G = NULL;
-  PyObject *py_thread_info;
-  API_SETUP_ARGS(G, self, args, "OO", &self, &py_thread_info);
-
-  auto thread_info = reinterpret_cast<CCoordSetUpdateThreadInfo*>(
-      PyCapsule_GetPointer(py_thread_info, nullptr));
-  API_ASSERT(thread_info);
-
-  PUnblock(G);
-  CoordSetUpdateThread(thread_info);
-  PBlock(G);
-
-  return APISuccess();
-}
-
-static PyObject *CmdObjectUpdateThread(PyObject * self, PyObject * args)
-{
-  PyMOLGlobals *G = NULL;
-  PyObject *py_thread_info;
-  API_SETUP_ARGS(G, self, args, "OO", &self, &py_thread_info);
-
-  auto thread_info = reinterpret_cast<CObjectUpdateThreadInfo*>(
-      PyCapsule_GetPointer(py_thread_info, nullptr));
-  API_ASSERT(thread_info);
-
-  PUnblock(G);
-  SceneObjectUpdateThread(thread_info);
-  PBlock(G);
-
-  return APISuccess();
-}
-
 static PyObject *CmdGetMovieLocked(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -1978,6 +1894,29 @@ static PyObject *CmdGetCoordsAsNumPy(PyObject * self, PyObject * args)
   return (APIAutoNone(result));
 }
 
+static PyObject *CmdGetAtomColumn(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  const char *sele, *name;
+
+  API_SETUP_ARGS(G, self, args, "Oss", &self, &sele, &name);
+  APIEnterBlocked(G);
+
+  auto result = [&]() -> pymol::Result<PyObject*> {
+    auto tmpsele = SelectorTmp::make(G, sele, false);
+    p_return_if_error(tmpsele);
+    return SelectorGetAtomColumnAsNumPy(G, tmpsele->getIndex(), name);
+  }();
+
+  APIExitBlocked(G);
+
+  if (!result && PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  return APIResult(G, result);
+}
+
 static PyObject *CmdGetCoordSetAsNumPy(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -2180,6 +2119,38 @@ static PyObject *CmdGetArea(PyObject * self, PyObject * args)
   return APIResult(G, res);
 }
 
+/*
+ * Per-atom surface areas as a (n_state, n_atom) numpy array (nested lists
+ * without numpy support)
+ */
+static PyObject *CmdGetAtomAreas(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  const char *sele;
+  int state;
+  API_SETUP_ARGS(G, self, args, "Osi", &self, &sele, &state);
+  APIEnter(G);
+  auto res = ExecutiveGetAtomAreas(G, sele, state);
+  APIExit(G);
+#ifdef _PYMOL_NUMPY
+  if (res) {
+    import_array1(nullptr);
+    auto const& areas = res.result();
+    npy_intp dims[2] = {npy_intp(areas.size()),
+                        npy_intp(areas.empty() ? 0 : areas[0].size())};
+    auto array = PyArray_SimpleNew(2, dims, NPY_FLOAT32);
+    if (!array)
+      return nullptr;
+    auto data = (float*) PyArray_DATA((PyArrayObject*) array);
+    for (auto const& state_areas : areas) {
+      data = std::copy(state_areas.begin(), state_areas.end(), data);
+    }
+    return array;
+  }
+#endif
+  return APIResult(G, res);
+}
+
 static PyObject *CmdPushUndo(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -5545,6 +5516,30 @@ static PyObject *CmdLoadCoords(PyObject * self, PyObject * args)
   return APIResult(G, result);
 }
 
+static PyObject *CmdSetAtomColumn(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  const char *sele, *name;
+  PyObject *values, *table = Py_None;
+
+  API_SETUP_ARGS(G, self, args, "OssO|O", &self, &sele, &name, &values, &table);
+  API_ASSERT(APIEnterBlockedNotModal(G));
+
+  auto result = [&]() -> pymol::Result<> {
+    auto tmpsele = SelectorTmp::make(G, sele, false);
+    p_return_if_error(tmpsele);
+    return SelectorLoadAtomColumn(G, values, table, tmpsele->getIndex(), name);
+  }();
+
+  APIExitBlocked(G);
+
+  if (!result && PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  return APIResult(G, result);
+}
+
 static PyObject *CmdLoadCoordSet(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -6412,7 +6407,6 @@ static PyMethodDef Cmd_methods[] = {
   {"color", CmdColor, METH_VARARGS},
   {"colordef", CmdColorDef, METH_VARARGS},
   {"combine_object_ttt", CmdCombineObjectTTT, METH_VARARGS},
-  {"coordset_update_thread", CmdCoordSetUpdateThread, METH_VARARGS},
   {"copy", CmdCopy, METH_VARARGS},
   {"create", CmdCreate, METH_VARARGS},
   {"count_states", CmdCountStates, METH_VARARGS},
@@ -6458,6 +6452,8 @@ static PyMethodDef Cmd_methods[] = {
   {"get_collada", CmdGetCOLLADA, METH_VARARGS},
   {"get_color", CmdGetColor, METH_VARARGS},
   {"get_colorection", CmdGetColorection, METH_VARARGS},
+  {"get_atom_areas", CmdGetAtomAreas, METH_VARARGS},
+  {"get_atom_column", CmdGetAtomColumn, METH_VARARGS},
   {"get_coords", CmdGetCoordsAsNumPy, METH_VARARGS},
   {"get_coordset", CmdGetCoordSetAsNumPy, METH_VARARGS},
   {"get_distance", CmdGetDistance, METH_VARARGS},
@@ -6559,7 +6555,6 @@ static PyMethodDef Cmd_methods[] = {
   {"mpng_", CmdMPNG, METH_VARARGS},
   {"mmatrix", CmdMMatrix, METH_VARARGS},
   {"mview", CmdMView, METH_VARARGS},
-  {"object_update_thread", CmdObjectUpdateThread, METH_VARARGS},
   {"origin", CmdOrigin, METH_VARARGS},
   {"orient", CmdOrient, METH_VARARGS},
   {"onoff", CmdOnOff, METH_VARARGS},
@@ -6574,9 +6569,6 @@ static PyMethodDef Cmd_methods[] = {
   {"pseudoatom", CmdPseudoatom, METH_VARARGS},
   {"push_undo", CmdPushUndo, METH_VARARGS},
   {"quit", CmdQuit, METH_VARARGS},
-  {"ray_trace_thread", CmdRayTraceThread, METH_VARARGS},
-  {"ray_hash_thread", CmdRayHashThread, METH_VARARGS},
-  {"ray_anti_thread", CmdRayAntiThread, METH_VARARGS},
   {"ramp_new", CmdRampNew, METH_VARARGS},
   {"ready", CmdReady, METH_VARARGS},
   {"rebuild", CmdRebuild, METH_VARARGS},
@@ -6601,6 +6593,7 @@ static PyMethodDef Cmd_methods[] = {
   {"select", CmdSelect, METH_VARARGS},
   {"select_list", CmdSelectList, METH_VARARGS},
   {"set", CmdSet, METH_VARARGS},
+  {"set_atom_column", CmdSetAtomColumn, METH_VARARGS},
   {"set_bond", CmdSetBond, METH_VARARGS},
   {"get_bond", CmdGetBond, METH_VARARGS},
   {"scene", CmdScene, METH_VARARGS},
@@ -76,6 +76,7 @@
 #include "pymol/zstring_view.h"
 
 #include "ShaderMgr.h"
+#include "ThreadPool.h"
 #include "Version.h"
 
 #ifndef _PYMOL_NOPY
@@ -113,6 +114,7 @@ typedef struct _CPyMOL {
   int ClickedBondIndex;
   float ClickedPos[3];
   int ImageRequestedFlag, ImageReadyFlag;
+  int ImagePreview;
   int DraggedFlag;
   int Reshape[PYMOL_RESHAPE_SIZE];
   int Progress[PYMOL_PROGRESS_SIZE];
@@ -1925,6 +1927,7 @@ void PyMOL_Start(CPyMOL * I)
 #include "lex_constants.h"
 
   G->Feedback = new CFeedback(G, G->Option->quiet);
+  G->ThreadPool = new pymol::ThreadPool();
   WordInit(G);
   UtilInit(G);
   ColorInit(G);
@@ -2038,6 +2041,7 @@ void PyMOL_Stop(CPyMOL * I)
   ColorFree(G);
   UtilFree(G);
   WordFree(G);
+  DeleteP(G->ThreadPool);
   DeleteP(G->Feedback);
 
   PyMOL_PurgeAPI(I);
@@ -2870,6 +2874,26 @@ void PyMOL_SetInterrupt(CPyMOL * I, int value)
   }
 }
 
+int PyMOL_GetImagePreview(CPyMOL * I, int reset)
+{                               /* lock intentionally omitted */
+  int result = I->ImagePreview;
+  if(reset)
+    I->ImagePreview = 0;
+  return result;
+}
+
+void PyMOL_SetImagePreview(CPyMOL * I, int value)
+{                               /* lock intentionally omitted */
+  I->ImagePreview = value;
+}
+
+int PyMOL_GetImagePreviewData(CPyMOL * I, int width, int height,
+                              int row_bytes, void *buffer, int mode)
+{                               /* lock intentionally omitted */
+  return get_status_ok(SceneCopyRayImageExternal(I->G, width, height,
+      row_bytes, (unsigned char *) buffer, mode));
+}
+
 void PyMOL_Drag(CPyMOL * I, int x, int y, int modifiers)
 {
   PYMOL_API_LOCK OrthoDrag(I->G, x, y, modifiers);
@@ -324,6 +324,20 @@ int PyMOL_GetProgressChanged(CPyMOL * I, int reset);
 int PyMOL_GetInterrupt(CPyMOL * I, int reset);
 void PyMOL_SetInterrupt(CPyMOL * I, int value);
 
+/* progressive ray tracing (ray_progressive): number of the preview pass
+   currently held as the scene image, 0 once the final image is in */
+
+int PyMOL_GetImagePreview(CPyMOL * I, int reset);
+void PyMOL_SetImagePreview(CPyMOL * I, int value);
+
+/* copy the ray traced image, or its latest preview while ray tracing is in
+   progress, like PyMOL_GetImageData. Doesn't take the API lock (which the
+   ray command holds until the final image is in), so it may be called from
+   any thread. Fails if there is no ray traced image of that size. */
+
+int PyMOL_GetImagePreviewData(CPyMOL * I, int width, int height,
+                              int row_bytes, void *buffer, int mode);
+
 
 /* modal updates -- PyMOL is busy with some complex task, but we have
    to return control to the host in order to get a valid draw callback */
@@ -11,16 +11,29 @@
 #include <catch2/catch.hpp>
 #include "Test.h"
 #include "TestCmdTest2.h"
+#include "Executive.h"
+#include "ObjectMolecule.h"
+#include "P.h"
 
 using PyMOL_TestAPI = pymol::test::PYMOL_TEST_API;
 
 PyObject *PyMOL_TestAPI::PYMOL_TEST_SUCCESS = PConvAutoNone(Py_None);
 PyObject *PyMOL_TestAPI::PYMOL_TEST_FAILURE = Py_BuildValue("i", -1);
 
-PyObject *CmdTest2(PyObject *, PyObject *) {
+PyObject *CmdTest2(PyObject *, PyObject *args) {
   int argc = 1;
   char argv0[] = "pymol";
-  char *argv[] = {argv0};
+  char *argv[] = {argv0, nullptr};
+
+  // optional test spec, e.g. "[benchmark]" for the hidden benchmarks
+  for (Py_ssize_t i = 0; args && i < PyTuple_Size(args); ++i) {
+    PyObject *item = PyTuple_GetItem(args, i);
+    if (PyUnicode_Check(item)) {
+      argv[argc++] = const_cast<char *>(PyUnicode_AsUTF8(item));
+      break;
+    }
+  }
+
   auto result = Catch::Session().run(argc, argv);
   if (!result) {
     return PyMOL_TestAPI::PYMOL_TEST_SUCCESS;
@@ -54,5 +67,33 @@ TmpFILE::TmpFILE()
 #endif
 }
 
+PyMOLSession::PyMOLSession() : m_G(SingletonPyMOLGlobals)
+{
+  REQUIRE(m_G);
+  // like the API commands, run without the GIL (worker threads may need it)
+  PUnblock(m_G);
+  ExecutiveDelete(m_G, "all");
+}
+
+PyMOLSession::~PyMOLSession()
+{
+  ExecutiveDelete(m_G, "all");
+  PBlock(m_G);
+}
+
+ObjectMolecule* PyMOLSession::loadPDB(const char* name, const char* pdb)
+{
+  REQUIRE(ExecutiveLoad(m_G, nullptr, pdb, strlen(pdb), cLoadTypePDBStr, name,
+      0, 0, 0, 1, 0, 1, nullptr));
+  auto obj = ExecutiveFindObjectMoleculeByName(m_G, name);
+  REQUIRE(obj);
+  return obj;
+}
+
+const char* const TwoWatersPDB =
+    "HETATM    1  O   HOH A   1       0.000   0.000   0.000  1.00  0.00           O\n"
+    "HETATM    2  O   HOH A   2       3.000   0.000   0.000  1.00  0.00           O\n"
+    "END\n";
+
 } // namespace test
 } // namespace pymol
@@ -8,11 +8,14 @@
 #include <string>
 #include <cmath>
 #include "os_python.h"
+#include "PyMOLGlobals.h"
 #include "PConv.h"
 #include "pymol/type_traits.h"
 #include "pymol/algorithm.h"
 #include <catch2/catch.hpp>
 
+struct ObjectMolecule;
+
 namespace pymol {
 namespace test {
 
@@ -82,6 +85,31 @@ public:
   const std::string& getFilenameStr() const { return tmpFilename; }
 };
 
+/**
+ * Access to the running (singleton) PyMOL instance for tests which need
+ * objects, selections or rendering. Releases the GIL while in scope and
+ * deletes all objects when done.
+ */
+class PyMOLSession
+{
+  PyMOLGlobals* m_G;
+public:
+  PyMOLSession();
+  PyMOLSession(const PyMOLSession&) = delete;
+  PyMOLSession& operator=(const PyMOLSession&) = delete;
+  ~PyMOLSession();
+  CPyMOL* get() const { return m_G->PyMOL; }
+  PyMOLGlobals* G() const { return m_G; }
+
+  /**
+   * Load PDB file contents as molecular object `name`
+   */
+  ObjectMolecule* loadPDB(const char* name, const char* pdb);
+};
+
+/// Two water oxygens, 3 Angstrom apart
+extern const char* const TwoWatersPDB;
+
 }; // namespace test
 }; // namespace pymol
 
@@ -0,0 +1,126 @@
+#include "Test.h"
+
+#include "CoordSet.h"
+#include "Executive.h"
+#include "ObjectMolecule.h"
+#include "P.h"
+#include "Setting.h"
+
+using namespace pymol::test;
+
+/*
+ * Two chains with one atom each. Assembly 1 shows chain A with operators
+ * 1, 2 and 3, and chain B once with the product of operators 2 and 3.
+ */
+static const char* AssemblyCIF = R"(data_test
+_pdbx_struct_assembly.id 1
+_pdbx_struct_assembly.oligomeric_count 4
+loop_
+_pdbx_struct_assembly_gen.assembly_id
+_pdbx_struct_assembly_gen.oper_expression
+_pdbx_struct_assembly_gen.asym_id_list
+1 (1-3) A
+1 (2)(3) B
+loop_
+_pdbx_struct_oper_list.id
+_pdbx_struct_oper_list.matrix[1][1]
+_pdbx_struct_oper_list.matrix[1][2]
+_pdbx_struct_oper_list.matrix[1][3]
+_pdbx_struct_oper_list.vector[1]
+_pdbx_struct_oper_list.matrix[2][1]
+_pdbx_struct_oper_list.matrix[2][2]
+_pdbx_struct_oper_list.matrix[2][3]
+_pdbx_struct_oper_list.vector[2]
+_pdbx_struct_oper_list.matrix[3][1]
+_pdbx_struct_oper_list.matrix[3][2]
+_pdbx_struct_oper_list.matrix[3][3]
+_pdbx_struct_oper_list.vector[3]
+1 1 0 0 0 0 1 0 0 0 0 1 0
+2 1 0 0 10 0 1 0 0 0 0 1 0
+3 0 -1 0 0 1 0 0 20 0 0 1 -5
+loop_
+_atom_site.group_PDB
+_atom_site.id
+_atom_site.type_symbol
+_atom_site.label_atom_id
+_atom_site.label_comp_id
+_atom_site.label_asym_id
+_atom_site.auth_asym_id
+_atom_site.label_seq_id
+_atom_site.auth_seq_id
+_atom_site.Cartn_x
+_atom_site.Cartn_y
+_atom_site.Cartn_z
+HETATM 1 O O HOH A A . 1 1.0 2.0 3.0
+HETATM 2 O O HOH B B . 2 -4.0 0.5 1.0
+)";
+
+static ObjectMolecule* LoadAssembly(
+    PyMOLGlobals* G, const char* name, bool instanced)
+{
+  SettingSetGlobal_s(G, cSetting_assembly, "1");
+  SettingSetGlobal_b(G, cSetting_assembly_instanced, instanced);
+  REQUIRE(ExecutiveLoad(G, nullptr, AssemblyCIF, strlen(AssemblyCIF),
+      cLoadTypeCIFStr, name, 0, 0, 0, 1, 0, 1, nullptr));
+  auto obj = ExecutiveFindObjectMoleculeByName(G, name);
+  REQUIRE(obj);
+  return obj;
+}
+
+TEST_CASE("Instanced assembly matches the materialized assembly", "[Assembly]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  auto copies = LoadAssembly(G, "copies", false);
+  auto instanced = LoadAssembly(G, "instanced", true);
+  SettingSetGlobal_s(G, cSetting_assembly, "");
+  SettingSetGlobal_b(G, cSetting_assembly_instanced, false);
+
+  // one coordinate set per operator, or one per assembly_gen row
+  REQUIRE(copies->NCSet == 4);
+  REQUIRE(instanced->NCSet == 2);
+  for (int state = 0; state < copies->NCSet; ++state) {
+    REQUIRE(copies->CSet[state]->Instances.empty());
+  }
+  REQUIRE(instanced->CSet[0]->Instances.size() == 3);
+  REQUIRE(instanced->CSet[1]->Instances.size() == 1);
+  REQUIRE(instanced->CSet[0]->NIndex == 1);
+  REQUIRE(instanced->CSet[1]->NIndex == 1);
+
+  // chain B: operator 3 applied after operator 2
+  float buf[3];
+  auto v = instanced->CSet[1]->instanceCoordPtr(0, 0, buf);
+  REQUIRE(isAlmostEqual(v[0], 9.5F));
+  REQUIRE(isAlmostEqual(v[1], 16.F));
+  REQUIRE(isAlmostEqual(v[2], -4.F));
+
+  float mn1[3], mx1[3], mn2[3], mx2[3];
+  REQUIRE(ExecutiveGetExtent(G, "copies", mn1, mx1, true, -1, false));
+  REQUIRE(ExecutiveGetExtent(G, "instanced", mn2, mx2, true, -1, false));
+  for (int i = 0; i < 3; ++i) {
+    REQUIRE(isAlmostEqual(mn1[i], mn2[i], 1e-4F));
+    REQUIRE(isAlmostEqual(mx1[i], mx2[i], 1e-4F));
+  }
+  REQUIRE(isAlmostEqual(mn2[0], -2.F));
+  REQUIRE(isAlmostEqual(mx2[0], 11.F));
+
+  SECTION("session round trip")
+  {
+    ObjectMolecule* restored = nullptr;
+    PBlock(G);
+    PyObject* list = ObjectMoleculeAsPyList(instanced);
+    int ok = list && ObjectMoleculeNewFromPyList(G, list, &restored);
+    Py_XDECREF(list);
+    PUnblock(G);
+
+    REQUIRE(ok);
+    REQUIRE(restored);
+    REQUIRE(restored->NCSet == instanced->NCSet);
+    for (int state = 0; state < instanced->NCSet; ++state) {
+      REQUIRE(restored->CSet[state]->Instances ==
+              instanced->CSet[state]->Instances);
+    }
+    DeleteP(restored);
+  }
+}
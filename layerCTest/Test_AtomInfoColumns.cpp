@@ -0,0 +1,97 @@
+#include "Test.h"
+
+#include "Color.h"
+#include "Executive.h"
+#include "MovieScene.h"
+#include "ObjectMolecule.h"
+#include "Rep.h"
+
+using namespace pymol::test;
+
+static const char* GlycinePDB =
+    "ATOM      1  N   GLY A   1       0.000   0.000   0.000  1.00  0.00           N\n"
+    "ATOM      2  CA  GLY A   1       1.450   0.000   0.000  1.00  0.00           C\n"
+    "END\n";
+
+/*
+ * Columns of `obj` after refreshing, checked against the atom records
+ */
+static const AtomInfoColumns& RequireColumnsMatch(ObjectMolecule* obj)
+{
+  const auto& columns = obj->getAtomColumns();
+  REQUIRE(columns.size() == size_t(obj->NAtom));
+  for (int a = 0; a < obj->NAtom; ++a) {
+    const auto& ai = obj->AtomInfo[a];
+    REQUIRE(columns.visRep[a] == ai.visRep);
+    REQUIRE(columns.color[a] == ai.color);
+    REQUIRE(columns.flags[a] == ai.flags);
+    REQUIRE(columns.protons[a] == ai.protons);
+  }
+  return columns;
+}
+
+TEST_CASE("Atom columns follow color, rep and flag changes", "[AtomInfoColumns]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  auto obj = pymol.loadPDB("m1", GlycinePDB);
+
+  // valid columns before each change
+  RequireColumnsMatch(obj);
+  REQUIRE(obj->AtomColumns.valid);
+
+  SECTION("color")
+  {
+    const int red = ColorGetIndex(G, "red");
+    REQUIRE(ExecutiveColor(G, "m1", "red", 0, 1));
+    REQUIRE(RequireColumnsMatch(obj).color[0] == red);
+  }
+
+  SECTION("spectrum")
+  {
+    // rainbow palette
+    REQUIRE(ExecutiveSpectrum(
+        G, "m1", "count", 0.F, -1.F, 107, 893, "o", 3, 0, 1));
+    auto& columns = RequireColumnsMatch(obj);
+    REQUIRE(columns.color[0] != columns.color[1]);
+  }
+
+  SECTION("representations")
+  {
+    REQUIRE(ExecutiveSetRepVisMask(G, "m1", cRepSphereBit, cVis_AS));
+    REQUIRE(RequireColumnsMatch(obj).visRep[0] == cRepSphereBit);
+  }
+
+  SECTION("flags")
+  {
+    REQUIRE(ExecutiveFlag(G, 3, "m1", 1, 1));
+    REQUIRE(RequireColumnsMatch(obj).flags[0] & (1u << 3));
+    REQUIRE(ExecutiveFlag(G, 3, "m1", 2, 1));
+    REQUIRE(!(RequireColumnsMatch(obj).flags[0] & (1u << 3)));
+  }
+
+  SECTION("direct edit with invalidation")
+  {
+    obj->AtomInfo[1].color = ColorGetIndex(G, "green");
+    obj->AtomInfo[1].visRep = cRepLineBit;
+    obj->AtomInfo[1].flags |= 1u << 4;
+    obj->invalidate(cRepAll, cRepInvColor, -1);
+    auto& columns = RequireColumnsMatch(obj);
+    REQUIRE(columns.visRep[1] == cRepLineBit);
+    REQUIRE(columns.flags[1] & (1u << 4));
+  }
+
+  SECTION("scene recall")
+  {
+    REQUIRE(MovieSceneFunc(G, "s1", "store"));
+    REQUIRE(ExecutiveColor(G, "m1", "red", 0, 1));
+    REQUIRE(ExecutiveSetRepVisMask(G, "m1", cRepSphereBit, cVis_AS));
+    RequireColumnsMatch(obj);
+
+    REQUIRE(MovieSceneRecall(G, "s1", 0.F));
+    auto& columns = RequireColumnsMatch(obj);
+    REQUIRE(columns.visRep[0] != cRepSphereBit);
+    REQUIRE(columns.color[0] != ColorGetIndex(G, "red"));
+  }
+}
@@ -1,6 +1,14 @@
 #include "Test.h"
 
 #include "CifFile.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace pymol::test;
 
@@ -148,4 +156,215 @@ TEST_CASE("misc", "[CifFile]")
   REQUIRE(blocks[2].get_opt("_typed_float3")->as<double>() == Approx(1.23456789));
 }
 
+TEST_CASE("to_array", "[CifFile]")
+{
+  pymol::cif_file cf(nullptr, R"""(
+data_num
+loop_
+_n.i
+_n.d
+1 0.5
+-23 -1.25e2
++7 1.23(45)e1
+12A 3.
+? .
+0042 .5E+1
+1234567890 1.00000000000000000001
+)""");
+
+  auto& data = cf.datablocks()[0];
+  auto* arr_i = data.get_opt("_n.i");
+  auto* arr_d = data.get_opt("_n.d");
+  unsigned n = arr_i->size() + 2;
+
+  std::vector<int> ints(n);
+  std::vector<double> doubles(n);
+  std::vector<float> floats(n);
+
+  arr_i->to_array(ints.data(), n, -1);
+  arr_d->to_array(doubles.data(), n, 99.);
+  arr_d->to_array(floats.data(), n, 99.f);
+
+  // same as element-wise conversion, including defaults past the end
+  for (unsigned i = 0; i < n; ++i) {
+    REQUIRE(ints[i] == arr_i->as_i(i, -1));
+    REQUIRE(doubles[i] == arr_d->as_d(i, 99.));
+    REQUIRE(floats[i] == arr_d->as<float>(i, 99.f));
+  }
+
+  REQUIRE(ints == std::vector<int>{1, -23, 7, 12, -1, 42, 1234567890, -1, -1});
+  REQUIRE(doubles[1] == -125.);
+  REQUIRE(doubles[2] == Approx(12.3));
+  REQUIRE(doubles[5] == 5.);
+
+  // single (non-looped) value
+  int single[3];
+  data.get_opt("_missing.key")->to_array(single, 3, 5);
+  REQUIRE(single[0] == 5);
+  REQUIRE(single[2] == 5);
+}
+
+TEST_CASE("decimal fast path matches atof", "[CifFile]")
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> dist(-1e4, 1e4);
+  std::string contents = "data_num\nloop_\n_n.d\n";
+  std::vector<std::string> values;
+
+  const char* formats[] = {"%.3f", "%.6g", "%.15g", "%.4e", "%.12E"};
+  char buf[64];
+  for (int i = 0; i < 5000; ++i) {
+    snprintf(buf, sizeof(buf), formats[i % 5], dist(rng));
+    values.push_back(buf);
+    contents.append(buf).append("\n");
+  }
+
+  pymol::cif_file cf(nullptr, contents.c_str());
+  auto* arr = cf.datablocks()[0].get_opt("_n.d");
+  REQUIRE(arr->size() == values.size());
+
+  std::vector<double> doubles(values.size());
+  arr->to_array(doubles.data(), values.size());
+
+  std::vector<double> expected;
+  for (auto& value : values) {
+    expected.push_back(atof(value.c_str()));
+  }
+
+  REQUIRE(doubles == expected);
+}
+
+/**
+ * Parse `contents` serially and in parallel and compare all data items
+ */
+static void check_parallel_tokenizer(const std::string& contents)
+{
+  pymol::ThreadPool pool;
+  pymol::cif_file cf_serial(nullptr, contents.c_str());
+  pymol::cif_file cf_parallel(nullptr, contents.c_str(), &pool, 4);
+
+  auto& blocks1 = cf_serial.datablocks();
+  auto& blocks2 = cf_parallel.datablocks();
+  REQUIRE(blocks1.size() == blocks2.size());
+
+  const char* keys[] = {"_atom_site.id", "_atom_site.label_atom_id",
+      "_atom_site.cartn_x", "_atom_site.pdbx_formal_charge", "_text.id",
+      "_text.value", "_text.after", "_tail.key"};
+
+  for (std::size_t b = 0; b < blocks1.size(); ++b) {
+    REQUIRE(blocks1[b].code() == std::string(blocks2[b].code()));
+    for (auto key : keys) {
+      auto values1 = blocks1[b].get_opt(key)->to_vector<std::string>("?");
+      auto values2 = blocks2[b].get_opt(key)->to_vector<std::string>("?");
+      REQUIRE(values1 == values2);
+    }
+  }
+}
+
+TEST_CASE("parallel tokenizer", "[CifFile]")
+{
+  std::string atom_site = "data_big\n"
+                          "loop_\n"
+                          "_atom_site.id\n"
+                          "_atom_site.label_atom_id\n"
+                          "_atom_site.Cartn_x\n"
+                          "_atom_site.pdbx_formal_charge\n";
+
+  for (int i = 0; i < 60000; ++i) {
+    atom_site.append(std::to_string(i + 1))
+        .append(i % 7 ? " CA " : " \"O5' x\" ")
+        .append(std::to_string(i * 0.125))
+        .append(i % 5 ? " ?" : " 1")
+        .append(i % 11 ? "\n" : " # comment\n");
+  }
+
+  // text fields which span chunk boundaries
+  std::string text = "loop_\n_text.id\n_text.value\n_text.after\n";
+  std::string lines;
+  for (int j = 0; j < 2000; ++j) {
+    lines.append("line ").append(std::to_string(j)).append(" 'x' #no\n");
+  }
+  for (int i = 0; i < 30; ++i) {
+    text.append(std::to_string(i)).append("\n;").append(lines).append(";x\n");
+  }
+  text.append("_tail.key 'quoted value'\n");
+
+  SECTION("loop") {
+    std::string contents;
+    while (contents.size() < (8 << 20)) {
+      contents.append(atom_site);
+    }
+    check_parallel_tokenizer(contents);
+  }
+
+  SECTION("text fields") {
+    std::string contents = "data_text\n";
+    while (contents.size() < (8 << 20)) {
+      contents.append(text);
+    }
+    check_parallel_tokenizer(contents);
+  }
+
+  SECTION("mixed") {
+    std::string contents;
+    while (contents.size() < (8 << 20)) {
+      contents.append(atom_site).append(text);
+    }
+    check_parallel_tokenizer(contents);
+  }
+}
+
+/*
+ * Tokenizer and column conversion throughput, run with:
+ * pymol._cmd.test2("[benchmark]")
+ */
+TEST_CASE("CifFile benchmark", "[.][benchmark]")
+{
+  using clock = std::chrono::steady_clock;
+
+  // ~1M atom_site rows
+  const unsigned n = 1000000;
+  std::string contents = "data_big\nloop_\n_atom_site.group_PDB\n"
+                         "_atom_site.id\n_atom_site.label_atom_id\n"
+                         "_atom_site.Cartn_x\n_atom_site.Cartn_y\n"
+                         "_atom_site.Cartn_z\n_atom_site.B_iso_or_equiv\n";
+  char buf[128];
+  for (unsigned i = 0; i < n; ++i) {
+    snprintf(buf, sizeof(buf), "ATOM %u CA %.3f %.3f %.3f %.2f\n", i + 1,
+        (i % 997) * 0.137, (i % 991) * -0.071, (i % 983) * 0.029,
+        (i % 89) * 0.5);
+    contents.append(buf);
+  }
+
+  pymol::ThreadPool pool;
+  std::size_t n_thread = std::max(2u, std::thread::hardware_concurrency());
+
+  auto t0 = clock::now();
+  pymol::cif_file cf_serial(nullptr, contents.c_str());
+  auto t1 = clock::now();
+  pymol::cif_file cf_parallel(nullptr, contents.c_str(), &pool, n_thread);
+  auto t2 = clock::now();
+
+  auto* arr = cf_parallel.datablocks()[0].get_opt("_atom_site.cartn_x");
+  std::vector<float> x1(n), x2(n);
+
+  auto t3 = clock::now();
+  for (unsigned i = 0; i < n; ++i) {
+    x1[i] = arr->as_d(i);
+  }
+  auto t4 = clock::now();
+  arr->to_array(x2.data(), n);
+  auto t5 = clock::now();
+
+  auto ms = [](clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+
+  WARN("tokenize: " << ms(t1 - t0) << " ms serial, " << ms(t2 - t1)
+                    << " ms with " << n_thread << " threads; column: "
+                    << ms(t4 - t3) << " ms as_d(), " << ms(t5 - t4)
+                    << " ms to_array()");
+  REQUIRE(x1 == x2);
+}
+
 // vi:sw=2:expandtab
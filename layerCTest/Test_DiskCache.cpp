@@ -0,0 +1,181 @@
+#include "Test.h"
+
+#include "DiskCache.h"
+
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+using namespace pymol::test;
+
+/*
+ * Set the modification time of `path` to `age` seconds ago
+ */
+static void SetFileAge(const std::string& path, std::time_t age)
+{
+  struct utimbuf times;
+  times.actime = times.modtime = std::time(nullptr) - age;
+  REQUIRE(utime(path.c_str(), &times) == 0);
+}
+
+/*
+ * Cache file of `key` in `dir`
+ */
+static std::string CacheFilePath(const std::string& dir, const std::string& key)
+{
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.pmc",
+      (unsigned long long) pymol::DiskCache::hash(key.data(), key.size()));
+  return dir + name;
+}
+
+TEST_CASE("DiskCache put and get", "[DiskCache]")
+{
+  TmpFILE tmpfile;
+  auto dir = tmpfile.getFilenameStr() + ".cache";
+  pymol::DiskCache cache(dir, 0);
+  std::string value;
+
+  REQUIRE(!cache.get("key", value));
+
+  REQUIRE(cache.put("key", std::string("value\0with nul", 14)));
+  REQUIRE(cache.put(std::string(1000, 'k'), ""));
+
+  REQUIRE(cache.get("key", value));
+  REQUIRE(value == std::string("value\0with nul", 14));
+  REQUIRE(cache.get(std::string(1000, 'k'), value));
+  REQUIRE(value.empty());
+  REQUIRE(!cache.get("other key", value));
+
+  // replace
+  REQUIRE(cache.put("key", "new value"));
+  REQUIRE(cache.get("key", value));
+  REQUIRE(value == "new value");
+
+  // persists across instances
+  pymol::DiskCache cache2(dir + "/", 0);
+  REQUIRE(cache2.get("key", value));
+  REQUIRE(value == "new value");
+
+  cache.clear();
+  REQUIRE(cache.size() == 0);
+  REQUIRE(!cache.get("key", value));
+  std::remove(dir.c_str());
+}
+
+TEST_CASE("DiskCache size limit", "[DiskCache]")
+{
+  TmpFILE tmpfile;
+  auto dir = tmpfile.getFilenameStr() + ".cache";
+  const std::size_t max_bytes = 2500;
+  pymol::DiskCache cache(dir, max_bytes);
+  std::string value;
+
+  for (int i = 0; i < 10; ++i) {
+    auto key = "key" + std::to_string(i);
+    REQUIRE(cache.put(key, std::string(1000, 'a' + i)));
+    REQUIRE(cache.size() <= max_bytes);
+
+    // the entry just written is never evicted
+    REQUIRE(cache.get(key, value));
+    REQUIRE(value == std::string(1000, 'a' + i));
+  }
+
+  cache.clear();
+  std::remove(dir.c_str());
+}
+
+TEST_CASE("DiskCache evicts the least recently used entry", "[DiskCache]")
+{
+  TmpFILE tmpfile;
+  auto dir = tmpfile.getFilenameStr() + ".cache";
+  pymol::DiskCache cache(dir, 2500);
+  std::string value;
+
+  // all within the same second, recency must not depend on mtime
+  REQUIRE(cache.put("k0", std::string(1000, 'a')));
+  REQUIRE(cache.put("k1", std::string(1000, 'b')));
+  REQUIRE(cache.get("k0", value));
+  REQUIRE(cache.put("k2", std::string(1000, 'c')));
+
+  REQUIRE(cache.get("k0", value));
+  REQUIRE(value == std::string(1000, 'a'));
+  REQUIRE(cache.get("k2", value));
+  REQUIRE(!cache.get("k1", value));
+  REQUIRE(cache.size() <= 2500);
+
+  cache.clear();
+  std::remove(dir.c_str());
+}
+
+TEST_CASE("DiskCache evicts by modification time across instances", "[DiskCache]")
+{
+  TmpFILE tmpfile;
+  auto dir = tmpfile.getFilenameStr() + ".cache";
+  std::string value;
+
+  {
+    pymol::DiskCache cache(dir, 0);
+    REQUIRE(cache.put("k0", std::string(1000, 'a')));
+    REQUIRE(cache.put("k1", std::string(1000, 'b')));
+  }
+
+  // k1 was used less recently, e.g. by an earlier session
+  SetFileAge(CacheFilePath(dir, "k0"), 100);
+  SetFileAge(CacheFilePath(dir, "k1"), 200);
+
+  pymol::DiskCache cache(dir, 2500);
+  REQUIRE(cache.put("k2", std::string(1000, 'c')));
+
+  REQUIRE(!cache.get("k1", value));
+  REQUIRE(cache.get("k0", value));
+  REQUIRE(cache.get("k2", value));
+
+  cache.clear();
+  std::remove(dir.c_str());
+}
+
+TEST_CASE("DiskCache removes orphaned temporary files", "[DiskCache]")
+{
+  TmpFILE tmpfile;
+  auto dir = tmpfile.getFilenameStr() + ".cache";
+  pymol::DiskCache cache(dir, 0);
+  REQUIRE(cache.put("key", "value"));
+
+  auto touch = [](const std::string& path, std::time_t age) {
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    REQUIRE(fp);
+    std::fputs("partial", fp);
+    std::fclose(fp);
+    SetFileAge(path, age);
+  };
+
+  auto exists = [](const std::string& path) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (fp)
+      std::fclose(fp);
+    return fp != nullptr;
+  };
+
+  // crashed writer, and a writer which may still be running
+  auto orphan = dir + "/0123456789abcdef.pmc.1.2.3.tmp";
+  auto recent = dir + "/0123456789abcdef.pmc.1.2.4.tmp";
+  touch(orphan, 2 * 3600);
+  touch(recent, 0);
+
+  // the first listing cleans up, temporary files don't count
+  pymol::DiskCache cache2(dir, 0);
+  REQUIRE(cache2.size() == cache.size());
+  REQUIRE(!exists(orphan));
+  REQUIRE(exists(recent));
+
+  std::remove(recent.c_str());
+  cache.clear();
+  std::remove(dir.c_str());
+}
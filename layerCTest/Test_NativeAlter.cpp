@@ -0,0 +1,166 @@
+#include "Test.h"
+
+#include "AtomInfo.h"
+#include "Executive.h"
+#include "Lex.h"
+#include "NativeAlter.h"
+#include "ObjectMolecule.h"
+#include "P.h"
+#include "Selector.h"
+#include "Setting.h"
+
+#include <string>
+#include <vector>
+
+using namespace pymol::test;
+
+static const char* DipeptidePDB =
+    "ATOM      1  N   GLY A   1       0.000   0.000   0.000  1.00 10.00           N\n"
+    "ATOM      2  CA  GLY A   1       1.450   0.000   0.000  0.50 20.00           C\n"
+    "ATOM      3  N   ALA A   2       2.500   1.000   0.000  1.00 30.00           N\n"
+    "ATOM      4  CA  ALA A   2       3.900   1.000   0.000  0.25 40.00           C\n"
+    "END\n";
+
+/*
+ * Atom properties which the tested expressions may change, one string per
+ * atom
+ */
+static std::vector<std::string> AtomRecords(
+    PyMOLGlobals* G, const ObjectMolecule* obj)
+{
+  std::vector<std::string> records;
+  for (int a = 0; a < obj->NAtom; ++a) {
+    auto ai = obj->AtomInfo + a;
+    char resi[16], buf[256];
+    AtomResiFromResv(resi, sizeof(resi), ai);
+    snprintf(buf, sizeof(buf), "%s %s %s %s %g %g %d", LexStr(G, ai->name),
+        LexStr(G, ai->resn), resi, LexStr(G, ai->chain), ai->b, ai->q,
+        int(ai->formalCharge));
+    records.push_back(buf);
+  }
+  return records;
+}
+
+/*
+ * alter/iterate `expr` over `sele`, with or without native evaluation
+ * @return number of atoms, or -1 on error
+ */
+static int Iterate(PyMOLGlobals* G, const char* sele, const char* expr,
+    bool read_only, bool native, PyObject* space)
+{
+  SettingSetGlobal_b(G, cSetting_iterate_native, native);
+  PBlock(G);
+  auto result = ExecutiveIterate(G, sele, expr, read_only, 1, space);
+  if (!result)
+    PyErr_Clear();
+  PUnblock(G);
+  return result ? result.result() : -1;
+}
+
+TEST_CASE("Native alter gives the same result as Python", "[NativeAlter]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+  bool iterate_native = SettingGetGlobal_b(G, cSetting_iterate_native);
+
+  auto obj1 = pymol.loadPDB("m1", DipeptidePDB);
+  auto obj2 = pymol.loadPDB("m2", DipeptidePDB);
+
+  PBlock(G);
+  PyObject* space = PyDict_New();
+  PUnblock(G);
+
+  for (const char* expr : {
+           "b = b * 2 + q",
+           "q = resv * 0.5; chain = chain + 'X'",
+           "name = resn + name; formal_charge = -1",
+           "resi = resv + 10",
+           "resi = '7' + chain",
+           // integer overflow: Python path after all
+           "b = resv * 4000000000 * 4000000000 / 1e10",
+           // second statement reads the first one's result: Python path
+           "b = 7; q = b",
+       }) {
+    INFO(expr);
+    REQUIRE(Iterate(G, "m1", expr, false, true, space) == 4);
+    REQUIRE(Iterate(G, "m2", expr, false, false, space) == 4);
+    REQUIRE(AtomRecords(G, obj1) == AtomRecords(G, obj2));
+  }
+
+  for (const char* expr : {
+           "l.append((name, resv, b))",
+           "l.append(resi); l.append(chain + resn)",
+           "l.append(index * 3000000000 * 4000000000)",
+       }) {
+    INFO(expr);
+    PBlock(G);
+    PyObject* list1 = PyList_New(0);
+    PyObject* list2 = PyList_New(0);
+    PUnblock(G);
+
+    PBlock(G);
+    PyDict_SetItemString(space, "l", list1);
+    PUnblock(G);
+    REQUIRE(Iterate(G, "m1", expr, true, true, space) == 4);
+
+    PBlock(G);
+    PyDict_SetItemString(space, "l", list2);
+    PUnblock(G);
+    REQUIRE(Iterate(G, "m2", expr, true, false, space) == 4);
+
+    PBlock(G);
+    Py_ssize_t size = PyList_Size(list1);
+    int equal = PyObject_RichCompareBool(list1, list2, Py_EQ);
+    Py_DECREF(list1);
+    Py_DECREF(list2);
+    PUnblock(G);
+
+    REQUIRE(size >= 4);
+    REQUIRE(equal == 1);
+  }
+
+  PBlock(G);
+  Py_DECREF(space);
+  PUnblock(G);
+
+  SettingSetGlobal_b(G, cSetting_iterate_native, iterate_native);
+}
+
+TEST_CASE("Native alter leaves unsupported cases to Python", "[NativeAlter]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  auto obj = pymol.loadPDB("m1", DipeptidePDB);
+  auto before = AtomRecords(G, obj);
+
+  SelectorTmp2 sele(G, "m1");
+  int count = 0;
+  bool handled = true;
+  bool ok;
+
+  PBlock(G);
+  PyObject* space = PyDict_New();
+
+  // reads what an earlier statement assigns
+  bool dependent =
+      bool(pymol::NativeAlter::compile(G, "b = 7; q = b", false, space));
+  bool independent =
+      bool(pymol::NativeAlter::compile(G, "q = b; b = 7", false, space));
+
+  // overflow in the second statement: the first one isn't assigned either
+  auto prog = pymol::NativeAlter::compile(
+      G, "b = 1; q = resv * 4000000000 * 4000000000", false, space);
+  ok = prog && prog->run(sele.getIndex(), &count, &handled);
+  prog.reset();
+
+  Py_DECREF(space);
+  PUnblock(G);
+
+  REQUIRE(!dependent);
+  REQUIRE(independent);
+  REQUIRE(ok);
+  REQUIRE(!handled);
+  REQUIRE(count == 0);
+  REQUIRE(AtomRecords(G, obj) == before);
+}
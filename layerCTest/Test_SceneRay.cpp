@@ -0,0 +1,102 @@
+#include "Test.h"
+
+#include "Executive.h"
+#include "ObjectMolecule.h"
+#include "PyMOL.h"
+#include "Rep.h"
+#include "Scene.h"
+#include "SceneDef.h"
+#include "Selector.h"
+#include "Setting.h"
+
+#include <vector>
+
+using namespace pymol::test;
+
+static std::vector<unsigned> RayPixels(PyMOLGlobals* G, int antialias = 0)
+{
+  ExecutiveRay(G, 64, 48, 0, 0.F, 0.F, true, false, antialias);
+  auto& image = G->Scene->Image;
+  REQUIRE(image);
+  auto pixels = image->pixels();
+  return std::vector<unsigned>(
+      pixels, pixels + image->getWidth() * image->getHeight());
+}
+
+TEST_CASE("Ray primitive cache sees coordinate and matrix edits", "[SceneRay]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  auto obj = pymol.loadPDB("m1", TwoWatersPDB);
+  REQUIRE(ExecutiveSetRepVisMask(G, "m1", cRepSphereBit, cVis_AS));
+  REQUIRE(ExecutiveWindowZoom(G, "m1", 4.F, 0, 0, 0.F, 1));
+
+  // render with state matrices
+  SettingSet(G, &obj->Setting, cSetting_matrix_mode, 1);
+
+  auto first = RayPixels(G);
+  REQUIRE(G->Scene->RayCache);
+
+  // nothing changed: the cached primitives give the same image
+  REQUIRE(RayPixels(G) == first);
+
+  SECTION("move atoms")
+  {
+    const float shift[] = {
+        1.F, 0.F, 0.F, 1.5F, //
+        0.F, 1.F, 0.F, 0.F,  //
+        0.F, 0.F, 1.F, 0.F,  //
+        0.F, 0.F, 0.F, 1.F,  //
+    };
+    SelectorTmp2 sele(G, "id 2");
+    REQUIRE(ExecutiveTransformObjectSelection(
+        G, "m1", 0, sele.getName(), 0, shift, true, false));
+    REQUIRE(RayPixels(G) != first);
+  }
+
+  SECTION("object state matrix")
+  {
+    double shift[] = {
+        1., 0., 0., 1.5, //
+        0., 1., 0., 0.,  //
+        0., 0., 1., 0.,  //
+        0., 0., 0., 1.,  //
+    };
+    REQUIRE(ExecutiveSetObjectMatrix(G, "m1", 0, shift));
+    REQUIRE(RayPixels(G) != first);
+  }
+}
+
+TEST_CASE("Progressive ray tracing gives the same final image", "[SceneRay]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  pymol.loadPDB("m1", TwoWatersPDB);
+  REQUIRE(ExecutiveSetRepVisMask(G, "m1", cRepSphereBit, cVis_AS));
+  REQUIRE(ExecutiveWindowZoom(G, "m1", 4.F, 0, 0, 0.F, 1));
+
+  for (int antialias : {0, 1}) {
+    SettingSetGlobal_i(G, cSetting_ray_progressive, 0);
+    auto plain = RayPixels(G, antialias);
+
+    SettingSetGlobal_i(G, cSetting_ray_progressive, 3);
+    auto progressive = RayPixels(G, antialias);
+
+    REQUIRE(progressive == plain);
+    REQUIRE(PyMOL_GetImagePreview(pymol.get(), false) == 0);
+  }
+
+  // the lock free read path sees the final image
+  const int width = 64, height = 48;
+  std::vector<unsigned> preview(width * height), image(width * height);
+  REQUIRE(PyMOL_GetImagePreviewData(pymol.get(), width, height, width * 4,
+              preview.data(), 0) == PyMOLstatus_SUCCESS);
+  REQUIRE(SceneCopyExternal(G, width, height, width * 4,
+      reinterpret_cast<unsigned char*>(image.data()), 0));
+  REQUIRE(preview == image);
+
+  REQUIRE(PyMOL_GetImagePreviewData(pymol.get(), width / 2, height, width * 4,
+              preview.data(), 0) != PyMOLstatus_SUCCESS);
+}
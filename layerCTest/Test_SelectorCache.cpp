@@ -0,0 +1,38 @@
+#include "Test.h"
+
+#include "Executive.h"
+#include "ObjectMolecule.h"
+#include "Selector.h"
+#include "Setting.h"
+
+using namespace pymol::test;
+
+static const char* TwoNamesPDB =
+    "HETATM    1  O5A LIG A   1       0.000   0.000   0.000  1.00  0.00           O\n"
+    "HETATM    2  O5B LIG A   1       1.500   0.000   0.000  1.00  0.00           O\n"
+    "END\n";
+
+static int CountAtoms(PyMOLGlobals* G, const char* expr)
+{
+  SelectorTmp2 sele(G, expr);
+  return sele.getAtomCount();
+}
+
+TEST_CASE("Memoized name predicates follow atom_name_wildcard", "[Selector]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  auto obj = pymol.loadPDB("m1", TwoNamesPDB);
+
+  // "*" is a wildcard
+  REQUIRE(CountAtoms(G, "(name O5*)") == 2);
+  REQUIRE(CountAtoms(G, "(name O5*)") == 2);
+
+  // no wildcards for this object (like for names which contain "*")
+  SettingSet(G, &obj->Setting, cSetting_atom_name_wildcard, " ");
+  REQUIRE(CountAtoms(G, "(name O5*)") == 0);
+
+  SettingSet(G, &obj->Setting, cSetting_atom_name_wildcard, "");
+  REQUIRE(CountAtoms(G, "(name O5*)") == 2);
+}
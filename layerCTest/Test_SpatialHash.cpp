@@ -0,0 +1,206 @@
+#include "Test.h"
+
+#include "Executive.h"
+#include "ObjectMolecule.h"
+#include "P.h"
+#include "Selector.h"
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pymol::test;
+
+static std::vector<float> random_points(std::size_t n, float size, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-size / 2, size / 2);
+  std::vector<float> vert(3 * n);
+  for (auto& f : vert) {
+    f = dist(rng);
+  }
+  return vert;
+}
+
+static std::vector<int> brute_force_within(const std::vector<float>& vert,
+    const float* v, float cutoff, const int* flag = nullptr)
+{
+  std::vector<int> result;
+  for (std::size_t a = 0; a < vert.size() / 3; ++a) {
+    if ((!flag || flag[a]) && within3f(vert.data() + 3 * a, v, cutoff)) {
+      result.push_back(a);
+    }
+  }
+  return result;
+}
+
+TEST_CASE("SpatialHash finds the same neighbors as brute force", "[SpatialHash]")
+{
+  const float cutoff = 2.5F;
+  auto vert = random_points(2000, 30.F, 1);
+  pymol::SpatialHash hash(cutoff, vert.data(), vert.size() / 3);
+
+  REQUIRE(hash.size() == 2000);
+
+  // query points inside, on the edge of, and far outside the grid
+  auto queries = random_points(200, 40.F, 2);
+  queries.insert(queries.end(), {100.F, 0.F, 0.F, -16.F, -16.F, -16.F});
+
+  for (std::size_t q = 0; q < queries.size() / 3; ++q) {
+    const float* v = queries.data() + 3 * q;
+    std::vector<int> found;
+    hash.forEachWithin(v, cutoff, [&](int j) { found.push_back(j); });
+    std::sort(found.begin(), found.end());
+    REQUIRE(found == brute_force_within(vert, v, cutoff));
+  }
+}
+
+TEST_CASE("SpatialHash visits every candidate once", "[SpatialHash]")
+{
+  auto vert = random_points(500, 10.F, 3);
+  pymol::SpatialHash hash(1.F, vert.data(), vert.size() / 3);
+
+  std::vector<int> count(500, 0);
+  for (std::size_t a = 0; a < 500; ++a) {
+    for (auto j : hash.query(vert.data() + 3 * a)) {
+      if (j == int(a))
+        ++count[a];
+    }
+  }
+  for (auto c : count) {
+    REQUIRE(c == 1);
+  }
+}
+
+TEST_CASE("SpatialHash flags and degenerate input", "[SpatialHash]")
+{
+  auto vert = random_points(100, 5.F, 4);
+  std::vector<int> flag(100, 0);
+  for (int a = 0; a < 100; a += 3) {
+    flag[a] = 1;
+  }
+
+  pymol::SpatialHash hash(1.5F, vert.data(), 100, flag.data());
+  REQUIRE(hash.size() == 34);
+
+  for (int a = 0; a < 100; ++a) {
+    const float* v = vert.data() + 3 * a;
+    std::vector<int> found;
+    hash.forEachWithin(v, 1.5F, [&](int j) { found.push_back(j); });
+    std::sort(found.begin(), found.end());
+    REQUIRE(found == brute_force_within(vert, v, 1.5F, flag.data()));
+  }
+
+  // no points
+  pymol::SpatialHash empty(1.F, nullptr, 0);
+  REQUIRE(empty.size() == 0);
+  REQUIRE(!(empty.query(vert.data()) != empty.query(vert.data()).end()));
+
+  // all points in one spot, zero cutoff
+  std::vector<float> same(30, 1.F);
+  pymol::SpatialHash single(0.F, same.data(), 10);
+  int n = 0;
+  single.forEachWithin(same.data(), 0.F, [&](int) { ++n; });
+  REQUIRE(n == 10);
+}
+
+TEST_CASE("SpatialHash sparse points don't allocate a dense grid", "[SpatialHash]")
+{
+  std::vector<float> vert = {0.F, 0.F, 0.F, 1e4F, 1e4F, 1e4F};
+  pymol::SpatialHash hash(1.F, vert.data(), 2);
+  REQUIRE(hash.cellCount() <= 64);
+
+  int n = 0;
+  hash.forEachWithin(vert.data() + 3, 1.F, [&](int j) { n += (j == 1); });
+  REQUIRE(n == 1);
+}
+
+static int CountAtoms(PyMOLGlobals* G, const char* expr)
+{
+  SelectorTmp2 sele(G, expr);
+  return sele.getAtomCount();
+}
+
+TEST_CASE("Coordinate set index follows load_coords", "[SpatialHash]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  // a row of atoms 3 A apart, enough for a per-coordset index
+  const int n_atom = 16;
+  std::string pdb;
+  for (int i = 0; i < n_atom; ++i) {
+    char line[82];
+    snprintf(line, sizeof(line),
+        "HETATM%5d  O   HOH A%4d    %8.3f%8.3f%8.3f  1.00  0.00           O\n",
+        i + 1, i + 1, 3.F * i, 0.F, 0.F);
+    pdb += line;
+  }
+  pymol.loadPDB("m1", pdb.c_str());
+
+  REQUIRE(CountAtoms(G, "m1 within 1.5 of id 1") == 1);
+
+  std::vector<float> coords(3 * n_atom);
+  for (int i = 0; i < n_atom; ++i) {
+    coords[3 * i] = 3.F * i;
+  }
+
+  SECTION("ObjectMoleculeLoadCoords")
+  {
+    coords[3 * (n_atom - 1)] = 1.F;
+    REQUIRE(ObjectMoleculeLoadCoords(G, "m1", coords.data(), coords.size(), 0));
+    REQUIRE(CountAtoms(G, "m1 within 1.5 of id 1") == 2);
+  }
+
+  SECTION("SelectorLoadCoords")
+  {
+    coords[3 * (n_atom - 2)] = -1.F;
+    SelectorTmp2 sele(G, "m1");
+
+    // Python sequence of (x, y, z) rows
+    PBlock(G);
+    PyObject* rows = PyList_New(n_atom);
+    for (int i = 0; i < n_atom; ++i) {
+      PyList_SetItem(rows, i, PConvFloatArrayToPyList(&coords[3 * i], 3));
+    }
+    auto result = SelectorLoadCoords(G, rows, sele.getIndex(), 0);
+    Py_DECREF(rows);
+    PUnblock(G);
+    REQUIRE(result);
+    REQUIRE(CountAtoms(G, "m1 within 1.5 of id 1") == 2);
+  }
+}
+
+/*
+ * Build and query throughput, run with: pymol._cmd.test2("[benchmark]")
+ */
+TEST_CASE("SpatialHash benchmark", "[.][benchmark]")
+{
+  using clock = std::chrono::steady_clock;
+
+  // ~protein density: 1M atoms in a 220 A cube
+  const std::size_t n = 1000000;
+  auto vert = random_points(n, 220.F, 5);
+
+  auto t0 = clock::now();
+  pymol::SpatialHash hash(5.F, vert.data(), n);
+  auto t1 = clock::now();
+
+  std::size_t n_pair = 0;
+  for (std::size_t a = 0; a < n; ++a) {
+    hash.forEachWithin(vert.data() + 3 * a, 5.F, [&](int) { ++n_pair; });
+  }
+  auto t2 = clock::now();
+
+  auto sec = [](clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+  };
+
+  WARN("build: " << n / sec(t1 - t0) / 1e6 << " M points/s, query: "
+                 << n / sec(t2 - t1) / 1e6 << " M queries/s ("
+                 << double(n_pair) / n << " neighbors per query)");
+  REQUIRE(n_pair >= n);
+}
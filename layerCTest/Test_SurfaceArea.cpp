@@ -0,0 +1,102 @@
+#include "Test.h"
+
+#include "Sphere.h"
+#include "SurfaceArea.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace pymol::test;
+
+namespace
+{
+/**
+ * Golden spiral dot sphere with equal dot areas
+ */
+struct SpiralSphere {
+  std::vector<Vector3f> dot;
+  std::vector<float> area;
+  SphereRec rec{};
+
+  explicit SpiralSphere(int n)
+      : dot(n)
+      , area(n, float(4 * cPI / n))
+  {
+    const double golden = cPI * (3 - std::sqrt(5.0));
+    for (int i = 0; i < n; ++i) {
+      double z = 1 - (2 * i + 1) / double(n);
+      double r = std::sqrt(1 - z * z);
+      dot[i][0] = float(r * std::cos(golden * i));
+      dot[i][1] = float(r * std::sin(golden * i));
+      dot[i][2] = float(z);
+    }
+    rec.dot = dot.data();
+    rec.area = area.data();
+    rec.nDot = n;
+  }
+};
+} // namespace
+
+TEST_CASE("AtomSurfaceArea single and overlapping spheres", "[SurfaceArea]")
+{
+  SpiralSphere sphere(4000);
+  const float coord[] = {0.F, 0.F, 0.F, 2.F, 0.F, 0.F, 50.F, 0.F, 0.F};
+  const float radius[] = {1.5F, 1.F, 2.F};
+  float area[3];
+
+  pymol::AtomSurfaceArea(
+      coord, radius, 3, nullptr, nullptr, &sphere.rec, nullptr, 1, area);
+
+  // spherical caps buried by the other sphere: 2 pi r h
+  const float d = 2.F;
+  const float h0 = 1.5F - (d * d + 1.5F * 1.5F - 1.F) / (2 * d);
+  const float h1 = 1.F - (d * d + 1.F - 1.5F * 1.5F) / (2 * d);
+  REQUIRE(area[0] == Approx(4 * cPI * 1.5 * 1.5 - 2 * cPI * 1.5 * h0).epsilon(0.01));
+  REQUIRE(area[1] == Approx(4 * cPI * 1.0 * 1.0 - 2 * cPI * 1.0 * h1).epsilon(0.01));
+  REQUIRE(area[2] == Approx(4 * cPI * 2.0 * 2.0).epsilon(0.0001));
+
+  // masks
+  const int surface[] = {1, 0, 1};
+  float masked[3];
+  pymol::AtomSurfaceArea(
+      coord, radius, 3, surface, nullptr, &sphere.rec, nullptr, 1, masked);
+  REQUIRE(masked[0] == area[0]);
+  REQUIRE(masked[1] == 0.F);
+
+  const int no_occlusion[] = {1, 0, 1};
+  pymol::AtomSurfaceArea(
+      coord, radius, 3, nullptr, no_occlusion, &sphere.rec, nullptr, 1, masked);
+  REQUIRE(masked[0] == Approx(4 * cPI * 1.5 * 1.5).epsilon(0.0001));
+  REQUIRE(masked[1] == area[1]);
+}
+
+TEST_CASE("AtomSurfaceArea independent of thread count", "[SurfaceArea]")
+{
+  SpiralSphere sphere(200);
+  pymol::ThreadPool pool;
+
+  // a lattice of touching spheres
+  std::vector<float> coord, radius;
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      for (int k = 0; k < 10; ++k) {
+        coord.insert(coord.end(), {i * 2.5F, j * 2.5F, k * 2.5F + 0.1F * i});
+        radius.push_back(1.4F + 0.05F * ((i + j + k) % 5));
+      }
+    }
+  }
+
+  const std::size_t n = radius.size();
+  std::vector<float> area1(n), area4(n);
+  pymol::AtomSurfaceArea(coord.data(), radius.data(), n, nullptr, nullptr,
+      &sphere.rec, &pool, 1, area1.data());
+  pymol::AtomSurfaceArea(coord.data(), radius.data(), n, nullptr, nullptr,
+      &sphere.rec, &pool, 4, area4.data());
+
+  REQUIRE(area1 == area4);
+
+  // corner atoms are more exposed than interior atoms
+  REQUIRE(area1[0] > area1[555]);
+  REQUIRE(area1[555] >= 0.F);
+}
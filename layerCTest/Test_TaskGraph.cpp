@@ -0,0 +1,90 @@
+#include "Test.h"
+
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace pymol::test;
+
+TEST_CASE("TaskGraph serial runs in insertion order", "[TaskGraph]")
+{
+  pymol::ThreadPool pool;
+  pymol::TaskGraph graph;
+  std::vector<int> order;
+
+  auto a = graph.add([&] { order.push_back(0); });
+  auto b = graph.add([&] { order.push_back(1); }, {a});
+  graph.add([&] { order.push_back(2); }, {a, b});
+
+  graph.run(pool, 1);
+
+  REQUIRE(order == std::vector<int>{0, 1, 2});
+  REQUIRE(graph.size() == 0);
+  REQUIRE(pool.size() == 0);
+}
+
+TEST_CASE("TaskGraph respects dependencies", "[TaskGraph]")
+{
+  pymol::ThreadPool pool;
+
+  for (int repeat = 0; repeat < 20; ++repeat) {
+    pymol::TaskGraph graph;
+    std::mutex mutex;
+    std::vector<int> finished;
+
+    auto done = [&](int id) {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished.push_back(id);
+    };
+
+    // two objects with a "neighbors" task each, followed by state tasks
+    std::vector<std::pair<int, int>> deps;
+    for (int obj = 0; obj < 2; ++obj) {
+      int root = graph.add([&, obj] { done(obj * 100); });
+      for (int state = 1; state <= 8; ++state) {
+        int id = obj * 100 + state;
+        graph.add([&, id] { done(id); }, {pymol::TaskGraph::TaskId(root)});
+        deps.emplace_back(obj * 100, id);
+      }
+    }
+
+    // a task which depends on everything
+    auto last = graph.add([&] { done(-1); });
+    for (pymol::TaskGraph::TaskId id = 0; id < last; ++id) {
+      graph.addDependency(last, id);
+    }
+
+    graph.run(pool, 4);
+
+    REQUIRE(finished.size() == 19);
+    REQUIRE(finished.back() == -1);
+
+    auto position = [&](int id) {
+      return std::find(finished.begin(), finished.end(), id) - finished.begin();
+    };
+
+    for (auto& dep : deps) {
+      REQUIRE(position(dep.first) < position(dep.second));
+    }
+  }
+}
+
+TEST_CASE("TaskGraph nested in a pool task", "[TaskGraph]")
+{
+  pymol::ThreadPool pool;
+  std::atomic<int> sum{0};
+
+  pool.run(4, 4, [&](std::size_t) {
+    pymol::TaskGraph graph;
+    auto a = graph.add([&] { sum += 1; });
+    graph.add([&] { sum += 2; }, {a});
+    graph.add([&] { sum += 3; }, {a});
+    graph.run(pool, 4);
+  });
+
+  REQUIRE(sum.load() == 4 * 6);
+}
@@ -0,0 +1,72 @@
+#include "Test.h"
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pymol::test;
+
+TEST_CASE("ThreadPool runs every task once", "[ThreadPool]")
+{
+  pymol::ThreadPool pool;
+  std::vector<int> count(1000, 0);
+
+  pool.run(count.size(), 4, [&](std::size_t i) { ++count[i]; });
+
+  for (auto c : count) {
+    REQUIRE(c == 1);
+  }
+  REQUIRE(pool.size() == 3);
+}
+
+TEST_CASE("ThreadPool task 0 runs on calling thread", "[ThreadPool]")
+{
+  pymol::ThreadPool pool;
+  auto caller = std::this_thread::get_id();
+
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    std::thread::id id0;
+    std::atomic<int> n_wrong{0};
+    pool.run(8, 8, [&](std::size_t i) {
+      if (i == 0)
+        id0 = std::this_thread::get_id();
+      if (pymol::ThreadPool::isWorkerThread() !=
+          (std::this_thread::get_id() != caller))
+        ++n_wrong;
+    });
+    REQUIRE(id0 == caller);
+    REQUIRE(n_wrong.load() == 0);
+    REQUIRE(!pymol::ThreadPool::isWorkerThread());
+  }
+}
+
+TEST_CASE("ThreadPool serial and nested", "[ThreadPool]")
+{
+  pymol::ThreadPool pool;
+  std::atomic<int> sum{0};
+
+  pool.run(10, 1, [&](std::size_t i) { sum += i; });
+  REQUIRE(sum.load() == 45);
+  REQUIRE(pool.size() == 0);
+
+  sum = 0;
+  pool.run(4, 4, [&](std::size_t) {
+    pool.run(10, 4, [&](std::size_t i) { sum += i; });
+  });
+  REQUIRE(sum.load() == 4 * 45);
+}
+
+TEST_CASE("ThreadPool single task may run in parallel", "[ThreadPool]")
+{
+  pymol::ThreadPool pool;
+  std::atomic<int> sum{0};
+
+  // e.g. one state, split over its atoms
+  pool.run(1, 4, [&](std::size_t) {
+    pool.run(10, 4, [&](std::size_t i) { sum += i; });
+  });
+  REQUIRE(sum.load() == 45);
+  REQUIRE(pool.size() == 3);
+}
@@ -0,0 +1,93 @@
+#include "Test.h"
+
+#include "CoordSet.h"
+#include "Executive.h"
+#include "ObjectMolecule.h"
+#include "Setting.h"
+#include "TrajStream.h"
+
+using namespace pymol::test;
+
+namespace
+{
+/**
+ * Frame `i` has all atoms at x = i
+ */
+struct CountingFrameReader : CTrajFrameReader {
+  int n_atom;
+  explicit CountingFrameReader(int n) : n_atom(n) {}
+  bool read(int index, float* coords) override
+  {
+    for (int i = 0; i < n_atom; ++i) {
+      coords[3 * i] = float(index);
+      coords[3 * i + 1] = coords[3 * i + 2] = 0.F;
+    }
+    return true;
+  }
+};
+} // namespace
+
+static int CountResident(const ObjectMolecule* obj)
+{
+  int n = 0;
+  for (int state = 0; state < obj->NCSet; ++state) {
+    n += obj->CSet[state] != nullptr;
+  }
+  return n;
+}
+
+TEST_CASE("Streamed trajectory states", "[TrajStream]")
+{
+  PyMOLSession pymol;
+  auto G = pymol.G();
+
+  auto obj = pymol.loadPDB("m1", TwoWatersPDB);
+
+  // stream 10 states, keep as few resident as possible
+  const int n_frame = 10;
+  VLACheck(obj->CSet, CoordSet*, n_frame - 1);
+  obj->NCSet = n_frame;
+  obj->TrajStream = new CTrajStream(G, obj,
+      std::unique_ptr<CTrajFrameReader>(new CountingFrameReader(2)), nullptr,
+      2, 2, 0, n_frame);
+  TrajStreamAddResident(obj->TrajStream, 0);
+
+  float cache = SettingGetGlobal_f(G, cSetting_traj_stream_cache);
+  SettingSetGlobal_f(G, cSetting_traj_stream_cache, 0.F);
+
+  SECTION("fetching stays within the cache budget")
+  {
+    // e.g. cmd.get_coords(state=s) in a loop, without any update
+    for (int state = 1; state < n_frame; ++state) {
+      auto cs = obj->getCoordSet(state);
+      REQUIRE(cs);
+      REQUIRE(cs->coordPtr(1)[0] == float(state));
+      REQUIRE(CountResident(obj) <= 2);
+    }
+
+    // the last two fetched states stay valid
+    auto cs8 = obj->getCoordSet(8);
+    auto cs9 = obj->getCoordSet(9);
+    REQUIRE(obj->CSet[8] == cs8);
+    REQUIRE(obj->CSet[9] == cs9);
+
+    int start = 0, stop = n_frame;
+    TrajStreamUpdateRange(obj->TrajStream, &start, &stop);
+    REQUIRE(CountResident(obj) <= 2);
+    REQUIRE(obj->CSet[obj->getCurrentState()]);
+  }
+
+  SECTION("copy has all states")
+  {
+    auto copy = ObjectMoleculeCopy(obj);
+    REQUIRE(copy);
+    REQUIRE(CountResident(copy) == n_frame);
+    REQUIRE(CountResident(obj) == 1);
+    for (int state = 1; state < n_frame; ++state) {
+      REQUIRE(copy->CSet[state]->coordPtr(1)[0] == float(state));
+    }
+    delete copy;
+  }
+
+  SettingSetGlobal_f(G, cSetting_traj_stream_cache, cache);
+}
@@ -102,6 +102,7 @@ from .querying import \
       find_pairs,         \
       get_angle,          \
       get_area,           \
+      get_atom_areas,     \
       get_assembly_ids,   \
       get_bonds,          \
       get_chains,         \
@@ -114,6 +115,7 @@ from .querying import \
       get_object_state,   \
       get_color_tuple,    \
       get_atom_coords,    \
+      get_atom_column,    \
       get_coords,         \
       get_coordset,       \
       get_dihedral,       \
@@ -226,6 +228,7 @@ from .editing import \
       sculpt_deactivate,  \
       sculpt_activate,    \
       sculpt_iterate,     \
+      set_atom_column,    \
       set_dihedral,       \
       set_name,           \
       set_geometry,       \
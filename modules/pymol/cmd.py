@@ -159,8 +159,6 @@ if True:
         from . import internal
 
         _alt = internal._alt
-        _coordset_update_spawn = internal._coordset_update_spawn
-        _coordset_update_thread = internal._coordset_update_thread
         _copy_image = internal._copy_image
         _ctrl = internal._ctrl
         _ctsh = internal._ctsh
@@ -173,13 +171,8 @@ if True:
         _interpret_color = internal._interpret_color
         _invalidate_color_sc = internal._invalidate_color_sc
         _mpng = internal._mpng
-        _object_update_spawn = internal._object_update_spawn
-        _object_update_thread = internal._object_update_thread
         _png = internal._png
         _quit = internal._quit
-        _ray_anti_spawn = internal._ray_anti_spawn
-        _ray_hash_spawn = internal._ray_hash_spawn
-        _ray_spawn = internal._ray_spawn
         _refresh = internal._refresh
         _special = internal._special
         _validate_color_sc = internal._validate_color_sc
@@ -1368,6 +1368,10 @@ NOTES
     All strings must be explicitly quoted.  This operation typically
     takes several seconds per thousand atoms altered.  
 
+    Expressions which only assign constants, properties and arithmetic
+    on them (e.g. b=0, q=b*0.5+1, chain='B') are evaluated without
+    calling Python for each atom, unless "iterate_native" is off.
+
     You may need to issue a "rebuild" in order to update associated
     representations.
     
@@ -1393,6 +1397,46 @@ SEE ALSO
             return _cmd.alter(_self._COb, selection, expression, False,
                               int(quiet), dict(space))
 
+    def set_atom_column(name, values, selection='all', table=None, *, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Set an atomic property for all atoms in a selection from
+    a sequence with one value per atom (most efficient with numpy
+    arrays), in the same atom order as "iterate" and "get_atom_column".
+
+    Equivalent to, but much faster than:
+
+    values = iter(values)
+    alter selection, b = next(values)
+
+ARGUMENTS
+
+    name = str: property name, e.g. b, q, vdw, partial_charge,
+    formal_charge, color, resv, reps, flags, ss, name, resn, chain, segi
+
+    values = sequence: one value per atom. For string properties either
+    strings, or integer indices into "table".
+
+    selection = str: atom selection {default: all}
+
+    table = list of str: lookup table for string properties, as returned
+    by get_atom_column {default: None}
+
+EXAMPLE
+
+    codes, table = cmd.get_atom_column('chain')
+    cmd.set_atom_column('chain', codes, table=[c.lower() for c in table])
+
+SEE ALSO
+
+    get_atom_column, alter
+        '''
+        selection = selector.process(selection)
+        with _self.lockcm:
+            return _cmd.set_atom_column(_self._COb, selection, str(name),
+                                        values, table)
+
     def alter_list(object, expr_list, quiet=1, space=None, _self=cmd):
         '''
 DESCRIPTION
@@ -1436,6 +1480,10 @@ NOTES
     altered.  For this reason, "iterate" is more efficient than
     "alter".
 
+    Appending properties to a list (e.g. stored.names.append(name),
+    stored.l.append((resi, b))) is evaluated without calling Python
+    for each atom, unless "iterate_native" is off.
+
 SEE ALSO
 
     iterate_state, alter, alter_state
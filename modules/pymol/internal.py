@@ -2,7 +2,6 @@ import os
 import sys
 cmd = sys.modules["pymol.cmd"]
 from pymol import _cmd
-import threading
 import traceback
 
 import _thread as thread
@@ -126,111 +125,6 @@ def _cache_set(new_entry, max_size, _self=cmd):
             traceback.print_exc()
     return r
 
-# ray tracing threads
-
-def _ray_anti_spawn(thread_info,_self=cmd):
-    # WARNING: internal routine, subject to change
-    # internal routine to support multithreaded raytracing
-    thread_list = []
-    for a in thread_info[1:]:
-        t = threading.Thread(target=_cmd.ray_anti_thread,
-                                    args=(_self._COb,a))
-        t.setDaemon(1)
-        thread_list.append(t)
-    for t in thread_list:
-        t.start()
-    _cmd.ray_anti_thread(_self._COb,thread_info[0])
-    for t in thread_list:
-        t.join()
-
-def _ray_hash_spawn(thread_info,_self=cmd):
-    # WARNING: internal routine, subject to change
-    # internal routine to support multithreaded raytracing
-    thread_list = []
-    for a in thread_info[1:]:
-        if a is not None:
-            t = threading.Thread(target=_cmd.ray_hash_thread,
-                                 args=(_self._COb,a))
-            t.setDaemon(1)
-            thread_list.append(t)
-    for t in thread_list:
-        t.start()
-    if thread_info[0] is not None:
-        _cmd.ray_hash_thread(_self._COb,thread_info[0])
-    for t in thread_list:
-        t.join()
-
-def _ray_spawn(thread_info,_self=cmd):
-    # WARNING: internal routine, subject to change
-    # internal routine to support multithreaded raytracing
-    thread_list = []
-    for a in thread_info[1:]:
-        t = threading.Thread(target=_cmd.ray_trace_thread,
-                                    args=(_self._COb,a))
-        t.setDaemon(1)
-        thread_list.append(t)
-    for t in thread_list:
-        t.start()
-    _cmd.ray_trace_thread(_self._COb,thread_info[0])
-    for t in thread_list:
-        t.join()
-
-def _coordset_update_thread(list_lock,thread_info,_self=cmd):
-    # WARNING: internal routine, subject to change
-    while 1:
-        list_lock.acquire()
-        if not len(thread_info):
-            list_lock.release()
-            break
-        else:
-            info = thread_info.pop(0)
-            list_lock.release()
-        _cmd.coordset_update_thread(_self._COb,info)
-
-def _coordset_update_spawn(thread_info,n_thread,_self=cmd):
-    # WARNING: internal routine, subject to change
-    if len(thread_info):
-        list_lock = threading.Lock() # mutex for list
-        thread_list = []
-        for a in range(1,n_thread):
-            t = threading.Thread(target=_coordset_update_thread,
-                                        args=(list_lock,thread_info))
-            t.setDaemon(1)
-            thread_list.append(t)
-        for t in thread_list:
-            t.start()
-        _coordset_update_thread(list_lock,thread_info)
-        for t in thread_list:
-            t.join()
-
-def _object_update_thread(list_lock,thread_info,_self=cmd):
-    # WARNING: internal routine, subject to change
-    while 1:
-        list_lock.acquire()
-        if not len(thread_info):
-            list_lock.release()
-            break
-        else:
-            info = thread_info.pop(0)
-            list_lock.release()
-        _cmd.object_update_thread(_self._COb,info)
-
-def _object_update_spawn(thread_info,n_thread,_self=cmd):
-    # WARNING: internal routine, subject to change
-    if len(thread_info):
-        list_lock = threading.Lock() # mutex for list
-        thread_list = []
-        for a in range(1,n_thread):
-            t = threading.Thread(target=_object_update_thread,
-                                        args=(list_lock,thread_info))
-            t.setDaemon(1)
-            thread_list.append(t)
-        for t in thread_list:
-            t.start()
-        _object_update_thread(list_lock,thread_info)
-        for t in thread_list:
-            t.join()
-
 # status reporting
 
 # do command (while API already locked)
@@ -911,6 +911,39 @@ ARGUMENTS
             r = _cmd.get_coords(_self._COb, selection, int(state) - 1)
             return r
 
+    def get_atom_column(name, selection='all', *, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get an atomic property for all atoms in a selection as a
+    numpy array, in the same atom order as "iterate".
+
+    Equivalent to, but much faster than:
+
+    values = []
+    iterate selection, values.append(b)
+
+    String properties are returned as a (codes, table) tuple, where
+    codes is an int32 array of indices into the list of unique values:
+
+    codes, table = cmd.get_atom_column('resn')
+    resn_of_first_atom = table[codes[0]]
+
+ARGUMENTS
+
+    name = str: property name, e.g. b, q, vdw, partial_charge,
+    formal_charge, color, resv, reps, flags, ss, name, resn, chain, segi
+
+    selection = str: atom selection {default: all}
+
+SEE ALSO
+
+    set_atom_column, get_coords, iterate
+        '''
+        selection = selector.process(selection)
+        with _self.lockcm:
+            return _cmd.get_atom_column(_self._COb, selection, str(name))
+
     def get_coordset(name, state=1, copy=1, quiet=1, _self=cmd):
         '''
 DESCRIPTION
@@ -1118,6 +1151,37 @@ SEE ALSO
             print(" cmd.get_area: %5.3f Angstroms^2."%r)
         return r
 
+    def get_atom_areas(selection="all", state=1, *, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the surface area of each atom in a selection as a numpy
+    array, in the same atom order as "iterate". Uses the same settings as
+    "get_area" (dot_solvent, dot_density) but doesn't build a "dots"
+    representation, and computes all states in one call.
+
+ARGUMENTS
+
+    selection = str: atom selection within a single object {default: all}
+
+    state = int: state index, current state if state=-1, or all states if
+    state=0 {default: 1}
+
+RETURNS
+
+    Array of shape (n_atom,), or (n_state, n_atom) for state=0
+
+SEE ALSO
+
+    get_area, get_sasa_relative
+        '''
+        selection = selector.process(selection)
+        with _self.lockcm:
+            r = _cmd.get_atom_areas(_self._COb, selection, int(state) - 1)
+        if int(state) != 0:
+            r = r[0] if len(r) else []
+        return r
+
     def get_chains(selection="(all)",state=ALL_STATES,quiet=1,_self=cmd):
         '''
 DESCRIPTION
@@ -305,6 +305,33 @@ class Benchmark(Wizard):
             [12,200],
             ],width=3600,height=2700)
 
+    def ray_trace_bvh(self): # voxel map vs. BVH on a cartoon + surface scene
+        self.configure()
+        self.cmd.load("$PYMOL_DATA/demo/1tii.pdb")
+        self.cmd.zoom(complete=1)
+        self.cmd.hide()
+        self.cmd.show("cartoon")
+        self.cmd.show("surface","A/")
+        self.cmd.set("surface_quality",1)
+        self.cmd.set("ray_shadows",1)
+        self.cmd.turn('x',25)
+        self.cmd.turn('y',25)
+        # build time and memory are reported with "feedback enable, ray, blather"
+        for bvh in (0,1):
+            for ortho in (1,0):
+                self.cmd.set('ray_bvh',bvh)
+                self.cmd.set('orthoscopic',ortho)
+                cnt = 0
+                elapsed = 0.0
+                self.cmd.refresh()
+                start = time.time()
+                while elapsed<self.long_cpu:
+                    self.cmd.ray(1024,768,quiet=1)
+                    cnt = cnt + 1
+                    elapsed = time.time()-start
+                self.report('RAY_BVH%d_ORTHO%d_RAYS_PER_SEC'%(bvh,ortho),
+                            1024*768*cnt/elapsed)
+
     def ray_tracing(self,conditions,width=640,height=480):
         self.cmd.load("$PYMOL_DATA/demo/1tii.pdb")
         self.cmd.zoom(complete=1)
@@ -364,5 +391,6 @@ class Benchmark(Wizard):
             [ 2, 'Surface Calculation', 'cmd.get_wizard().delay_launch("surface_calculation")'],
             [ 2, 'Mesh Calculation', 'cmd.get_wizard().delay_launch("mesh_calculation")'],
             [ 2, 'Ray Tracing', 'cmd.get_wizard().delay_launch("ray_trace0")'],
+            [ 2, 'Ray Tracing (BVH)', 'cmd.get_wizard().delay_launch("ray_trace_bvh")'],
             [ 2, 'End Demonstration', 'cmd.set_wizard()' ]
             ]